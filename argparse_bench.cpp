@@ -0,0 +1,691 @@
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <limits>
+#include <iostream>
+#include <sstream>
+#include "argparse.hpp"
+
+using argparse::ArgValue;
+
+struct BenchArgs {
+    ArgValue<std::vector<std::string>> suites;
+    ArgValue<size_t> min_options;
+    ArgValue<size_t> max_options;
+    ArgValue<size_t> min_tokens;
+    ArgValue<size_t> max_tokens;
+    ArgValue<size_t> repeats;
+    ArgValue<float> time_limit;
+    ArgValue<std::string> format;
+    ArgValue<bool> traced;
+
+    ArgValue<bool> check;
+    ArgValue<std::string> baseline;
+    ArgValue<bool> update_baseline;
+    ArgValue<float> tolerance;
+    ArgValue<float> max_exponent;
+};
+
+//A single benchmark measurement
+struct BenchResult {
+    std::string suite;
+    std::string name;
+    size_t options = 0;
+    size_t tokens = 0;
+    size_t repeats = 0;
+    double seconds = 0.; //Fastest of the repeats
+    double ns_per_unit = 0.;
+    bool skipped = false;
+};
+
+/*
+ * A synthetic parser specification with a mix of option kinds:
+ *   --int<i> (with short options -a, -b ... for the first few), integer value
+ *   --multi<i> nargs '+' float values
+ *   --choice<i> string value validated against a set of choices
+ *   --flag<i> STORE_TRUE boolean flag
+ */
+class SyntheticSpec {
+    public:
+        enum class Kind {
+            INT,
+            MULTI,
+            CHOICE,
+            FLAG
+        };
+
+        SyntheticSpec(size_t num_options);
+
+        //Builds a command-line of (approximately) num_tokens tokens which uses a mix of
+        //long, short, no-space short and multi-value options
+        std::vector<std::string> command_line(size_t num_tokens) const;
+
+        argparse::ArgumentParser& parser() { return parser_; }
+        argparse::StringOutputSink& output() { return output_; }
+    private:
+        static Kind kind(size_t iopt) { return static_cast<Kind>(iopt % 4); }
+        static std::string short_option(size_t iopt);
+    private:
+        argparse::StringOutputSink output_; //Must be initialized before parser_
+        argparse::ArgumentParser parser_;
+        size_t num_options_;
+
+        std::deque<ArgValue<int>> ints_;
+        std::deque<ArgValue<std::vector<float>>> multis_;
+        std::deque<ArgValue<std::string>> choices_;
+        std::deque<ArgValue<bool>> flags_;
+};
+
+template<typename F>
+double time_fastest(size_t repeats, F&& func);
+
+std::vector<size_t> decades(size_t min_val, size_t max_val);
+
+std::vector<BenchResult> bench_parse(const BenchArgs& args);
+std::vector<BenchResult> bench_convert(const BenchArgs& args);
+std::vector<BenchResult> bench_choices(const BenchArgs& args);
+std::vector<BenchResult> bench_format(const BenchArgs& args);
+
+template<typename T>
+BenchResult bench_convert_type(std::string name, const std::vector<std::string>& values, size_t repeats);
+
+void write_results(std::ostream& os, const std::vector<BenchResult>& results, std::string format);
+
+int run_perf_check(const BenchArgs& args);
+double calibrate(size_t repeats);
+double fit_exponent(const std::vector<std::pair<double,double>>& samples);
+std::map<std::string,double> load_baseline(std::string filename);
+void write_baseline(std::string filename, const std::map<std::string,double>& baseline);
+
+int main(int argc, const char** argv) {
+    BenchArgs args;
+
+    auto parser = argparse::ArgumentParser(argv[0], "Benchmarks libargparse's parsing, conversion and formatting");
+    parser.epilog("Results are written to stdout as JSON (one object per line) or CSV.");
+
+    parser.add_argument(args.suites, "--suites")
+        .help("Benchmark suites to run")
+        .nargs('+')
+        .choices({"parse", "convert", "choices", "format"})
+        .default_value({"parse", "convert", "choices", "format"});
+    parser.add_argument(args.min_options, "--min_options")
+        .help("Smallest number of options in the synthetic specifications")
+        .default_value("10");
+    parser.add_argument(args.max_options, "--max_options")
+        .help("Largest number of options in the synthetic specifications")
+        .default_value("10000");
+    parser.add_argument(args.min_tokens, "--min_tokens")
+        .help("Smallest number of command-line tokens to parse")
+        .default_value("10");
+    parser.add_argument(args.max_tokens, "--max_tokens")
+        .help("Largest number of command-line tokens to parse")
+        .default_value("1000000");
+    parser.add_argument(args.repeats, "--repeats")
+        .help("Number of times each case is repeated (the fastest is reported)")
+        .default_value("3");
+    parser.add_argument(args.time_limit, "--time_limit")
+        .help("Once a case takes longer than this many seconds, larger cases in the same sweep are skipped")
+        .default_value("5.0");
+    parser.add_argument(args.format, "--format")
+        .help("Output format")
+        .default_value("json")
+        .choices({"json", "csv"});
+    parser.add_argument(args.traced, "--traced")
+        .help("Enable parse tracing in the parse suite (to measure its overhead)")
+        .action(argparse::Action::STORE_TRUE)
+        .default_value("false");
+
+    auto& check_grp = parser.add_argument_group("performance check options");
+    check_grp.add_argument(args.check, "--check")
+        .help("Instead of reporting results, run scaling sweeps and fail if the growth exponent"
+              " or the times (relative to a calibration workload) regress against --baseline")
+        .action(argparse::Action::STORE_TRUE)
+        .default_value("false");
+    check_grp.add_argument(args.baseline, "--baseline")
+        .help("Baseline file used by --check")
+        .default_value("perf_baseline.txt");
+    check_grp.add_argument(args.update_baseline, "--update_baseline")
+        .help("Write the measured times to --baseline instead of comparing against it")
+        .action(argparse::Action::STORE_TRUE)
+        .default_value("false");
+    check_grp.add_argument(args.tolerance, "--tolerance")
+        .help("Largest allowed ratio of measured to baseline time")
+        .default_value("3.0");
+    check_grp.add_argument(args.max_exponent, "--max_exponent")
+        .help("Largest allowed growth exponent (time ~ n^exponent) of each sweep")
+        .default_value("1.3");
+
+    parser.parse_args(argc, argv);
+
+    if (args.check) {
+        return run_perf_check(args);
+    }
+
+    std::vector<BenchResult> results;
+    for (const auto& suite : args.suites.value()) {
+        std::vector<BenchResult> suite_results;
+        if (suite == "parse") {
+            suite_results = bench_parse(args);
+        } else if (suite == "convert") {
+            suite_results = bench_convert(args);
+        } else if (suite == "choices") {
+            suite_results = bench_choices(args);
+        } else {
+            assert(suite == "format");
+            suite_results = bench_format(args);
+        }
+        results.insert(results.end(), suite_results.begin(), suite_results.end());
+    }
+
+    write_results(std::cout, results, args.format);
+
+    return 0;
+}
+
+/*
+ * SyntheticSpec
+ */
+SyntheticSpec::SyntheticSpec(size_t num_options)
+    : parser_("synthetic", "Synthetic benchmark specification", output_)
+    , num_options_(num_options) {
+
+    for (size_t iopt = 0; iopt < num_options_; ++iopt) {
+        std::string num = std::to_string(iopt);
+        switch (kind(iopt)) {
+            case Kind::INT: {
+                ints_.emplace_back();
+                std::string short_opt = short_option(iopt);
+                if (short_opt.empty()) {
+                    parser_.add_argument(ints_.back(), "--int" + num)
+                        .help("Integer option " + num)
+                        .default_value("0");
+                } else {
+                    parser_.add_argument(ints_.back(), "--int" + num, short_opt)
+                        .help("Integer option " + num)
+                        .default_value("0");
+                }
+                break;
+            }
+            case Kind::MULTI:
+                multis_.emplace_back();
+                parser_.add_argument(multis_.back(), "--multi" + num)
+                    .help("Multi-value float option " + num)
+                    .nargs('+')
+                    .default_value({"1.0"});
+                break;
+            case Kind::CHOICE:
+                choices_.emplace_back();
+                parser_.add_argument(choices_.back(), "--choice" + num)
+                    .help("Choice option " + num)
+                    .choices({"alpha", "beta", "gamma", "delta"})
+                    .default_value("alpha");
+                break;
+            case Kind::FLAG:
+                flags_.emplace_back();
+                parser_.add_argument(flags_.back(), "--flag" + num)
+                    .help("Boolean flag " + num)
+                    .action(argparse::Action::STORE_TRUE)
+                    .default_value("false");
+                break;
+            default:
+                assert(false);
+        }
+    }
+}
+
+std::string SyntheticSpec::short_option(size_t iopt) {
+    //Only integer options get short options (-a ... -z, -A ... -Z), skipping -h which is used by help
+    static const std::string letters = "abcdefgijklmnopqrstuvwxyzABCDEFGIJKLMNOPQRSTUVWXYZ";
+    size_t iint = iopt / 4;
+    if (iint < letters.size()) {
+        return std::string("-") + letters[iint];
+    }
+    return "";
+}
+
+std::vector<std::string> SyntheticSpec::command_line(size_t num_tokens) const {
+    //Determine which options are specified, and where the multi-value options are
+    std::vector<size_t> specified;
+    size_t base_tokens = 0;
+    size_t num_multi = 0;
+    for (size_t iopt = 0; iopt < num_options_; ++iopt) {
+        size_t cost = (kind(iopt) == Kind::FLAG) ? 1 : 2;
+        if (kind(iopt) == Kind::INT && !short_option(iopt).empty() && (iopt / 4) % 3 == 2) {
+            cost = 1; //No-space short option
+        }
+        if (base_tokens + cost > num_tokens) break;
+
+        base_tokens += cost;
+        specified.push_back(iopt);
+        if (kind(iopt) == Kind::MULTI) ++num_multi;
+    }
+
+    //Any remaining tokens become extra values for the multi-value options
+    size_t extra_values = num_tokens - base_tokens;
+
+    std::vector<std::string> cmd_line;
+    cmd_line.reserve(num_tokens);
+    size_t imulti = 0;
+    for (size_t iopt : specified) {
+        std::string num = std::to_string(iopt);
+        std::string short_opt = short_option(iopt);
+        switch (kind(iopt)) {
+            case Kind::INT:
+                if (short_opt.empty() || (iopt / 4) % 3 == 0) {
+                    cmd_line.push_back("--int" + num);
+                    cmd_line.push_back(std::to_string(iopt + 1));
+                } else if ((iopt / 4) % 3 == 1) {
+                    cmd_line.push_back(short_opt);
+                    cmd_line.push_back(std::to_string(iopt + 1));
+                } else {
+                    cmd_line.push_back(short_opt + std::to_string(iopt + 1));
+                }
+                break;
+            case Kind::MULTI: {
+                cmd_line.push_back("--multi" + num);
+                size_t num_values = 1 + extra_values / num_multi + (imulti < extra_values % num_multi ? 1 : 0);
+                for (size_t ival = 0; ival < num_values; ++ival) {
+                    cmd_line.push_back(std::to_string(ival % 100) + ".5");
+                }
+                ++imulti;
+                break;
+            }
+            case Kind::CHOICE:
+                cmd_line.push_back("--choice" + num);
+                cmd_line.push_back((iopt % 2) ? "delta" : "beta");
+                break;
+            case Kind::FLAG:
+                cmd_line.push_back("--flag" + num);
+                break;
+            default:
+                assert(false);
+        }
+    }
+    return cmd_line;
+}
+
+/*
+ * Benchmark suites
+ */
+std::vector<BenchResult> bench_parse(const BenchArgs& args) {
+    std::vector<BenchResult> results;
+    for (size_t num_options : decades(args.min_options, args.max_options)) {
+        SyntheticSpec spec(num_options);
+        spec.parser().enable_trace(args.traced);
+
+        bool skip = false;
+        for (size_t num_tokens : decades(args.min_tokens, args.max_tokens)) {
+            auto cmd_line = spec.command_line(num_tokens);
+
+            BenchResult result;
+            result.suite = "parse";
+            result.name = args.traced ? "mixed_traced" : "mixed";
+            result.options = num_options;
+            result.tokens = cmd_line.size();
+            result.repeats = args.repeats;
+            result.skipped = skip;
+
+            if (!skip) {
+                result.seconds = time_fastest(args.repeats, [&]() {
+                    spec.parser().parse_args_throw(cmd_line);
+                });
+                spec.parser().reset_destinations();
+                result.ns_per_unit = 1e9 * result.seconds / std::max<size_t>(result.tokens, 1);
+
+                skip = result.seconds > args.time_limit;
+            }
+            results.push_back(result);
+        }
+    }
+    return results;
+}
+
+std::vector<BenchResult> bench_convert(const BenchArgs& args) {
+    const size_t num_values = 100000;
+
+    std::vector<std::string> int_values;
+    std::vector<std::string> float_values;
+    std::vector<std::string> bool_values;
+    for (size_t i = 0; i < num_values; ++i) {
+        int_values.push_back(std::to_string(i * 7919 % 1000003));
+        float_values.push_back(std::to_string(i % 1000) + ".125");
+        bool_values.push_back((i % 2) ? "true" : "false");
+    }
+
+    std::vector<BenchResult> results;
+    results.push_back(bench_convert_type<int>("int", int_values, args.repeats));
+    results.push_back(bench_convert_type<unsigned>("unsigned", int_values, args.repeats));
+    results.push_back(bench_convert_type<size_t>("size_t", int_values, args.repeats));
+    results.push_back(bench_convert_type<float>("float", float_values, args.repeats));
+    results.push_back(bench_convert_type<double>("double", float_values, args.repeats));
+    results.push_back(bench_convert_type<bool>("bool", bool_values, args.repeats));
+    results.push_back(bench_convert_type<std::string>("string", int_values, args.repeats));
+    return results;
+}
+
+template<typename T>
+BenchResult bench_convert_type(std::string name, const std::vector<std::string>& values, size_t repeats) {
+    BenchResult result;
+    result.suite = "convert";
+    result.name = name;
+    result.tokens = values.size();
+    result.repeats = repeats;
+
+    size_t num_valid = 0;
+    result.seconds = time_fastest(repeats, [&]() {
+        for (const auto& value : values) {
+            auto converted_value = argparse::DefaultConverter<T>().from_str(value);
+            if (converted_value) ++num_valid;
+        }
+    });
+    if (num_valid != repeats * values.size()) {
+        throw argparse::ArgParseError("Unexpected conversion failure benchmarking " + name);
+    }
+    result.ns_per_unit = 1e9 * result.seconds / values.size();
+    return result;
+}
+
+std::vector<BenchResult> bench_choices(const BenchArgs& args) {
+    const size_t num_tokens = std::min<size_t>(10000, args.max_tokens);
+
+    std::vector<BenchResult> results;
+    for (size_t num_choices : {4, 64, 1024}) {
+        argparse::StringOutputSink output;
+        argparse::ArgumentParser parser("choices", "", output);
+
+        std::vector<std::string> choice_values;
+        for (size_t i = 0; i < num_choices; ++i) {
+            choice_values.push_back("choice" + std::to_string(i));
+        }
+
+        ArgValue<std::vector<std::string>> dest;
+        parser.add_argument(dest, "--names")
+            .nargs('+')
+            .choices(choice_values);
+
+        //Values are drawn from the back half of the choices, which is
+        //the expensive case for a linear search
+        std::vector<std::string> cmd_line = {"--names"};
+        for (size_t i = 0; i + 1 < num_tokens; ++i) {
+            cmd_line.push_back(choice_values[num_choices / 2 + i % (num_choices / 2)]);
+        }
+
+        BenchResult result;
+        result.suite = "choices";
+        result.name = "choices" + std::to_string(num_choices);
+        result.options = 1;
+        result.tokens = cmd_line.size();
+        result.repeats = args.repeats;
+        result.seconds = time_fastest(args.repeats, [&]() {
+            parser.parse_args_throw(cmd_line);
+            parser.reset_destinations();
+        });
+        result.ns_per_unit = 1e9 * result.seconds / result.tokens;
+        results.push_back(result);
+    }
+    return results;
+}
+
+std::vector<BenchResult> bench_format(const BenchArgs& args) {
+    std::vector<BenchResult> results;
+
+    bool skip = false;
+    for (size_t num_options : decades(args.min_options, args.max_options)) {
+        SyntheticSpec spec(num_options);
+
+        for (std::string name : {"usage", "help"}) {
+            BenchResult result;
+            result.suite = "format";
+            result.name = name;
+            result.options = num_options;
+            result.repeats = args.repeats;
+            result.skipped = skip;
+
+            if (!skip) {
+                result.seconds = time_fastest(args.repeats, [&]() {
+                    spec.output().clear();
+                    if (name == "usage") {
+                        spec.parser().print_usage();
+                    } else {
+                        spec.parser().print_help();
+                    }
+                });
+                result.ns_per_unit = 1e9 * result.seconds / num_options;
+            }
+            results.push_back(result);
+        }
+        skip = skip || results.back().seconds > args.time_limit;
+    }
+    return results;
+}
+
+/*
+ * Utilities
+ */
+template<typename F>
+double time_fastest(size_t repeats, F&& func) {
+    double fastest = std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < std::max<size_t>(repeats, 1); ++i) {
+        auto start = std::chrono::steady_clock::now();
+        func();
+        auto end = std::chrono::steady_clock::now();
+
+        fastest = std::min(fastest, std::chrono::duration<double>(end - start).count());
+    }
+    return fastest;
+}
+
+std::vector<size_t> decades(size_t min_val, size_t max_val) {
+    std::vector<size_t> vals;
+    for (size_t val = std::max<size_t>(min_val, 1); val <= max_val; val *= 10) {
+        vals.push_back(val);
+    }
+    return vals;
+}
+
+void write_results(std::ostream& os, const std::vector<BenchResult>& results, std::string format) {
+    if (format == "csv") {
+        os << "suite,name,options,tokens,repeats,seconds,ns_per_unit,skipped\n";
+    }
+    for (const auto& result : results) {
+        if (format == "csv") {
+            os << result.suite
+               << "," << result.name
+               << "," << result.options
+               << "," << result.tokens
+               << "," << result.repeats
+               << "," << result.seconds
+               << "," << result.ns_per_unit
+               << "," << (result.skipped ? "true" : "false")
+               << "\n";
+        } else {
+            assert(format == "json");
+            os << "{\"suite\": \"" << result.suite << "\""
+               << ", \"name\": \"" << result.name << "\""
+               << ", \"options\": " << result.options
+               << ", \"tokens\": " << result.tokens
+               << ", \"repeats\": " << result.repeats
+               << ", \"seconds\": " << result.seconds
+               << ", \"ns_per_unit\": " << result.ns_per_unit
+               << ", \"skipped\": " << (result.skipped ? "true" : "false")
+               << "}\n";
+        }
+    }
+}
+
+/*
+ * Performance regression check
+ */
+
+//A scaling sweep: times a (linear time) operation for several problem sizes
+struct PerfSweep {
+    std::string name;
+    std::vector<size_t> sizes;
+    std::function<double(size_t)> time_size; //Returns the time for the given size
+};
+
+int run_perf_check(const BenchArgs& args) {
+    std::vector<PerfSweep> sweeps;
+
+    //Fixed specification, growing command-line
+    sweeps.push_back({"parse_tokens", {1000, 4000, 16000, 64000}, [&](size_t num_tokens) {
+        SyntheticSpec spec(100);
+        auto cmd_line = spec.command_line(num_tokens);
+        return time_fastest(args.repeats, [&]() {
+            spec.parser().parse_args_throw(cmd_line);
+        });
+    }});
+
+    //Growing specification, with each option specified (about) once
+    sweeps.push_back({"parse_options", {250, 1000, 4000}, [&](size_t num_options) {
+        SyntheticSpec spec(num_options);
+        auto cmd_line = spec.command_line(2 * num_options);
+        return time_fastest(args.repeats, [&]() {
+            spec.parser().parse_args_throw(cmd_line);
+        });
+    }});
+
+    for (std::string name : {"usage", "help"}) {
+        sweeps.push_back({"format_" + name, {250, 1000, 4000}, [&args,name](size_t num_options) {
+            SyntheticSpec spec(num_options);
+            return time_fastest(args.repeats, [&]() {
+                spec.output().clear();
+                if (name == "usage") {
+                    spec.parser().print_usage();
+                } else {
+                    spec.parser().print_help();
+                }
+            });
+        }});
+    }
+
+    //Times are normalized to a calibration workload, so the baseline
+    //is (roughly) independent of the machine speed
+    double calibration = calibrate(args.repeats);
+
+    std::map<std::string,double> baseline;
+    if (!args.update_baseline) {
+        baseline = load_baseline(args.baseline);
+    }
+
+    int num_failed = 0;
+    std::map<std::string,double> measured;
+    for (const auto& sweep : sweeps) {
+        std::vector<std::pair<double,double>> samples;
+        for (size_t size : sweep.sizes) {
+            double seconds = sweep.time_size(size);
+            samples.emplace_back(size, seconds);
+
+            std::string key = sweep.name + "/" + std::to_string(size);
+            double normalized = seconds / calibration;
+            measured[key] = normalized;
+
+            if (args.update_baseline) continue;
+
+            auto iter = baseline.find(key);
+            if (iter == baseline.end()) {
+                std::cout << "[FAIL] " << key << ": missing from baseline " << args.baseline.value() << "\n";
+                ++num_failed;
+            } else {
+                double ratio = normalized / iter->second;
+                bool pass = ratio <= args.tolerance;
+                std::cout << (pass ? "[PASS] " : "[FAIL] ") << key << ": " << seconds << " sec, "
+                          << ratio << "x baseline (tolerance " << args.tolerance << "x)\n";
+                if (!pass) ++num_failed;
+            }
+        }
+
+        double exponent = fit_exponent(samples);
+        bool pass = exponent <= args.max_exponent;
+        std::cout << (pass ? "[PASS] " : "[FAIL] ") << sweep.name << ": growth exponent "
+                  << exponent << " (max " << args.max_exponent << ")\n";
+        if (!pass) ++num_failed;
+    }
+
+    if (args.update_baseline) {
+        write_baseline(args.baseline, measured);
+        std::cout << "Wrote baseline " << args.baseline.value() << "\n";
+    }
+
+    if (num_failed != 0) {
+        std::cout << "\n";
+        std::cout << "FAILED: " << num_failed << " performance check(s)!" << "\n";
+    }
+    return num_failed;
+}
+
+double calibrate(size_t repeats) {
+    //A fixed workload of string and ordered map operations, which are
+    //representative of what the parser does
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < 20000; ++i) {
+        keys.push_back("--calibration_key" + std::to_string(i * 7919 % 20000));
+    }
+
+    size_t found = 0;
+    double seconds = time_fastest(std::max<size_t>(repeats, 5), [&]() {
+        std::map<std::string,size_t> lookup;
+        for (size_t i = 0; i < keys.size(); ++i) {
+            lookup[keys[i]] = i;
+        }
+        for (const auto& key : keys) {
+            found += lookup.count(key);
+        }
+    });
+    assert(found > 0);
+    return seconds;
+}
+
+double fit_exponent(const std::vector<std::pair<double,double>>& samples) {
+    //Least-squares fit of log(time) = exponent * log(size) + c
+    double n = samples.size();
+    double sum_x = 0.;
+    double sum_y = 0.;
+    double sum_xx = 0.;
+    double sum_xy = 0.;
+    for (const auto& sample : samples) {
+        double x = std::log(sample.first);
+        double y = std::log(std::max(sample.second, 1e-9));
+        sum_x += x;
+        sum_y += y;
+        sum_xx += x * x;
+        sum_xy += x * y;
+    }
+    return (n * sum_xy - sum_x * sum_y) / (n * sum_xx - sum_x * sum_x);
+}
+
+std::map<std::string,double> load_baseline(std::string filename) {
+    std::ifstream is(filename);
+    if (!is) {
+        throw argparse::ArgParseError("Failed to open baseline file '" + filename + "'");
+    }
+
+    std::map<std::string,double> baseline;
+    std::string line;
+    while (std::getline(is, line)) {
+        if (line.empty() || line[0] == '#') continue;
+
+        std::stringstream ss(line);
+        std::string key;
+        double value;
+        if (!(ss >> key >> value)) {
+            throw argparse::ArgParseError("Invalid line in baseline file '" + filename + "': " + line);
+        }
+        baseline[key] = value;
+    }
+    return baseline;
+}
+
+void write_baseline(std::string filename, const std::map<std::string,double>& baseline) {
+    std::ofstream os(filename);
+    os << "# libargparse performance baseline, written by 'argparse_bench --check --update_baseline'\n";
+    os << "# <sweep>/<size> <time relative to the calibration workload>\n";
+    for (const auto& kv : baseline) {
+        os << kv.first << " " << kv.second << "\n";
+    }
+}
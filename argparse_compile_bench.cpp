@@ -0,0 +1,222 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include "argparse.hpp"
+
+using argparse::ArgValue;
+
+/*
+ * argparse_compile_bench measures how long translation units using each of the
+ * public headers take to compile, by repeatedly running the compiler on small
+ * representative sources.
+ *
+ * The compiler and flags default to those the benchmark was built with.
+ */
+
+#ifndef ARGPARSE_BENCH_CXX
+#   define ARGPARSE_BENCH_CXX "c++"
+#endif
+#ifndef ARGPARSE_BENCH_CXX_FLAGS
+#   define ARGPARSE_BENCH_CXX_FLAGS "--std=c++14"
+#endif
+#ifndef ARGPARSE_BENCH_INCLUDE_DIR
+#   define ARGPARSE_BENCH_INCLUDE_DIR "src"
+#endif
+
+struct CompileBenchArgs {
+    ArgValue<std::vector<std::string>> cases;
+    ArgValue<size_t> repeats;
+    ArgValue<size_t> tus;
+    ArgValue<std::string> compiler;
+    ArgValue<std::string> flags;
+    ArgValue<std::string> include_dir;
+    ArgValue<std::string> work_dir;
+};
+
+//A translation unit to compile
+struct CompileCase {
+    const char* name;
+    const char* description;
+    const char* source;
+};
+
+static const CompileCase COMPILE_CASES[] = {
+    {"fwd", "Refers to parsers and values (argparse_fwd.hpp)",
+        "#include \"argparse_fwd.hpp\"\n"
+        "void configure(argparse::ArgumentParser& parser);\n"
+        "int num_values(const argparse::ArgValue<int>* values);\n"
+    },
+    {"value", "Reads ArgValues (argparse_value.hpp)",
+        "#include <string>\n"
+        "#include \"argparse_value.hpp\"\n"
+        "struct Args {\n"
+        "    argparse::ArgValue<std::string> filename;\n"
+        "    argparse::ArgValue<int> verbosity;\n"
+        "    argparse::ArgValue<bool> timing;\n"
+        "};\n"
+        "int verbosity(const Args& args);\n"
+        "int verbosity(const Args& args) {\n"
+        "    if (args.timing.provenance() == argparse::Provenance::SPECIFIED) return 0;\n"
+        "    return args.filename.value().empty() ? 0 : args.verbosity.value();\n"
+        "}\n"
+    },
+    {"parser", "Defines and runs a parser (argparse.hpp)",
+        "#include <string>\n"
+        "#include <vector>\n"
+        "#include \"argparse.hpp\"\n"
+        "struct Args {\n"
+        "    argparse::ArgValue<std::string> filename;\n"
+        "    argparse::ArgValue<int> verbosity;\n"
+        "    argparse::ArgValue<bool> timing;\n"
+        "    argparse::ArgValue<double> utilization;\n"
+        "    argparse::ArgValue<std::vector<size_t>> seeds;\n"
+        "};\n"
+        "void parse(Args& args, int argc, const char** argv);\n"
+        "void parse(Args& args, int argc, const char** argv) {\n"
+        "    auto parser = argparse::ArgumentParser(argv[0], \"Compile benchmark\");\n"
+        "    parser.add_argument(args.filename, \"filename\");\n"
+        "    parser.add_argument(args.verbosity, \"--verbosity\", \"-v\").default_value(\"1\");\n"
+        "    parser.add_argument(args.timing, \"--timing\").action(argparse::Action::STORE_TRUE);\n"
+        "    parser.add_argument(args.utilization, \"--utilization\").default_value(\"1.0\");\n"
+        "    parser.add_argument(args.seeds, \"--seeds\").nargs('+');\n"
+        "    parser.parse_args(argc, argv);\n"
+        "}\n"
+    },
+    {"static", "Defines and runs a compile-time parser (argparse_static.hpp)",
+        "#include <string>\n"
+        "#include \"argparse_static.hpp\"\n"
+        "struct Spec {\n"
+        "    static constexpr const char* prog() { return \"compile_bench\"; }\n"
+        "    static constexpr auto arguments() {\n"
+        "        return argparse::static_arguments(\n"
+        "            argparse::StaticArgument(\"filename\"),\n"
+        "            argparse::StaticArgument(\"--verbosity\", \"-v\").default_value(\"1\"),\n"
+        "            argparse::StaticArgument(\"--timing\").action(argparse::Action::STORE_TRUE));\n"
+        "    }\n"
+        "};\n"
+        "void parse(int argc, const char** argv);\n"
+        "void parse(int argc, const char** argv) {\n"
+        "    argparse::ArgValue<std::string> filename;\n"
+        "    argparse::ArgValue<int> verbosity;\n"
+        "    argparse::ArgValue<bool> timing;\n"
+        "    argparse::StaticArgumentParser<Spec>(filename, verbosity, timing).parse_args(argc, argv);\n"
+        "}\n"
+    },
+};
+
+struct CompileResult {
+    double min_seconds = 0.;
+    double mean_seconds = 0.;
+    bool failed = false;
+};
+
+CompileResult bench_case(const CompileCase& compile_case, const CompileBenchArgs& args);
+
+int main(int argc, const char** argv) {
+    CompileBenchArgs args;
+
+    std::vector<std::string> case_names;
+    for (const auto& compile_case : COMPILE_CASES) {
+        case_names.push_back(compile_case.name);
+    }
+
+    auto parser = argparse::ArgumentParser(argv[0], "Measures the compile time of translation units using libargparse's headers");
+    parser.epilog("Each case is compiled --repeats times; the fastest and mean times are reported.");
+
+    parser.add_argument(args.cases, "--cases")
+        .help("Cases to compile")
+        .nargs('+')
+        .choices(case_names)
+        .default_value(case_names);
+    parser.add_argument(args.repeats, "--repeats")
+        .help("Number of times each case is compiled")
+        .default_value("5");
+    parser.add_argument(args.tus, "--tus")
+        .help("Number of including translation units to project the total build cost for")
+        .default_value("300");
+
+    auto& compiler_grp = parser.add_argument_group("compiler options");
+    compiler_grp.add_argument(args.compiler, "--compiler")
+        .help("C++ compiler")
+        .default_value(ARGPARSE_BENCH_CXX);
+    compiler_grp.add_argument(args.flags, "--flags")
+        .help("Compiler flags")
+        .default_value(ARGPARSE_BENCH_CXX_FLAGS);
+    compiler_grp.add_argument(args.include_dir, "--include_dir")
+        .help("Directory containing the libargparse headers")
+        .default_value(ARGPARSE_BENCH_INCLUDE_DIR);
+    compiler_grp.add_argument(args.work_dir, "--work_dir")
+        .help("Directory for the temporary sources and objects")
+        .default_value(".");
+
+    parser.parse_args(argc, argv);
+
+    std::printf("%-8s %10s %10s %14s  %s\n", "case", "min (ms)", "mean (ms)", "projected (s)", "description");
+
+    int status = 0;
+    for (const auto& compile_case : COMPILE_CASES) {
+        const auto& cases = args.cases.value();
+        if (std::find(cases.begin(), cases.end(), compile_case.name) == cases.end()) continue;
+
+        CompileResult result = bench_case(compile_case, args);
+        if (result.failed) {
+            std::printf("%-8s %10s %10s %14s  %s\n", compile_case.name, "failed", "-", "-", compile_case.description);
+            status = 1;
+        } else {
+            std::printf("%-8s %10.1f %10.1f %14.1f  %s\n", compile_case.name,
+                        1e3 * result.min_seconds, 1e3 * result.mean_seconds,
+                        result.min_seconds * args.tus, compile_case.description);
+        }
+        std::fflush(stdout);
+    }
+
+    return status;
+}
+
+CompileResult bench_case(const CompileCase& compile_case, const CompileBenchArgs& args) {
+    std::string source_file = args.work_dir.value() + "/compile_bench_" + compile_case.name + ".cpp";
+    std::string object_file = args.work_dir.value() + "/compile_bench_" + compile_case.name + ".o";
+
+    CompileResult result;
+    {
+        std::ofstream os(source_file);
+        os << compile_case.source;
+        if (!os) {
+            std::cerr << "Failed to write " << source_file << "\n";
+            result.failed = true;
+            return result;
+        }
+    }
+
+    std::string command = args.compiler.value() + " " + args.flags.value()
+                          + " -I" + args.include_dir.value()
+                          + " -c " + source_file + " -o " + object_file;
+
+    double total_seconds = 0.;
+    for (size_t i = 0; i < args.repeats; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        int ret = std::system(command.c_str());
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        if (ret != 0) {
+            std::cerr << "Failed to compile: " << command << "\n";
+            result.failed = true;
+            break;
+        }
+
+        total_seconds += elapsed.count();
+        if (i == 0 || elapsed.count() < result.min_seconds) {
+            result.min_seconds = elapsed.count();
+        }
+    }
+    if (args.repeats > 0) {
+        result.mean_seconds = total_seconds / args.repeats;
+    }
+
+    std::remove(source_file.c_str());
+    std::remove(object_file.c_str());
+    return result;
+}
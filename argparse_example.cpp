@@ -1,8 +1,28 @@
+#include <iostream>
+#include <sstream>
 #include "argparse.hpp"
+#include "argparse_enum_converter.hpp"
+#include "argparse_util.hpp"
 
 using argparse::ArgValue;
 using argparse::ConvertedValue;
 
+enum class Effort {
+    LOW,
+    MEDIUM,
+    HIGH
+};
+
+//Names the Effort values for argparse::EnumConverter
+namespace argparse {
+    template<>
+    struct EnumTraits<Effort> {
+        static constexpr auto names() {
+            return enum_names<Effort>({{"low", Effort::LOW}, {"medium", Effort::MEDIUM}, {"high", Effort::HIGH}});
+        }
+    };
+}
+
 struct Args {
     ArgValue<bool> do_foo;
     ArgValue<bool> enable_bar;
@@ -12,6 +32,7 @@ struct Args {
     ArgValue<float> utilization;
     ArgValue<std::vector<float>> zulus;
     ArgValue<std::vector<float>> alphas;
+    ArgValue<Effort> effort;
 };
 
 struct OnOff {
@@ -102,6 +123,10 @@ int main(int argc, const char** argv) {
         .nargs('*')
         .default_value({});
 
+    parser.add_argument<Effort,argparse::EnumConverter<Effort>>(args.effort, "--effort")
+        .help("Sets the effort level")
+        .default_value("medium");
+
     parser.parse_args(argc, argv);
 
     //Show the arguments
@@ -111,6 +136,7 @@ int main(int argc, const char** argv) {
     std::cout << "args.utilization: " << args.utilization << "\n";
     std::cout << "args.zulu: " << argparse::join(args.zulus.value(), ", ") << "\n";
     std::cout << "args.alphas: " << argparse::join(args.alphas.value(), ", ") << "\n";
+    std::cout << "args.effort: " << argparse::EnumConverter<Effort>().to_str(args.effort).value() << "\n";
     std::cout << "\n";
 
     //Do work
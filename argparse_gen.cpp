@@ -0,0 +1,619 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include "argparse.hpp"
+#include "argparse_util.hpp"
+
+using argparse::ArgValue;
+
+/*
+ * argparse_gen reads a declarative parser specification and writes a C++ header
+ * containing:
+ *   - a struct with an ArgValue for each argument,
+ *   - a parser class which sets them, driven by read-only tables (the arguments,
+ *     a sorted option table for binary search, and the positional order),
+ *   - the usage and help text, formatted ahead of time by the DefaultFormatter.
+ *
+ * The generated parser runs on the same engine as StaticArgumentParser (see
+ * argparse_static.hpp), but does no work at compile time, so it stays cheap to
+ * compile for specifications with hundreds of options.
+ *
+ * See the README for the specification format.
+ */
+
+struct GenArgs {
+    ArgValue<std::string> spec_file;
+    ArgValue<std::string> output;
+};
+
+class GenError : public std::runtime_error {
+    using std::runtime_error::runtime_error; //Constructors
+};
+
+struct GenArgument {
+    std::string long_opt;
+    std::string short_opt;
+    std::string type;
+    std::string converter;
+    std::string field;
+    std::string help;
+    std::string default_value;
+    bool default_set = false;
+    std::string metavar;
+    std::vector<std::string> choices;
+    argparse::Action action = argparse::Action::STORE;
+    bool required = false;
+    std::string group;
+    std::string location; //Where it was specified (file:line)
+
+    bool positional() const { return long_opt[0] != '-'; }
+};
+
+struct GenSpec {
+    std::string prog;
+    std::string description;
+    std::string epilog;
+    std::string name_space;
+    std::string struct_name = "Args";
+    std::string parser_name;
+    std::vector<std::string> includes;
+    std::vector<GenArgument> arguments;
+};
+
+//The formatted text and look-up tables of a specification
+struct GenTables {
+    std::string usage;
+    std::string help;
+    std::vector<std::vector<std::string>> choices; //Of each argument (including those implied by its converter)
+    std::vector<size_t> positionals;
+    std::vector<std::pair<std::string,size_t>> options; //Sorted
+};
+
+constexpr const char* DEFAULT_GROUP = "arguments";
+
+std::string trim(const std::string& str);
+std::vector<std::string> split_whitespace(const std::string& str);
+bool is_identifier(const std::string& str);
+std::string default_field_name(const std::string& long_opt);
+
+GenSpec load_spec(const std::string& filename);
+void set_spec_value(GenSpec& spec, const std::string& key, const std::string& value);
+void set_argument_value(GenArgument& arg, const std::string& key, const std::string& value);
+void check_spec(GenSpec& spec);
+GenTables build_tables(const GenSpec& spec);
+void write_header(std::ostream& os, const GenSpec& spec, const GenTables& tables, const std::string& spec_file, const std::string& guard);
+void write_string_literal(std::ostream& os, const std::string& str, const std::string& indent);
+std::string header_guard(const std::string& output);
+
+int main(int argc, const char** argv) {
+    GenArgs args;
+
+    auto parser = argparse::ArgumentParser(argv[0], "Generates a C++ argument parser header from a declarative specification");
+    parser.add_argument(args.spec_file, "spec_file")
+        .help("Parser specification file");
+    parser.add_argument(args.output, "--output", "-o")
+        .help("Header file to write")
+        .required(true);
+
+    parser.parse_args(argc, argv);
+
+    try {
+        GenSpec spec = load_spec(args.spec_file);
+        check_spec(spec);
+        GenTables tables = build_tables(spec);
+
+        std::ofstream os(args.output.value());
+        if (!os) {
+            throw GenError("Failed to open '" + args.output.value() + "' for writing");
+        }
+        write_header(os, spec, tables, argparse::basename(args.spec_file), header_guard(args.output));
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "Error: %s\n", e.what());
+        std::remove(args.output.value().c_str());
+        return 1;
+    }
+    return 0;
+}
+
+GenSpec load_spec(const std::string& filename) {
+    std::ifstream is(filename);
+    if (!is) {
+        throw GenError("Failed to open specification '" + filename + "'");
+    }
+
+    GenSpec spec;
+    std::string group = DEFAULT_GROUP;
+    GenArgument* arg = nullptr;
+
+    std::string line;
+    for (size_t line_num = 1; std::getline(is, line); ++line_num) {
+        std::string location = filename + ":" + std::to_string(line_num);
+        line = trim(line);
+
+        if (line.empty() || line[0] == '#') continue;
+
+        try {
+            auto words = split_whitespace(line);
+            auto eq_pos = line.find('=');
+
+            if (words[0] == "argument" && eq_pos == std::string::npos) {
+                //Start of a new argument
+                if (words.size() < 2 || words.size() > 3) {
+                    throw GenError("Expected 'argument <name> [<short option>]'");
+                }
+                spec.arguments.emplace_back();
+                arg = &spec.arguments.back();
+                arg->long_opt = words[1];
+                if (words.size() == 3) arg->short_opt = words[2];
+                arg->group = group;
+                arg->location = location;
+
+            } else if (words[0] == "group" && eq_pos == std::string::npos) {
+                //Subsequent arguments are in the named group
+                group = trim(line.substr(words[0].size()));
+                if (group.empty()) {
+                    throw GenError("Expected 'group <name>'");
+                }
+                arg = nullptr;
+
+            } else if (eq_pos != std::string::npos) {
+                std::string key = trim(line.substr(0, eq_pos));
+                std::string value = trim(line.substr(eq_pos + 1));
+                if (arg) {
+                    set_argument_value(*arg, key, value);
+                } else {
+                    set_spec_value(spec, key, value);
+                }
+
+            } else {
+                throw GenError("Expected 'key = value', 'argument <name>' or 'group <name>'");
+            }
+        } catch (const std::exception& e) {
+            throw GenError(location + ": " + e.what());
+        }
+    }
+    return spec;
+}
+
+void set_spec_value(GenSpec& spec, const std::string& key, const std::string& value) {
+    if (key == "prog") {
+        spec.prog = value;
+    } else if (key == "description") {
+        spec.description = value;
+    } else if (key == "epilog") {
+        spec.epilog = value;
+    } else if (key == "namespace") {
+        spec.name_space = value;
+    } else if (key == "struct") {
+        spec.struct_name = value;
+    } else if (key == "parser") {
+        spec.parser_name = value;
+    } else if (key == "include") {
+        spec.includes.push_back(value);
+    } else {
+        throw GenError("Unrecognized specification key '" + key + "' (expected one of: prog, description, epilog, namespace, struct, parser, include)");
+    }
+}
+
+void set_argument_value(GenArgument& arg, const std::string& key, const std::string& value) {
+    if (key == "type") {
+        arg.type = value;
+    } else if (key == "converter") {
+        arg.converter = value;
+    } else if (key == "field") {
+        arg.field = value;
+    } else if (key == "help") {
+        arg.help = value;
+    } else if (key == "default") {
+        arg.default_value = value;
+        arg.default_set = true;
+    } else if (key == "metavar") {
+        arg.metavar = value;
+    } else if (key == "choices") {
+        arg.choices = split_whitespace(value);
+    } else if (key == "required") {
+        if (value != "true" && value != "false") {
+            throw GenError("Expected 'true' or 'false' for required (found '" + value + "')");
+        }
+        arg.required = (value == "true");
+    } else if (key == "action") {
+        if (value == "store") {
+            arg.action = argparse::Action::STORE;
+        } else if (value == "store_true") {
+            arg.action = argparse::Action::STORE_TRUE;
+        } else if (value == "store_false") {
+            arg.action = argparse::Action::STORE_FALSE;
+        } else {
+            throw GenError("Unrecognized action '" + value + "' (expected one of: store, store_true, store_false)");
+        }
+    } else {
+        throw GenError("Unrecognized argument key '" + key + "' (expected one of: type, converter, field, help, default, metavar, choices, required, action)");
+    }
+}
+
+void check_spec(GenSpec& spec) {
+    if (spec.prog.empty()) {
+        throw GenError("The specification must set 'prog'");
+    }
+    if (spec.arguments.empty()) {
+        throw GenError("The specification must contain at least one argument");
+    }
+    if (spec.parser_name.empty()) {
+        spec.parser_name = spec.struct_name + "Parser";
+    }
+    for (auto name : {spec.struct_name, spec.parser_name}) {
+        if (!is_identifier(name)) {
+            throw GenError("'" + name + "' is not a valid C++ identifier");
+        }
+    }
+
+    std::map<std::string,std::string> option_locations = {{"--help", "the help option"}, {"-h", "the help option"}};
+    std::map<std::string,std::string> field_locations;
+    for (auto& arg : spec.arguments) {
+        try {
+            bool flag = (arg.action != argparse::Action::STORE);
+            if (arg.type.empty()) {
+                arg.type = flag ? "bool" : "std::string";
+            } else if (flag && arg.type != "bool") {
+                throw GenError("STORE_TRUE/STORE_FALSE arguments must have type bool");
+            }
+            if (arg.positional() && flag) {
+                throw GenError("Positional arguments must have the store action");
+            }
+
+            if (arg.field.empty()) {
+                arg.field = default_field_name(arg.long_opt);
+            }
+            if (!is_identifier(arg.field)) {
+                throw GenError("Field name '" + arg.field + "' is not a valid C++ identifier (specify one with 'field = <name>')");
+            }
+            auto field_result = field_locations.insert(std::make_pair(arg.field, arg.location));
+            if (!field_result.second) {
+                throw GenError("Field name '" + arg.field + "' is also used by the argument at " + field_result.first->second);
+            }
+
+            if (!arg.positional()) {
+                for (auto opt : {arg.long_opt, arg.short_opt}) {
+                    if (opt.empty()) continue;
+                    auto opt_result = option_locations.insert(std::make_pair(opt, arg.location));
+                    if (!opt_result.second) {
+                        throw GenError("Option string '" + opt + "' is also used by " + opt_result.first->second);
+                    }
+                }
+            }
+        } catch (const GenError& e) {
+            throw GenError(arg.location + ": " + e.what());
+        }
+    }
+}
+
+GenTables build_tables(const GenSpec& spec) {
+    GenTables tables;
+
+    //Register the arguments with a regular parser, which checks them and formats the usage and help
+    argparse::StringOutputSink output;
+    auto parser = argparse::ArgumentParser(spec.prog, spec.description, output);
+    parser.epilog(spec.epilog);
+
+    std::deque<ArgValue<std::string>> string_values;
+    std::deque<ArgValue<bool>> bool_values;
+
+    std::vector<std::string> groups; //In order of first appearance
+    for (const auto& arg : spec.arguments) {
+        if (std::find(groups.begin(), groups.end(), arg.group) == groups.end()) {
+            groups.push_back(arg.group);
+        }
+    }
+
+    tables.choices.resize(spec.arguments.size());
+    for (const auto& group : groups) {
+        argparse::ArgumentGroup* parser_group = nullptr;
+        if (group != DEFAULT_GROUP) {
+            parser_group = &parser.add_argument_group(group);
+        }
+
+        for (size_t iarg = 0; iarg < spec.arguments.size(); ++iarg) {
+            const auto& arg = spec.arguments[iarg];
+            if (arg.group != group) continue;
+
+            try {
+                //Only the types' default choices affect formatting, so other types stand in as strings
+                argparse::Argument* parser_arg = nullptr;
+                if (arg.type == "bool") {
+                    bool_values.emplace_back();
+                    parser_arg = parser_group ? &parser_group->add_argument(bool_values.back(), arg.long_opt, arg.short_opt)
+                                              : &parser.add_argument(bool_values.back(), arg.long_opt, arg.short_opt);
+                } else {
+                    string_values.emplace_back();
+                    parser_arg = parser_group ? &parser_group->add_argument(string_values.back(), arg.long_opt, arg.short_opt)
+                                              : &parser.add_argument(string_values.back(), arg.long_opt, arg.short_opt);
+                }
+
+                parser_arg->action(arg.action);
+                parser_arg->help(arg.help);
+                parser_arg->required(arg.required);
+                if (arg.default_set) parser_arg->default_value(arg.default_value);
+                if (!arg.metavar.empty()) parser_arg->metavar(arg.metavar);
+                if (!arg.choices.empty()) parser_arg->choices(arg.choices);
+
+                if (arg.action == argparse::Action::STORE) {
+                    //Flags take no value, so have no choices to check
+                    tables.choices[iarg] = parser_arg->choices();
+                }
+
+                if (arg.positional()) {
+                    tables.positionals.push_back(iarg);
+                }
+            } catch (const argparse::ArgParseError& e) {
+                throw GenError(arg.location + ": " + e.what());
+            }
+        }
+    }
+
+    parser.freeze();
+    parser.print_usage();
+    tables.usage = output.str();
+
+    output.clear();
+    parser.print_help();
+    tables.help = output.str();
+
+    //Option strings, sorted for binary search
+    for (size_t iarg = 0; iarg < spec.arguments.size(); ++iarg) {
+        const auto& arg = spec.arguments[iarg];
+        if (arg.positional()) continue;
+
+        tables.options.emplace_back(arg.long_opt, iarg);
+        if (!arg.short_opt.empty()) {
+            tables.options.emplace_back(arg.short_opt, iarg);
+        }
+    }
+    tables.options.emplace_back("--help", spec.arguments.size());
+    tables.options.emplace_back("-h", spec.arguments.size());
+    std::sort(tables.options.begin(), tables.options.end());
+
+    return tables;
+}
+
+void write_header(std::ostream& os, const GenSpec& spec, const GenTables& tables, const std::string& spec_file, const std::string& guard) {
+    const size_t num_args = spec.arguments.size();
+    const std::string indent = spec.name_space.empty() ? "" : "    ";
+
+    os << "//Generated by argparse_gen from " << spec_file << ", do not edit\n";
+    os << "#ifndef " << guard << "\n";
+    os << "#define " << guard << "\n";
+    os << "#include <string>\n";
+    os << "#include <vector>\n";
+    os << "#include \"argparse_static.hpp\"\n";
+    for (const auto& include : spec.includes) {
+        os << "#include " << include << "\n";
+    }
+    os << "\n";
+
+    if (!spec.name_space.empty()) {
+        os << "namespace " << spec.name_space << " {\n\n";
+    }
+
+    //Config struct
+    os << indent << "struct " << spec.struct_name << " {\n";
+    for (const auto& arg : spec.arguments) {
+        os << indent << "    argparse::ArgValue<" << arg.type << "> " << arg.field << ";\n";
+    }
+    os << indent << "};\n\n";
+
+    //Parser
+    const std::string& parser = spec.parser_name;
+    os << indent << "class " << parser << " {\n";
+    os << indent << "    public:\n";
+    os << indent << "        static constexpr size_t NUM_ARGUMENTS = " << num_args << ";\n";
+    os << indent << "    public:\n";
+    os << indent << "        explicit " << parser << "(" << spec.struct_name << "& args);\n\n";
+    os << indent << "        //Like parse_args_throw(), but catches exceptions and exits the program\n";
+    os << indent << "        void parse_args(int argc, const char* const* argv, int error_exit_code=1, int help_exit_code=0) {\n";
+    os << indent << "            argparse::detail::parse_static_args_or_exit(tables(), dests_, argc, argv, error_exit_code, help_exit_code);\n";
+    os << indent << "        }\n\n";
+    os << indent << "        //Parses the specified command-line arguments and sets the appropriate argument values\n";
+    os << indent << "        void parse_args_throw(int argc, const char* const* argv) {\n";
+    os << indent << "            argparse::detail::parse_static_args(tables(), dests_, argv + 1, argc > 0 ? argc - 1 : 0);\n";
+    os << indent << "        }\n";
+    os << indent << "        void parse_args_throw(const std::vector<std::string>& args) {\n";
+    os << indent << "            argparse::detail::parse_static_args(tables(), dests_, args);\n";
+    os << indent << "        }\n\n";
+    os << indent << "        //Reset the target values to their initial state\n";
+    os << indent << "        void reset_destinations() { argparse::detail::reset_static_destinations(dests_, NUM_ARGUMENTS); }\n\n";
+    os << indent << "        void print_usage(argparse::OutputSink& sink=argparse::stdout_sink()) const { sink.write(usage()); }\n";
+    os << indent << "        void print_help(argparse::OutputSink& sink=argparse::stdout_sink()) const { sink.write(help()); }\n";
+    os << "#ifndef ARGPARSE_NO_IOSTREAM\n";
+    os << indent << "        void print_usage(std::ostream& os) const { os << usage(); }\n";
+    os << indent << "        void print_help(std::ostream& os) const { os << help(); }\n";
+    os << "#endif\n\n";
+    os << indent << "        static const char* usage() { return tables().usage; }\n";
+    os << indent << "        static const char* help() { return tables().help; }\n";
+    os << indent << "    private:\n";
+    os << indent << "        static const argparse::detail::StaticParseTables& tables();\n";
+    os << indent << "    private:\n";
+    os << indent << "        argparse::detail::StaticDestination dests_[NUM_ARGUMENTS];\n";
+    os << indent << "};\n\n";
+
+    //Constructor
+    os << indent << "inline " << parser << "::" << parser << "(" << spec.struct_name << "& args) {\n";
+    for (size_t iarg = 0; iarg < num_args; ++iarg) {
+        const auto& arg = spec.arguments[iarg];
+        std::string converter = arg.converter.empty() ? "argparse::DefaultConverter<" + arg.type + ">" : arg.converter;
+        os << indent << "    dests_[" << iarg << "] = argparse::detail::make_static_destination<" << arg.type << ", " << converter << ">(args." << arg.field << ");\n";
+    }
+    os << indent << "}\n\n";
+
+    //Tables
+    os << indent << "inline const argparse::detail::StaticParseTables& " << parser << "::tables() {\n";
+    for (size_t iarg = 0; iarg < num_args; ++iarg) {
+        if (tables.choices[iarg].empty()) continue;
+        os << indent << "    static constexpr const char* choices_" << iarg << "[] = {";
+        for (size_t ichoice = 0; ichoice < tables.choices[iarg].size(); ++ichoice) {
+            if (ichoice != 0) os << ", ";
+            write_string_literal(os, tables.choices[iarg][ichoice], "");
+        }
+        os << "};\n";
+    }
+    os << "\n";
+
+    os << indent << "    static constexpr argparse::StaticArgument arguments[] = {\n";
+    for (size_t iarg = 0; iarg < num_args; ++iarg) {
+        const auto& arg = spec.arguments[iarg];
+        os << indent << "        argparse::StaticArgument(";
+        write_string_literal(os, arg.long_opt, "");
+        if (!arg.short_opt.empty()) {
+            os << ", ";
+            write_string_literal(os, arg.short_opt, "");
+        }
+        os << ")";
+        if (arg.action == argparse::Action::STORE_TRUE) os << ".action(argparse::Action::STORE_TRUE)";
+        if (arg.action == argparse::Action::STORE_FALSE) os << ".action(argparse::Action::STORE_FALSE)";
+        if (arg.required) os << ".required(true)";
+        if (arg.default_set) {
+            os << ".default_value(";
+            write_string_literal(os, arg.default_value, "");
+            os << ")";
+        }
+        if (!tables.choices[iarg].empty()) os << ".choices(choices_" << iarg << ")";
+        if (arg.group != DEFAULT_GROUP) {
+            os << ".group_name(";
+            write_string_literal(os, arg.group, "");
+            os << ")";
+        }
+        os << ",\n";
+    }
+    os << indent << "    };\n\n";
+
+    os << indent << "    static constexpr const char* names[] = {\n";
+    for (const auto& arg : spec.arguments) {
+        os << indent << "        ";
+        write_string_literal(os, arg.short_opt.empty() ? arg.long_opt : arg.long_opt + "/" + arg.short_opt, "");
+        os << ",\n";
+    }
+    os << indent << "    };\n\n";
+
+    if (!tables.positionals.empty()) {
+        os << indent << "    static constexpr size_t positionals[] = {";
+        for (size_t ipos = 0; ipos < tables.positionals.size(); ++ipos) {
+            if (ipos != 0) os << ", ";
+            os << tables.positionals[ipos];
+        }
+        os << "};\n\n";
+    }
+
+    os << indent << "    //Sorted by option string\n";
+    os << indent << "    static constexpr argparse::detail::StaticOptionEntry options[] = {\n";
+    for (const auto& option : tables.options) {
+        os << indent << "        {";
+        write_string_literal(os, option.first, "");
+        os << ", " << option.second << "},\n";
+    }
+    os << indent << "    };\n\n";
+
+    os << indent << "    struct Options {\n";
+    os << indent << "        static size_t find(const char* str, size_t size) {\n";
+    os << indent << "            return argparse::detail::find_sorted_option(options, " << tables.options.size() << ", str, size);\n";
+    os << indent << "        }\n";
+    os << indent << "    };\n\n";
+
+    os << indent << "    static constexpr const char* usage =\n";
+    write_string_literal(os, tables.usage, indent + "        ");
+    os << ";\n\n";
+
+    os << indent << "    static constexpr const char* help =\n";
+    write_string_literal(os, tables.help, indent + "        ");
+    os << ";\n\n";
+
+    os << indent << "    static constexpr argparse::detail::StaticParseTables tables = {\n";
+    os << indent << "        arguments, names, " << num_args << ",\n";
+    if (tables.positionals.empty()) {
+        os << indent << "        nullptr, 0,\n";
+    } else {
+        os << indent << "        positionals, " << tables.positionals.size() << ",\n";
+    }
+    os << indent << "        &Options::find, usage, help\n";
+    os << indent << "    };\n";
+    os << indent << "    return tables;\n";
+    os << indent << "}\n";
+
+    if (!spec.name_space.empty()) {
+        os << "\n} //namespace\n";
+    }
+    os << "#endif\n";
+}
+
+//Writes str as a C++ string literal. If indent is non-empty each line of str is
+//written as a separate (concatenated) literal on its own line with that indent
+void write_string_literal(std::ostream& os, const std::string& str, const std::string& indent) {
+    bool multi_line = !indent.empty();
+    if (multi_line) os << indent;
+    os << '"';
+    for (size_t i = 0; i < str.size(); ++i) {
+        char c = str[i];
+        if (c == '"' || c == '\\') {
+            os << '\\' << c;
+        } else if (c == '\n') {
+            os << "\\n";
+            if (multi_line && i + 1 < str.size()) {
+                os << "\"\n" << indent << '"';
+            }
+        } else if (c == '\t') {
+            os << "\\t";
+        } else if (!std::isprint(static_cast<unsigned char>(c))) {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\%03o", static_cast<unsigned char>(c));
+            os << buf;
+        } else {
+            os << c;
+        }
+    }
+    os << '"';
+}
+
+std::string header_guard(const std::string& output) {
+    std::string guard;
+    for (char c : argparse::basename(output)) {
+        guard += std::isalnum(static_cast<unsigned char>(c)) ? static_cast<char>(std::toupper(static_cast<unsigned char>(c))) : '_';
+    }
+    if (guard.empty() || std::isdigit(static_cast<unsigned char>(guard[0]))) {
+        guard = "ARGPARSE_GEN_" + guard;
+    }
+    return guard;
+}
+
+std::string trim(const std::string& str) {
+    size_t start = str.find_first_not_of(" \t\r");
+    if (start == std::string::npos) return "";
+    size_t end = str.find_last_not_of(" \t\r");
+    return str.substr(start, end - start + 1);
+}
+
+std::vector<std::string> split_whitespace(const std::string& str) {
+    std::vector<std::string> words;
+    std::stringstream ss(str);
+    std::string word;
+    while (ss >> word) {
+        words.push_back(word);
+    }
+    return words;
+}
+
+bool is_identifier(const std::string& str) {
+    if (str.empty() || std::isdigit(static_cast<unsigned char>(str[0]))) return false;
+    for (char c : str) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_') return false;
+    }
+    return true;
+}
+
+std::string default_field_name(const std::string& long_opt) {
+    auto name = argparse::split_leading_dashes(long_opt)[1];
+    std::replace(name.begin(), name.end(), '-', '_');
+    return name;
+}
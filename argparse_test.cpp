@@ -1,5 +1,16 @@
 #include "argparse.hpp"
+#include "argparse_enum_converter.hpp"
+#include "argparse_static.hpp"
 #include "argparse_util.hpp"
+#include "argparse_test_args.hpp" //Generated by argparse_gen
+
+#include <clocale>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <sstream>
 
 using argparse::ArgValue;
 using argparse::ConvertedValue;
@@ -94,6 +105,52 @@ struct Args {
 bool expect_pass(argparse::ArgumentParser& parser, std::vector<std::string> cmd_line);
 bool expect_fail(argparse::ArgumentParser& parser, std::vector<std::string> cmd_line);
 
+//Reports the results of a test's checks, counting those which fail in num_failed
+class CheckReporter {
+    public:
+        CheckReporter(std::string test_name, int& num_failed);
+
+        //Reports whether the check described by what passed
+        void operator()(const std::string& what, bool pass) const;
+    private:
+        std::string test_name_;
+        int& num_failed_;
+};
+
+//Maximum allowed allocations in each phase
+struct AllocBudget {
+    size_t registration;
+    size_t freeze;
+    size_t defaults;
+    size_t parse;
+    size_t format;
+};
+int test_allocation_budgets();
+int test_parse_stats();
+int test_parse_trace();
+int test_memory_usage();
+int test_static_parser();
+int test_generated_parser();
+int test_output_sinks();
+int test_move_semantics();
+int test_reparse_allocations();
+int test_lazy_conversion();
+int test_inferred_values();
+int test_argument_constraints();
+int test_accumulating_actions();
+int test_option_modules();
+int test_parent_parsers();
+int test_subcommands();
+int test_default_providers();
+int test_choice_providers();
+int test_flag_sets();
+int test_enum_converter();
+int test_view_converters();
+int test_stream_format_state();
+int test_numeric_locale();
+int check_allocation_budget(std::string spec_name, std::function<void(argparse::ArgumentParser&)> register_args,
+                            std::vector<std::string> cmd_line, AllocBudget budget);
+
 struct OnOff {
     ConvertedValue<bool> from_str(std::string str) {
         ConvertedValue<bool> converted_value;
@@ -116,6 +173,98 @@ struct OnOff {
     }
 };
 
+//A value which counts how many times values of its type are copied
+struct CopyCounted {
+    CopyCounted() = default;
+    explicit CopyCounted(std::string str) : value(std::move(str)) {}
+
+    CopyCounted(const CopyCounted& other) : value(other.value) { ++copies; }
+    CopyCounted(CopyCounted&& other) noexcept = default;
+    CopyCounted& operator=(const CopyCounted& other) { value = other.value; ++copies; return *this; }
+    CopyCounted& operator=(CopyCounted&& other) noexcept = default;
+
+    std::string value;
+    static size_t copies;
+};
+size_t CopyCounted::copies = 0;
+
+std::ostream& operator<<(std::ostream& os, const CopyCounted& val);
+std::ostream& operator<<(std::ostream& os, const CopyCounted& val) {
+    return os << val.value;
+}
+
+struct CopyCountedConverter {
+    ConvertedValue<CopyCounted> from_str(std::string str) {
+        ConvertedValue<CopyCounted> converted_value;
+        converted_value.set_value(CopyCounted(std::move(str)));
+        return converted_value;
+    }
+
+    ConvertedValue<std::string> to_str(const CopyCounted& val) {
+        ConvertedValue<std::string> converted_value;
+        converted_value.set_value(val.value);
+        return converted_value;
+    }
+
+    std::vector<std::string> default_choices() { return {}; }
+};
+
+//Converts ints, counting the conversions performed
+struct CountingIntConverter {
+    ConvertedValue<int> from_str(std::string str) {
+        ++conversions;
+        return argparse::DefaultConverter<int>().from_str(str);
+    }
+
+    ConvertedValue<std::string> to_str(int val) {
+        return argparse::DefaultConverter<int>().to_str(val);
+    }
+
+    std::vector<std::string> default_choices() { return {}; }
+
+    static size_t conversions;
+};
+size_t CountingIntConverter::conversions = 0;
+
+constexpr const char* STATIC_MODE_CHOICES[] = {"fast", "slow"};
+constexpr const char* STATIC_ON_OFF_CHOICES[] = {"on", "off"};
+
+struct StaticTestSpec {
+    static constexpr const char* prog() { return "static_test"; }
+    static constexpr const char* description() { return "Static parser test"; }
+
+    static constexpr auto arguments() {
+        return argparse::static_arguments(
+            argparse::StaticArgument("filename")
+                .help("The input file"),
+            argparse::StaticArgument("--verbosity", "-v")
+                .default_value("1")
+                .help("Sets the verbosity"),
+            argparse::StaticArgument("--mode")
+                .choices(STATIC_MODE_CHOICES)
+                .default_value("fast"),
+            argparse::StaticArgument("--timing")
+                .choices(STATIC_ON_OFF_CHOICES)
+                .default_value("on")
+                .help("Controls whether timing analysis is performed, which is a fairly long help string that needs to be wrapped"),
+            argparse::StaticArgument("--foo")
+                .action(argparse::Action::STORE_TRUE)
+                .default_value("false"),
+            argparse::StaticArgument("--seed")
+                .required(true)
+                .metavar("N"));
+    }
+};
+typedef argparse::StaticArgumentParser<StaticTestSpec> StaticTestParser;
+
+//The look-up tables and metavars are compile-time constants
+static_assert(StaticTestParser::find_option("-v") == 1, "Short option look-up");
+static_assert(StaticTestParser::find_option("--seed") == 5, "Long option look-up");
+static_assert(StaticTestParser::find_option("--help") == StaticTestParser::NUM_ARGUMENTS, "Help option look-up");
+static_assert(StaticTestParser::find_option("--bar") == size_t(-1), "Unknown option look-up");
+static_assert(argparse::detail::static_streq(StaticTestParser::metavar(1), "VERBOSITY"), "Inferred metavar");
+static_assert(argparse::detail::static_streq(StaticTestParser::metavar(2), "{fast, slow}"), "Choices metavar");
+
 int main(
         int 
 #ifndef TEST
@@ -540,6 +689,30 @@ int main(
         }
     }
 
+    num_failed += test_allocation_budgets();
+    num_failed += test_parse_stats();
+    num_failed += test_parse_trace();
+    num_failed += test_memory_usage();
+    num_failed += test_static_parser();
+    num_failed += test_generated_parser();
+    num_failed += test_output_sinks();
+    num_failed += test_move_semantics();
+    num_failed += test_reparse_allocations();
+    num_failed += test_lazy_conversion();
+    num_failed += test_inferred_values();
+    num_failed += test_argument_constraints();
+    num_failed += test_accumulating_actions();
+    num_failed += test_option_modules();
+    num_failed += test_parent_parsers();
+    num_failed += test_subcommands();
+    num_failed += test_default_providers();
+    num_failed += test_choice_providers();
+    num_failed += test_flag_sets();
+    num_failed += test_enum_converter();
+    num_failed += test_view_converters();
+    num_failed += test_stream_format_state();
+    num_failed += test_numeric_locale();
+
     if (num_failed != 0) {
         std::cout << "\n";
         std::cout << "FAILED: " << num_failed << " test(s)!" << "\n";
@@ -578,3 +751,1756 @@ bool expect_fail(argparse::ArgumentParser& parser, std::vector<std::string> cmd_
     parser.reset_destinations();
     return false;
 }
+
+CheckReporter::CheckReporter(std::string test_name, int& num_failed)
+    : test_name_(std::move(test_name))
+    , num_failed_(num_failed) {}
+
+void CheckReporter::operator()(const std::string& what, bool pass) const {
+    std::cout << (pass ? "[PASS] " : "[FAIL] ") << test_name_ << ": " << what << std::endl;
+    if (!pass) ++num_failed_;
+}
+
+int test_allocation_budgets() {
+    std::cout << "\n";
+    if (!argparse::alloc_counting_enabled()) {
+        std::cout << "[SKIP] Allocation counting not enabled (ARGPARSE_COUNT_ALLOCATIONS)" << std::endl;
+        return 0;
+    }
+
+    int num_failed = 0;
+
+    //The README example
+    struct SmallArgs {
+        ArgValue<bool> do_foo;
+        ArgValue<bool> enable_bar;
+        ArgValue<std::string> filename;
+        ArgValue<size_t> verbosity;
+    } small_args;
+    num_failed += check_allocation_budget("small", [&](argparse::ArgumentParser& parser) {
+            parser.add_argument(small_args.filename, "filename")
+                .help("File to process");
+            parser.add_argument(small_args.do_foo, "--foo")
+                .help("Causes foo")
+                .default_value("false")
+                .action(argparse::Action::STORE_TRUE);
+            parser.add_argument(small_args.enable_bar, "--bar")
+                .help("Control bar")
+                .default_value("false");
+            parser.add_argument(small_args.verbosity, "--verbosity", "-v")
+                .help("Sets the verbosity")
+                .default_value("1")
+                .choices({"0", "1", "2"});
+        },
+        {"input.blif", "--foo", "-v", "2"},
+        {40, 20, 5, 12, 120});
+
+    //100 options of mixed types, with a long command-line
+    struct LargeArgs {
+        ArgValue<int> ints[25];
+        ArgValue<std::string> strs[25];
+        ArgValue<bool> flags[25];
+        ArgValue<std::vector<float>> floats[25];
+    } large_args;
+    std::vector<std::string> large_cmd_line;
+    for (size_t i = 0; i < 25; ++i) {
+        auto num = std::to_string(i);
+        large_cmd_line.insert(large_cmd_line.end(), {"--int" + num, num, "--str" + num, "value" + num, "--flag" + num,
+                                                     "--floats" + num, "0.5", "1.5", "2.5"});
+    }
+    num_failed += check_allocation_budget("large", [&](argparse::ArgumentParser& parser) {
+            for (size_t i = 0; i < 25; ++i) {
+                auto num = std::to_string(i);
+                parser.add_argument(large_args.ints[i], "--int" + num)
+                    .help("Integer option " + num)
+                    .default_value("0");
+                parser.add_argument(large_args.strs[i], "--str" + num)
+                    .help("String option " + num)
+                    .default_value("none");
+                parser.add_argument(large_args.flags[i], "--flag" + num)
+                    .help("Flag option " + num)
+                    .action(argparse::Action::STORE_TRUE)
+                    .default_value("false");
+                parser.add_argument(large_args.floats[i], "--floats" + num)
+                    .help("Multi-value option " + num)
+                    .nargs('+')
+                    .default_value({"1.0"});
+            }
+        },
+        large_cmd_line,
+        {700, 175, 80, 650, 1500});
+
+    return num_failed;
+}
+
+int check_allocation_budget(std::string spec_name, std::function<void(argparse::ArgumentParser&)> register_args,
+                            std::vector<std::string> cmd_line, AllocBudget budget) {
+    using argparse::Phase;
+
+    std::stringstream os;
+
+    argparse::reset_alloc_counts();
+    {
+        argparse::PhaseScope phase(Phase::REGISTRATION);
+        auto parser = argparse::ArgumentParser("alloc_test", "Allocation test", os);
+        register_args(parser);
+
+        parser.freeze();
+        parser.parse_args_throw(cmd_line);
+        parser.print_help();
+        parser.reset_destinations();
+    }
+
+    int num_failed = 0;
+    for (auto phase_budget : {std::make_pair(Phase::REGISTRATION, budget.registration),
+                              std::make_pair(Phase::FREEZE, budget.freeze),
+                              std::make_pair(Phase::DEFAULTS, budget.defaults),
+                              std::make_pair(Phase::PARSE, budget.parse),
+                              std::make_pair(Phase::FORMAT, budget.format)}) {
+        auto counts = argparse::alloc_counts(phase_budget.first);
+
+        bool pass = counts.allocations <= phase_budget.second;
+        std::cout << (pass ? "[PASS] " : "[FAIL] ") << "Allocations for '" << spec_name << "' " << argparse::phase_name(phase_budget.first)
+                  << ": " << counts.allocations << " (" << counts.bytes << " bytes, budget " << phase_budget.second << ")" << std::endl;
+        if (!pass) ++num_failed;
+    }
+    return num_failed;
+}
+
+int test_parse_stats() {
+    std::cout << "\n";
+    if (!argparse::stats_enabled()) {
+        std::cout << "[SKIP] Parse statistics not enabled (ARGPARSE_ENABLE_STATS)" << std::endl;
+        return 0;
+    }
+
+    ArgValue<std::string> filename;
+    ArgValue<bool> do_foo;
+    ArgValue<size_t> verbosity;
+
+    std::stringstream os;
+    auto parser = argparse::ArgumentParser("stats_test", "Statistics test", os);
+    parser.add_argument(filename, "filename");
+    parser.add_argument(do_foo, "--foo")
+        .default_value("false")
+        .action(argparse::Action::STORE_TRUE);
+    parser.add_argument(verbosity, "--verbosity", "-v")
+        .default_value("1")
+        .choices({"0", "1", "2"});
+
+    parser.parse_args_throw({"input.blif", "--foo", "-v", "2"});
+    parser.print_help();
+    const auto& stats = parser.stats();
+
+    int num_failed = 0;
+    CheckReporter check("Parse statistics", num_failed);
+    check("4 tokens classified (" + std::to_string(stats.tokens_classified) + ")", stats.tokens_classified == 4);
+    check("option lookups (" + std::to_string(stats.option_lookups) + ")", stats.option_lookups >= 4);
+    check("choice checks (" + std::to_string(stats.choice_checks) + ")", stats.choice_checks >= 1);
+    check("size_t conversions (" + std::to_string(stats.conversions_by<argparse::DefaultConverter<size_t>>()) + ")",
+          stats.conversions_by<argparse::DefaultConverter<size_t>>() >= 2);
+    check("string conversions (" + std::to_string(stats.conversions_by<argparse::DefaultConverter<std::string>>()) + ")",
+          stats.conversions_by<argparse::DefaultConverter<std::string>>() == 1);
+    check("total conversions (" + std::to_string(stats.conversions) + ")", stats.conversions >= 4);
+    check("parse time recorded", stats.seconds(argparse::Phase::PARSE) > 0.);
+    check("format time recorded", stats.seconds(argparse::Phase::FORMAT) > 0.);
+
+    parser.reset_stats();
+    check("reset", parser.stats().tokens_classified == 0 && parser.stats().conversions == 0);
+
+    return num_failed;
+}
+
+int test_parse_trace() {
+    std::cout << "\n";
+
+    ArgValue<std::string> filename;
+    ArgValue<bool> do_foo;
+    ArgValue<size_t> verbosity;
+
+    std::stringstream os;
+    auto parser = argparse::ArgumentParser("trace_test", "Trace test", os);
+    parser.add_argument(filename, "filename");
+    parser.add_argument(do_foo, "--foo")
+        .default_value("false")
+        .action(argparse::Action::STORE_TRUE);
+    parser.add_argument(verbosity, "--verbosity", "-v")
+        .default_value("1");
+    parser.enable_trace();
+
+    int num_failed = 0;
+    CheckReporter check("Parse trace", num_failed);
+
+    parser.parse_args_throw({"input.blif", "--foo", "-v", "2"});
+    std::stringstream json;
+    parser.trace().write_json(json);
+
+    auto contains = [&](std::string str) {
+        return json.str().find(str) != std::string::npos;
+    };
+    check("has trace events", contains("{\"displayTimeUnit\": \"ns\", \"traceEvents\": ["));
+    check("parse phase", contains("\"name\": \"parse\", \"cat\": \"phase\""));
+    check("positional token", contains("\"name\": \"input.blif\", \"cat\": \"token\"")
+                              && contains("\"index\": 0, \"kind\": \"positional\", \"argument\": \"filename\""));
+    check("option token", contains("\"index\": 2, \"kind\": \"option\", \"argument\": \"--verbosity/-v\""));
+    check("value token", contains("\"index\": 3, \"kind\": \"value\", \"argument\": \"--verbosity/-v\""));
+    check("conversion", contains("\"name\": \"convert '2'\", \"cat\": \"conversion\""));
+    check("default", contains("\"name\": \"default --verbosity/-v\", \"cat\": \"default\""));
+
+    //The trace only covers the most recent parse, and records the failure
+    parser.reset_destinations();
+    try {
+        parser.parse_args_throw({"input.blif", "-v", "many"});
+    } catch (const argparse::ArgParseError&) {
+        //Expected
+    }
+    json.str("");
+    parser.trace().write_json(json);
+    check("cleared between parses", !contains("--foo\", \"cat\": \"token\""));
+    check("failed conversion", contains("\"name\": \"convert 'many'\"") && contains("\"ok\": false"));
+
+    parser.reset_destinations();
+    parser.enable_trace(false);
+    parser.parse_args_throw({"input.blif"});
+    check("disabled", parser.trace().num_events() == 0);
+
+    return num_failed;
+}
+
+int test_memory_usage() {
+    std::cout << "\n";
+
+    ArgValue<std::string> filename;
+    ArgValue<std::string> mode;
+    ArgValue<size_t> verbosity;
+
+    std::stringstream os;
+    auto parser = argparse::ArgumentParser("memory_usage_test", "Memory usage test with a description long enough to be heap allocated", os);
+    parser.add_argument(filename, "filename")
+        .help("The input file, described by help text long enough to be heap allocated");
+    parser.add_argument(mode, "--mode")
+        .choices({"fast", "slow"})
+        .default_value("fast");
+    parser.add_argument(verbosity, "--verbosity", "-v")
+        .default_value("1");
+
+    int num_failed = 0;
+    CheckReporter check("Memory usage", num_failed);
+
+    auto usage = parser.memory_usage();
+    check("argument objects", usage.argument_objects > 0);
+    check("strings", usage.strings > 0);
+    check("choices", usage.choices > 0);
+    check("defaults", usage.defaults > 0);
+    check("formatter", usage.formatter_caches > 0);
+    check("other", usage.other >= sizeof(parser));
+    check("no look-up tables before freeze", usage.lookup_tables == 0);
+    check("total", usage.total() == usage.argument_objects + usage.strings + usage.choices + usage.defaults
+                                    + usage.lookup_tables + usage.formatter_caches + usage.destinations + usage.other);
+
+    parser.freeze();
+    check("look-up tables after freeze", parser.memory_usage().lookup_tables > 0);
+
+    parser.parse_args_throw({"a_long_input_filename_which_is_heap_allocated.blif"});
+    check("destinations", parser.memory_usage().destinations > usage.destinations);
+
+    std::vector<std::string> many_choices;
+    for (size_t i = 0; i < 100; ++i) {
+        many_choices.push_back("choice" + std::to_string(i));
+    }
+    ArgValue<std::string> choice;
+    parser.add_argument(choice, "--choice")
+        .choices(many_choices);
+    check("choices grow", parser.memory_usage().choices >= usage.choices + many_choices.size() * sizeof(std::string));
+
+    return num_failed;
+}
+
+int test_static_parser() {
+    std::cout << "\n";
+
+    ArgValue<std::string> filename;
+    ArgValue<size_t> verbosity;
+    ArgValue<std::string> mode;
+    ArgValue<bool> timing;
+    ArgValue<bool> foo;
+    ArgValue<int> seed;
+
+    StaticTestParser parser(filename, verbosity, mode, argparse::with_converter<OnOff>(timing), foo, seed);
+
+    int num_failed = 0;
+    CheckReporter check("Static parser", num_failed);
+
+    //The compile-time usage and help match the equivalent run-time parser
+    {
+        ArgValue<std::string> dyn_filename;
+        ArgValue<size_t> dyn_verbosity;
+        ArgValue<std::string> dyn_mode;
+        ArgValue<bool> dyn_timing;
+        ArgValue<bool> dyn_foo;
+        ArgValue<int> dyn_seed;
+
+        std::stringstream dyn_os;
+        auto dyn_parser = argparse::ArgumentParser("static_test", "Static parser test", dyn_os);
+        dyn_parser.add_argument(dyn_filename, "filename")
+            .help("The input file");
+        dyn_parser.add_argument(dyn_verbosity, "--verbosity", "-v")
+            .default_value("1")
+            .help("Sets the verbosity");
+        dyn_parser.add_argument(dyn_mode, "--mode")
+            .choices({"fast", "slow"})
+            .default_value("fast");
+        dyn_parser.add_argument<bool,OnOff>(dyn_timing, "--timing")
+            .default_value("on")
+            .help("Controls whether timing analysis is performed, which is a fairly long help string that needs to be wrapped");
+        dyn_parser.add_argument(dyn_foo, "--foo")
+            .action(argparse::Action::STORE_TRUE)
+            .default_value("false");
+        dyn_parser.add_argument(dyn_seed, "--seed")
+            .required(true)
+            .metavar("N");
+        dyn_parser.freeze();
+
+        std::stringstream os;
+        dyn_parser.print_usage();
+        parser.print_usage(os);
+        check("usage", os.str() == dyn_os.str() && os.str() == StaticTestParser::usage());
+
+        dyn_os.str("");
+        os.str("");
+        dyn_parser.print_help();
+        parser.print_help(os);
+        check("help", os.str() == dyn_os.str());
+    }
+
+    parser.parse_args_throw({"input.blif", "-v3", "--foo", "--seed", "7", "--mode", "slow", "--timing", "off"});
+    check("positional", filename.value() == "input.blif" && filename.provenance() == argparse::Provenance::SPECIFIED);
+    check("no space short option", verbosity.value() == 3 && verbosity.argument_name() == "--verbosity/-v");
+    check("store true", foo.value() && foo.provenance() == argparse::Provenance::SPECIFIED);
+    check("choice", mode.value() == "slow");
+    check("converter", !timing.value());
+    check("value", seed.value() == 7 && seed.argument_group() == "arguments");
+
+    parser.reset_destinations();
+    parser.parse_args_throw({"input.blif", "--seed", "1"});
+    check("defaults", verbosity.value() == 1 && verbosity.provenance() == argparse::Provenance::DEFAULT
+                      && mode.value() == "fast" && timing.value() && !foo.value());
+
+    auto expect_error = [&](std::string what, std::vector<std::string> cmd_line, std::string expected_msg) {
+        parser.reset_destinations();
+        std::string msg;
+        try {
+            parser.parse_args_throw(cmd_line);
+        } catch (const argparse::ArgParseError& e) {
+            msg = e.what();
+        }
+        check(what, msg == expected_msg);
+        if (msg != expected_msg) {
+            std::cout << "       Got '" << msg << "'" << std::endl;
+        }
+    };
+    expect_error("missing required", {"input.blif"}, "Missing required argument: --seed");
+    expect_error("missing positional", {"--seed", "1"}, "Missing required positional argument: filename");
+    expect_error("missing value", {"input.blif", "--seed"}, "Missing expected argument for --seed");
+    expect_error("invalid choice", {"input.blif", "--seed", "1", "--mode", "medium"},
+                 "Unexpected option value 'medium' (expected one of: fast, slow) for --mode");
+    expect_error("conversion failure", {"input.blif", "--seed", "one"},
+                 "Invalid conversion from 'one' to integer for --seed");
+    expect_error("unexpected argument", {"input.blif", "extra.blif", "--seed", "1"},
+                 "Unexpected command-line argument 'extra.blif'");
+    expect_error("specified twice", {"input.blif", "--seed", "1", "--seed", "2"},
+                 "Argument --seed specified multiple times");
+
+    bool help_requested = false;
+    try {
+        parser.parse_args_throw({"--help"});
+    } catch (const argparse::ArgParseHelp&) {
+        help_requested = true;
+    }
+    check("help requested", help_requested);
+
+    return num_failed;
+}
+
+int test_generated_parser() {
+    std::cout << "\n";
+
+    gen_test::GenTestArgs args;
+    gen_test::GenTestArgsParser parser(args);
+
+    int num_failed = 0;
+    CheckReporter check("Generated parser", num_failed);
+
+    //The generated usage and help match the equivalent run-time parser
+    {
+        gen_test::GenTestArgs dyn_args;
+
+        std::stringstream dyn_os;
+        auto dyn_parser = argparse::ArgumentParser("gen_test", "Tests the parser generated by argparse_gen", dyn_os);
+        dyn_parser.epilog("See the README for the specification format");
+        dyn_parser.add_argument(dyn_args.input_file, "input_file")
+            .help("Input file")
+            .metavar("INPUT");
+        dyn_parser.add_argument(dyn_args.verbose, "--verbose", "-v")
+            .action(argparse::Action::STORE_TRUE)
+            .help("Enables verbose output");
+        dyn_parser.add_argument(dyn_args.seed, "--seed", "-s")
+            .default_value("1")
+            .help("Random seed");
+
+        auto& stage_grp = dyn_parser.add_argument_group("stage options");
+        stage_grp.add_argument(dyn_args.mode, "--mode")
+            .default_value("fast")
+            .choices({"fast", "slow"})
+            .help("Processing mode");
+        stage_grp.add_argument(dyn_args.output_dir, "--output-dir")
+            .required(true)
+            .help("Output directory");
+        stage_grp.add_argument(dyn_args.check, "--check")
+            .default_value("true")
+            .help("Checks the results");
+        stage_grp.add_argument(dyn_args.cache, "--no-cache")
+            .action(argparse::Action::STORE_FALSE)
+            .help("Disables the cache");
+        dyn_parser.freeze();
+
+        std::stringstream os;
+        dyn_parser.print_usage();
+        parser.print_usage(os);
+        check("usage", os.str() == dyn_os.str());
+
+        dyn_os.str("");
+        os.str("");
+        dyn_parser.print_help();
+        parser.print_help(os);
+        check("help", os.str() == dyn_os.str() && os.str() == gen_test::GenTestArgsParser::help());
+    }
+
+    parser.parse_args_throw({"in.txt", "-s7", "--output-dir", "out", "--mode", "slow", "-v", "--check", "false", "--no-cache"});
+    check("positional", args.input_file.value() == "in.txt" && args.input_file.provenance() == argparse::Provenance::SPECIFIED);
+    check("no space short option", args.seed.value() == 7 && args.seed.argument_name() == "--seed/-s");
+    check("store true", args.verbose.value());
+    check("store false", !args.cache.value());
+    check("choice", args.mode.value() == "slow" && args.mode.argument_group() == "stage options");
+    check("bool", !args.check.value());
+    check("value", args.output_dir.value() == "out");
+
+    parser.reset_destinations();
+    parser.parse_args_throw({"in.txt", "--output-dir", "out"});
+    check("defaults", args.seed.value() == 1 && args.seed.provenance() == argparse::Provenance::DEFAULT
+                      && args.mode.value() == "fast" && args.check.value() && !args.verbose.value());
+
+    auto expect_error = [&](std::string what, std::vector<std::string> cmd_line, std::string expected_msg) {
+        parser.reset_destinations();
+        std::string msg;
+        try {
+            parser.parse_args_throw(cmd_line);
+        } catch (const argparse::ArgParseError& e) {
+            msg = e.what();
+        }
+        check(what, msg == expected_msg);
+        if (msg != expected_msg) {
+            std::cout << "       Got '" << msg << "'" << std::endl;
+        }
+    };
+    expect_error("missing required", {"in.txt"}, "Missing required argument: --output-dir");
+    expect_error("invalid choice", {"in.txt", "--output-dir", "out", "--mode", "medium"},
+                 "Unexpected option value 'medium' (expected one of: fast, slow) for --mode");
+    expect_error("unknown option", {"in.txt", "--output-dir", "out", "--seeds", "1"},
+                 "Unexpected command-line argument '--seeds'");
+
+    bool help_requested = false;
+    try {
+        parser.parse_args_throw({"-h"});
+    } catch (const argparse::ArgParseHelp&) {
+        help_requested = true;
+    }
+    check("help requested", help_requested);
+
+    return num_failed;
+}
+
+//Appends the output to the std::string context
+static void append_output(void* context, const char* data, size_t size) {
+    static_cast<std::string*>(context)->append(data, size);
+}
+
+int test_output_sinks() {
+    std::cout << "\n";
+
+    ArgValue<std::string> filename;
+    ArgValue<size_t> verbosity;
+
+    int num_failed = 0;
+    CheckReporter check("Output sinks", num_failed);
+
+    auto add_arguments = [&](argparse::ArgumentParser& parser) {
+        parser.add_argument(filename, "filename");
+        parser.add_argument(verbosity, "--verbosity", "-v")
+            .default_value("1");
+        parser.enable_trace();
+    };
+
+    //The reference output, via a std::ostream
+    std::stringstream os;
+    auto os_parser = argparse::ArgumentParser("sink_test", "Sink test", os);
+    add_arguments(os_parser);
+    os_parser.print_help();
+    const std::string help = os.str();
+    os.str("");
+    os_parser.print_usage();
+    const std::string usage = os.str();
+
+    argparse::StringOutputSink string_sink;
+    auto parser = argparse::ArgumentParser("sink_test", "Sink test", string_sink);
+    add_arguments(parser);
+    parser.print_help();
+    check("string help", string_sink.str() == help);
+    string_sink.clear();
+    parser.print_usage();
+    check("string usage", string_sink.str() == usage);
+
+    string_sink.clear();
+    parser.parse_args_throw({"in.txt", "-v", "2"});
+    parser.trace().write_json(string_sink);
+    check("trace", string_sink.str() == parser.trace().json());
+
+    std::string callback_output;
+    argparse::CallbackOutputSink callback_sink(append_output, &callback_output);
+    argparse::ArgumentParser("sink_test", "Sink test", callback_sink).print_usage();
+    check("callback", callback_output == "usage: sink_test\n");
+
+    //The stdio and fd sinks write to a temporary file, which is then read back
+    auto file_output = [&](std::function<void(std::FILE*)> write) {
+        std::FILE* file = std::tmpfile();
+        if (!file) return std::string("<no temporary file>");
+        write(file);
+        std::fflush(file);
+        std::rewind(file);
+
+        std::string output;
+        char buf[256];
+        size_t size;
+        while ((size = std::fread(buf, 1, sizeof(buf), file)) > 0) {
+            output.append(buf, size);
+        }
+        std::fclose(file);
+        return output;
+    };
+    std::string stdio_output = file_output([&](std::FILE* file) {
+        argparse::StdioOutputSink stdio_sink(file);
+        stdio_sink.write(help);
+        stdio_sink.flush();
+    });
+    check("stdio", stdio_output == help);
+    std::string fd_output = file_output([&](std::FILE* file) {
+        argparse::FdOutputSink fd_sink(fileno(file));
+        fd_sink.write(help);
+    });
+    check("fd", fd_output == help);
+
+    //Static parsers print to sinks too
+    ArgValue<std::string> static_filename;
+    ArgValue<size_t> static_verbosity;
+    ArgValue<std::string> static_mode;
+    ArgValue<bool> static_timing;
+    ArgValue<bool> static_foo;
+    ArgValue<int> static_seed;
+    StaticTestParser static_parser(static_filename, static_verbosity, static_mode,
+                                   argparse::with_converter<OnOff>(static_timing), static_foo, static_seed);
+    string_sink.clear();
+    static_parser.print_help(string_sink);
+    check("static help", string_sink.str() == StaticTestParser::help());
+
+    return num_failed;
+}
+
+int test_move_semantics() {
+    std::cout << "\n";
+
+    ArgValue<CopyCounted> single;
+    ArgValue<std::vector<CopyCounted>> multi;
+
+    std::stringstream os;
+    auto parser = argparse::ArgumentParser("move_test", "Move test", os);
+    parser.add_argument<CopyCounted,CopyCountedConverter>(single, "--single")
+        .default_value("default");
+    parser.add_argument<CopyCounted,CopyCountedConverter>(multi, "--multi")
+        .nargs('+')
+        .default_value(std::vector<std::string>{"a", "b"});
+
+    int num_failed = 0;
+    CheckReporter check("Move semantics", num_failed);
+
+    CopyCounted::copies = 0;
+    parser.parse_args_throw(std::vector<std::string>{});
+    check("defaults not copied (" + std::to_string(CopyCounted::copies) + " copies)",
+          CopyCounted::copies == 0 && single.value().value == "default" && multi.value().size() == 2);
+
+    parser.reset_destinations();
+    CopyCounted::copies = 0;
+    parser.parse_args_throw({"--single", "x", "--multi", "1", "2", "3", "4", "5", "6", "7", "8", "9"});
+    check("parsed values not copied (" + std::to_string(CopyCounted::copies) + " copies)",
+          CopyCounted::copies == 0 && single.value().value == "x" && multi.value().size() == 9);
+
+    //Reading (implicitly or by streaming) refers to the stored value
+    const CopyCounted& single_ref = single;
+    const std::vector<CopyCounted>& multi_ref = multi;
+    std::stringstream value_os;
+    value_os << single;
+    check("reads not copied", CopyCounted::copies == 0 && &single_ref == &single.value()
+                              && &multi_ref == &multi.value() && value_os.str() == "x");
+
+    //Values can be moved out of (and into) ConvertedValues and ArgValues
+    ConvertedValue<CopyCounted> converted_value = CopyCountedConverter().from_str("y");
+    CopyCounted moved = std::move(converted_value).value();
+    single.set(std::move(moved), argparse::Provenance::SPECIFIED);
+    check("moves not copied", CopyCounted::copies == 0 && single.value().value == "y");
+
+    return num_failed;
+}
+
+int test_reparse_allocations() {
+    using argparse::Phase;
+    using argparse::ResetMode;
+
+    std::cout << "\n";
+    if (!argparse::alloc_counting_enabled()) {
+        std::cout << "[SKIP] Allocation counting not enabled (ARGPARSE_COUNT_ALLOCATIONS)" << std::endl;
+        return 0;
+    }
+
+    ArgValue<std::string> filename;
+    ArgValue<int> verbosity;
+    ArgValue<std::string> mode;
+    ArgValue<bool> timing;
+    ArgValue<std::vector<float>> weights;
+    ArgValue<std::vector<int>> seeds;
+
+    std::stringstream os;
+    auto parser = argparse::ArgumentParser("reparse_test", "Reparse test", os);
+    parser.add_argument(filename, "filename");
+    parser.add_argument(verbosity, "--verbosity", "-v")
+        .default_value("1");
+    parser.add_argument(mode, "--mode")
+        .choices({"fast", "exhaustive_with_a_long_name"})
+        .default_value("fast");
+    parser.add_argument(timing, "--timing")
+        .action(argparse::Action::STORE_TRUE)
+        .default_value("false");
+    parser.add_argument(weights, "--weights")
+        .nargs('+')
+        .default_value({"1.0"})
+        .capacity_hint(8);
+    parser.add_argument(seeds, "--seeds")
+        .nargs('*')
+        .capacity_hint(16);
+
+    int num_failed = 0;
+    CheckReporter check("Reparse allocations", num_failed);
+    check("capacity hint reserved", weights.value().capacity() >= 8 && seeds.value().capacity() >= 16);
+
+    //Alternate between command-lines, as a dispatcher would
+    std::vector<std::vector<const char*>> cmd_lines = {
+        {"reparse_test", "/a/fairly/long/path/to/the/input/file.blif", "-v3", "--weights", "0.5", "1.5", "2.5"},
+        {"reparse_test", "short.blif", "--mode", "exhaustive_with_a_long_name", "--timing", "--seeds", "1", "2", "3", "4"},
+        {"reparse_test", "another/long/path/to/an/input/file.blif", "--verbosity", "0", "--seeds"},
+    };
+
+    auto reparse_allocations = [&](ResetMode reset_mode) {
+        size_t allocations = 0;
+        for (size_t iter = 0; iter < 2 * cmd_lines.size(); ++iter) {
+            //The first pass warms up
+            if (iter == cmd_lines.size()) argparse::reset_alloc_counts();
+
+            auto& cmd_line = cmd_lines[iter % cmd_lines.size()];
+            parser.reset_destinations(reset_mode);
+            parser.parse_args_throw(static_cast<int>(cmd_line.size()), cmd_line.data());
+        }
+        for (size_t iphase = 0; iphase < static_cast<size_t>(Phase::NUM_PHASES); ++iphase) {
+            allocations += argparse::alloc_counts(static_cast<Phase>(iphase)).allocations;
+        }
+        return allocations;
+    };
+
+    size_t reinit_allocations = reparse_allocations(ResetMode::REINITIALIZE);
+    size_t keep_allocations = reparse_allocations(ResetMode::KEEP_CAPACITY);
+    check("re-initializing allocates (" + std::to_string(reinit_allocations) + ")", reinit_allocations > 0);
+    check("keeping capacity does not allocate (" + std::to_string(keep_allocations) + ")", keep_allocations == 0);
+
+    //The values of the last parse are unaffected by the re-use
+    check("values", filename.value() == "another/long/path/to/an/input/file.blif" && verbosity == 0
+                    && mode.value() == "fast" && !timing && weights.value() == std::vector<float>{1.0}
+                    && seeds.value().empty() && seeds.provenance() == argparse::Provenance::UNSPECIFIED);
+
+    parser.reset_destinations(ResetMode::KEEP_CAPACITY);
+    check("reset keeping capacity", filename.value().empty() && filename.provenance() == argparse::Provenance::UNSPECIFIED
+                                    && filename.argument_name().empty() && weights.value().empty()
+                                    && weights.value().capacity() >= 8);
+    parser.reset_destinations();
+    check("reset re-initializing", filename.value().capacity() < 20 && weights.value().capacity() == 8);
+
+    return num_failed;
+}
+
+int test_lazy_conversion() {
+    std::cout << "\n";
+
+    ArgValue<int> rarely_read;
+    ArgValue<int> bad;
+    ArgValue<int> eager;
+    ArgValue<std::string> name;
+    ArgValue<std::vector<int>> multi;
+
+    std::stringstream os;
+    auto parser = argparse::ArgumentParser("lazy_test", "Lazy test", os);
+    parser.add_argument<int,CountingIntConverter>(rarely_read, "--rarely_read")
+        .default_value("7")
+        .lazy(true);
+    parser.add_argument<int,CountingIntConverter>(bad, "--bad")
+        .lazy(true);
+    parser.add_argument<int,CountingIntConverter>(eager, "--eager")
+        .default_value("1");
+    parser.add_argument(name, "--name")
+        .lazy(true);
+    auto& multi_arg = parser.add_argument(multi, "--multi").nargs('+');
+
+    int num_failed = 0;
+    CheckReporter check("Lazy conversion", num_failed);
+
+    //Lazy arguments only store the string when parsed
+    CountingIntConverter::conversions = 0;
+    parser.parse_args_throw({"--bad", "not_an_int", "--name", "lazy"});
+    check("parse defers conversion", CountingIntConverter::conversions == 1 //--eager's default
+                                     && rarely_read.conversion_pending() && bad.conversion_pending()
+                                     && bad.provenance() == argparse::Provenance::SPECIFIED
+                                     && bad.pending_str() == "not_an_int");
+
+    //Converted once, on first access
+    check("converted on access", rarely_read == 7 && rarely_read.value() == 7
+                                 && rarely_read.provenance() == argparse::Provenance::DEFAULT
+                                 && !rarely_read.conversion_pending() && CountingIntConverter::conversions == 2);
+    check("string on access", name.value() == "lazy");
+
+    //Conversion errors are reported when read (naming the argument), or by validate()
+    bool read_threw = false;
+    try {
+        int val = bad;
+        (void) val;
+    } catch (const argparse::ArgParseConversionError& err) {
+        read_threw = std::string(err.what()).find("--bad") != std::string::npos;
+    }
+    check("error on access", read_threw && bad.conversion_pending());
+
+    bool validate_threw = false;
+    try {
+        parser.validate();
+    } catch (const argparse::ArgParseConversionError&) {
+        validate_threw = true;
+    }
+    check("validate reports errors", validate_threw);
+
+    parser.reset_destinations(argparse::ResetMode::KEEP_CAPACITY);
+    parser.parse_args_throw({"--bad", "3"});
+    CountingIntConverter::conversions = 0;
+    parser.validate();
+    check("validate converts pending", !bad.conversion_pending() && bad == 3 && rarely_read == 7
+                                       && CountingIntConverter::conversions == 2);
+
+    //Setting a value directly drops a pending conversion
+    parser.reset_destinations();
+    parser.parse_args_throw({"--bad", "not_an_int"});
+    bad.set(5, argparse::Provenance::INFERRED);
+    check("set drops pending", !bad.conversion_pending() && bad == 5);
+
+    bool multi_threw = false;
+    try {
+        multi_arg.lazy(true);
+    } catch (const argparse::ArgParseError&) {
+        multi_threw = true;
+    }
+    check("multi-value arguments can't be lazy", multi_threw && !multi_arg.lazy());
+
+    return num_failed;
+}
+
+int test_inferred_values() {
+    std::cout << "\n";
+
+    ArgValue<float> clock_period;
+    ArgValue<int> num_stages;
+    ArgValue<bool> pipelined;
+    ArgValue<float> stage_budget;
+    ArgValue<float> timing_budget;
+
+    std::stringstream os;
+    auto parser = argparse::ArgumentParser("inferred_test", "Inferred test", os);
+    parser.add_argument(clock_period, "--clock_period")
+        .default_value("10");
+    parser.add_argument(num_stages, "--num_stages")
+        .default_value("4");
+    parser.add_argument(pipelined, "--pipelined")
+        .action(argparse::Action::STORE_TRUE)
+        .default_value("false");
+
+    //Declared before its input (which is itself inferred), so is evaluated in dependency (not declaration) order
+    auto& timing_inferred = parser.add_inferred(timing_budget, "timing_budget", [&]() {
+            return pipelined ? stage_budget.value() : clock_period.value();
+        })
+        .depends_on(pipelined)
+        .depends_on(stage_budget)
+        .depends_on(clock_period);
+    auto& stage_inferred = parser.add_inferred(stage_budget, "stage_budget", [&]() {
+            return clock_period / num_stages;
+        })
+        .depends_on(clock_period)
+        .depends_on(num_stages);
+
+    int num_failed = 0;
+    CheckReporter check("Inferred values", num_failed);
+
+    parser.parse_args_throw({"--pipelined"});
+    check("computed lazily", timing_inferred.num_computations() == 0 && stage_inferred.num_computations() == 0);
+    check("dependency order", timing_budget == 2.5f && stage_budget == 2.5f
+                              && timing_budget.provenance() == argparse::Provenance::INFERRED
+                              && timing_budget.argument_name() == "timing_budget");
+    float read_again = timing_budget;
+    check("memoized", read_again == 2.5f && timing_inferred.num_computations() == 1 && stage_inferred.num_computations() == 1);
+
+    //Re-parsing unchanged inputs does not re-compute
+    parser.reset_destinations(argparse::ResetMode::KEEP_CAPACITY);
+    parser.parse_args_throw({"--pipelined"});
+    check("unchanged inputs", timing_budget == 2.5f && timing_inferred.num_computations() == 1
+                              && stage_inferred.num_computations() == 1);
+
+    //Values whose (direct or indirect) inputs changed are re-computed, once
+    parser.reset_destinations(argparse::ResetMode::KEEP_CAPACITY);
+    parser.parse_args_throw({"--clock_period", "20"});
+    check("changed input", timing_budget == 20.f && stage_budget == 5.f && timing_budget == 20.f
+                           && timing_inferred.num_computations() == 2 && stage_inferred.num_computations() == 2);
+
+    //Inputs set directly (e.g. when reloading a configuration) are picked up once invalidated
+    pipelined.set(true, argparse::Provenance::SPECIFIED);
+    parser.invalidate_inferred();
+    parser.validate();
+    check("reload", !timing_budget.conversion_pending() && timing_budget == 5.f && timing_inferred.num_computations() == 3);
+
+    //Circular dependencies are reported
+    ArgValue<int> a;
+    ArgValue<int> b;
+    std::stringstream cycle_os;
+    auto cycle_parser = argparse::ArgumentParser("cycle_test", "Cycle test", cycle_os);
+    cycle_parser.add_inferred(a, "a", [&]() { return b + 1; }).depends_on(b);
+    cycle_parser.add_inferred(b, "b", [&]() { return a + 1; }).depends_on(a);
+    std::string cycle_error;
+    try {
+        cycle_parser.parse_args_throw(std::vector<std::string>{});
+    } catch (const argparse::ArgParseError& err) {
+        cycle_error = err.what();
+    }
+    check("circular dependency (" + cycle_error + ")", cycle_error.find("a -> b -> a") != std::string::npos);
+
+    //Values still pending when their parser is destroyed (or replaced) are computed then,
+    //so they remain readable afterwards
+    ArgValue<int> width;
+    ArgValue<int> area;
+    ArgValue<int> perimeter;
+    ArgValue<int> copied_volume;
+    ArgValue<int> moved_volume;
+    {
+        //Declared before the parser, as the destinations of inferred values must outlive it
+        ArgValue<int> square;
+        ArgValue<int> cube;
+        ArgValue<int> volume;
+        ArgValue<int> other_volume;
+
+        std::stringstream scoped_os;
+        auto scoped_parser = argparse::ArgumentParser("scoped_test", "Scoped test", scoped_os);
+        scoped_parser.add_argument(width, "--width");
+        scoped_parser.add_inferred(area, "area", [&]() { return width * width; }).depends_on(width);
+        scoped_parser.parse_args_throw({"--width", "3"});
+
+        //Copies and moves of pending values are brought up-to-date first, so they neither
+        //compute into the original nor refer back to the parser
+        scoped_parser.add_inferred(square, "square", [&]() { return width * width; }).depends_on(width);
+        scoped_parser.add_inferred(cube, "cube", [&]() { return width * width * width; }).depends_on(width);
+        ArgValue<int> square_copy(square);
+        ArgValue<int> cube_moved(std::move(cube));
+        check("copied pending value", !square_copy.conversion_pending() && square_copy == 9 && square == 9);
+        check("moved pending value", !cube_moved.conversion_pending() && cube_moved == 27);
+
+        scoped_parser.add_inferred(volume, "volume", [&]() { return width * width * width; }).depends_on(width);
+        scoped_parser.add_inferred(other_volume, "other_volume", [&]() { return width * width * width; }).depends_on(width);
+        copied_volume = volume;
+        moved_volume = std::move(other_volume);
+
+        auto replaced_parser = argparse::ArgumentParser("replaced_test", "Replaced test", scoped_os);
+        replaced_parser.add_inferred(perimeter, "perimeter", [&]() { return 4 * width; }).depends_on(width);
+        replaced_parser = argparse::ArgumentParser("replacement_test", "Replacement test", scoped_os);
+        check("replaced parser", !perimeter.conversion_pending() && perimeter == 12);
+    }
+    check("destroyed parser", !area.conversion_pending() && area == 9
+                              && area.provenance() == argparse::Provenance::INFERRED);
+    check("copied before destruction", !copied_volume.conversion_pending() && copied_volume == 27
+                                       && copied_volume.argument_name() == "volume");
+    check("moved before destruction", !moved_volume.conversion_pending() && moved_volume == 27);
+    ArgValue<int> area_copy(area);
+    ArgValue<int> area_moved(std::move(area_copy));
+    check("copied and moved after destruction", area_moved == 9 && area == 9);
+
+    return num_failed;
+}
+
+int test_argument_constraints() {
+    std::cout << "\n";
+
+    ArgValue<std::string> input;
+    ArgValue<bool> fast;
+    ArgValue<bool> exhaustive;
+    ArgValue<std::string> netlist;
+    ArgValue<std::string> blif;
+    ArgValue<bool> timing;
+    ArgValue<std::string> sdc;
+    ArgValue<bool> power;
+    ArgValue<bool> quiet;
+    ArgValue<bool> verbose;
+
+    std::stringstream os;
+    auto parser = argparse::ArgumentParser("constraint_test", "Constraint test", os);
+    parser.add_argument(input, "input");
+    parser.add_argument(timing, "--timing").action(argparse::Action::STORE_TRUE);
+    parser.add_argument(sdc, "--sdc");
+    parser.add_argument(power, "--power").action(argparse::Action::STORE_TRUE);
+    parser.add_argument(quiet, "--quiet", "-q").action(argparse::Action::STORE_TRUE);
+    parser.add_argument(verbose, "--verbose", "-v").action(argparse::Action::STORE_TRUE);
+
+    auto& effort_grp = parser.add_argument_group("effort");
+    effort_grp.add_argument(fast, "--fast").action(argparse::Action::STORE_TRUE);
+    effort_grp.add_argument(exhaustive, "--exhaustive").action(argparse::Action::STORE_TRUE);
+    effort_grp.mutually_exclusive();
+
+    auto& format_grp = parser.add_argument_group("format");
+    format_grp.add_argument(netlist, "--netlist");
+    format_grp.add_argument(blif, "--blif");
+    format_grp.at_least_one_of();
+
+    parser.requires_all("--power", {"--timing", "--sdc"})
+          .conflicts_with("-q", {"--verbose"})
+          .mutually_exclusive({"--netlist", "input"});
+
+    int num_failed = 0;
+    CheckReporter check("Argument constraints", num_failed);
+    auto parse_error = [&](std::vector<std::string> cmd_line) {
+        std::string error;
+        try {
+            parser.parse_args_throw(cmd_line);
+        } catch (const argparse::ArgParseError& err) {
+            error = err.what();
+        }
+        parser.reset_destinations();
+        return error;
+    };
+
+    check("satisfied", parse_error({"in", "--blif", "b", "--fast", "--power", "--timing", "--sdc", "s", "-q"}).empty());
+    check("group mutually exclusive", parse_error({"in", "--blif", "b", "--fast", "--exhaustive"})
+                                      == "Arguments --fast, --exhaustive are mutually exclusive");
+    check("group at least one of", parse_error({"in", "--fast"})
+                                   == "One of the arguments --netlist, --blif is required");
+    check("requires", parse_error({"in", "--blif", "b", "--power", "--timing"})
+                      == "Argument --power requires --sdc");
+    check("conflicts", parse_error({"in", "--blif", "b", "-v", "-q"})
+                       == "Argument --quiet/-q conflicts with --verbose/-v");
+    check("positional", parse_error({"in", "--netlist", "n"})
+                        == "Arguments input, --netlist are mutually exclusive");
+    check("required", parse_error({"--blif", "b"}) == "Missing required positional argument: input");
+
+    //Constraints are resolved against the arguments when the parser is frozen
+    parser.conflicts_with("--timing", {"--no_such_option"});
+    check("unknown argument", parse_error({"in", "--blif", "b"})
+                              == "Constraint refers to unknown argument '--no_such_option'");
+
+    return num_failed;
+}
+
+int test_accumulating_actions() {
+    using argparse::Action;
+    std::cout << "\n";
+
+    ArgValue<std::vector<std::string>> include_dirs;
+    ArgValue<std::vector<int>> seeds;
+    ArgValue<int> verbosity;
+    ArgValue<size_t> warnings;
+
+    std::stringstream os;
+    auto parser = argparse::ArgumentParser("accumulate_test", "Accumulate test", os);
+    parser.add_argument(include_dirs, "--include", "-I")
+        .action(Action::APPEND)
+        .default_value(std::vector<std::string>{"/usr/include"});
+    parser.add_argument(seeds, "--seeds")
+        .action(Action::EXTEND)
+        .capacity_hint(4);
+    parser.add_argument(verbosity, "--verbose", "-v")
+        .action(Action::COUNT)
+        .default_value("1");
+    parser.add_argument(warnings, "-W")
+        .action(Action::COUNT);
+
+    int num_failed = 0;
+    CheckReporter check("Accumulating actions", num_failed);
+
+    parser.parse_args_throw(std::vector<std::string>{});
+    check("defaults", include_dirs.value() == std::vector<std::string>{"/usr/include"} && seeds.value().empty()
+                      && verbosity == 1 && warnings == 0u);
+
+    parser.reset_destinations();
+    parser.parse_args_throw({"-I", "a", "--include", "b", "-Ic", "--seeds", "1", "2", "-v", "--seeds", "3", "-vvv", "-W", "-WW"});
+    check("append", include_dirs.value() == std::vector<std::string>{"a", "b", "c"}
+                    && include_dirs.provenance() == argparse::Provenance::SPECIFIED);
+    check("extend", seeds.value() == std::vector<int>{1, 2, 3});
+    check("count", verbosity == 5 && verbosity.provenance() == argparse::Provenance::SPECIFIED && warnings == 3u);
+
+    //Occurrences append to the existing buffer
+    const int* seeds_data = seeds.value().data();
+    parser.reset_destinations(argparse::ResetMode::KEEP_CAPACITY);
+    parser.parse_args_throw({"--seeds", "4", "--seeds", "5", "6", "--seeds", "7"});
+    check("buffer re-used", seeds.value() == std::vector<int>{4, 5, 6, 7} && seeds.value().data() == seeds_data);
+
+    parser.reset_destinations();
+    check("repeated short option must match", expect_fail(parser, {"-vvq"}));
+    check("append takes one value", expect_fail(parser, {"-I", "a", "b"}));
+
+    //Actions are checked against the destination
+    ArgValue<float> ratio;
+    ArgValue<int> single;
+    bool count_threw = false;
+    try {
+        parser.add_argument(ratio, "--ratio").action(Action::COUNT);
+    } catch (const argparse::ArgParseError&) {
+        count_threw = true;
+    }
+    bool append_threw = false;
+    try {
+        parser.add_argument(single, "--single").action(Action::APPEND);
+    } catch (const argparse::ArgParseError&) {
+        append_threw = true;
+    }
+    check("invalid destinations", count_threw && append_threw);
+
+    return num_failed;
+}
+
+//Options registered by independent components
+struct RouterOptions {
+    ArgValue<int> max_iterations;
+    ArgValue<size_t> seed;
+
+    void add_options(argparse::ArgumentGroup& grp) {
+        grp.add_argument(max_iterations, "--max_router_iterations").default_value("50");
+        grp.add_argument(seed, "--router_seed");
+    }
+};
+
+struct PlacerOptions {
+    ArgValue<float> inner_num;
+    ArgValue<size_t> seed;
+
+    void add_options(argparse::ArgumentGroup& grp) {
+        grp.add_argument(inner_num, "--inner_num").default_value("1.0");
+        grp.add_argument(seed, "--router_seed"); //Conflicts with RouterOptions
+    }
+};
+
+int test_option_modules() {
+    std::cout << "\n";
+
+    ArgValue<std::string> circuit;
+    ArgValue<bool> timing;
+    RouterOptions router;
+    PlacerOptions placer;
+
+    std::stringstream os;
+    auto parser = argparse::ArgumentParser("module_test", "Module test", os);
+    parser.add_argument(circuit, "circuit");
+    parser.add_argument(timing, "--timing").action(argparse::Action::STORE_TRUE);
+
+    int num_failed = 0;
+    CheckReporter check("Option modules", num_failed);
+    auto add_module_error = [&](std::string name, std::function<void(argparse::ArgumentGroup&)> add_options) {
+        std::string error;
+        try {
+            parser.add_module(name, add_options);
+        } catch (const argparse::ArgParseError& err) {
+            error = err.what();
+        }
+        return error;
+    };
+
+    auto& router_grp = parser.add_module("router", [&](argparse::ArgumentGroup& grp) { router.add_options(grp); });
+    check("module added", router_grp.module_name() == "router" && router_grp.arguments().size() == 2);
+
+    std::string placer_error = add_module_error("placer", [&](argparse::ArgumentGroup& grp) { placer.add_options(grp); });
+    check("conflict names modules (" + placer_error + ")",
+          placer_error == "Option '--router_seed' of module 'placer' conflicts with module 'router'");
+
+    std::string core_error = add_module_error("timing", [&](argparse::ArgumentGroup& grp) {
+            grp.add_argument(timing, "--timing").action(argparse::Action::STORE_TRUE);
+        });
+    check("conflict with parser options", core_error == "Option '--timing' of module 'timing' conflicts with argument group 'arguments'");
+
+    //Modules whose options fail to be added are removed too
+    ArgValue<int> broken_opt;
+    std::string broken_error = add_module_error("broken", [&](argparse::ArgumentGroup& grp) {
+            grp.add_argument(broken_opt, "--broken_opt").action(static_cast<argparse::Action>(-1));
+        });
+    check("failed module reports error (" + broken_error + ")", broken_error == "Unrecognized argparse action");
+
+    //Conflicting modules are removed, and the option strings they registered released
+    check("conflicting modules removed", parser.argument_groups().size() == 2);
+    check("failed module removed", expect_fail(parser, {"c.blif", "--broken_opt", "1"}));
+    parser.add_module("placer", [&](argparse::ArgumentGroup& grp) {
+        grp.add_argument(placer.inner_num, "--inner_num").default_value("1.0");
+        grp.add_argument(placer.seed, "--placer_seed");
+    });
+    parser.parse_args_throw({"c.blif", "--router_seed", "3", "--inner_num", "2", "--placer_seed", "4"});
+    check("merged modules parse", router.max_iterations == 50 && router.seed == 3u && placer.inner_num == 2.f && placer.seed == 4u);
+
+    return num_failed;
+}
+
+int test_parent_parsers() {
+    using argparse::Phase;
+    std::cout << "\n";
+
+    auto total_allocations = []() {
+        size_t allocations = 0;
+        for (size_t iphase = 0; iphase < static_cast<size_t>(Phase::NUM_PHASES); ++iphase) {
+            allocations += argparse::alloc_counts(static_cast<Phase>(iphase)).allocations;
+        }
+        return allocations;
+    };
+
+    //Options common to several tools
+    const size_t num_common = 80;
+    std::vector<ArgValue<int>> common(num_common);
+    ArgValue<std::string> log_file;
+
+    std::stringstream os;
+    argparse::reset_alloc_counts();
+    auto common_parser = argparse::ArgumentParser("common", "Common options", os);
+    for (size_t i = 0; i < num_common; ++i) {
+        common_parser.add_argument(common[i], "--common_option_" + std::to_string(i))
+            .help("Common option number " + std::to_string(i))
+            .default_value(std::to_string(i));
+    }
+    auto& logging_grp = common_parser.add_argument_group("logging");
+    logging_grp.add_argument(log_file, "--log_file");
+    size_t common_allocations = total_allocations();
+
+    int num_failed = 0;
+    CheckReporter check("Parent parsers", num_failed);
+
+    //Tools including the common options
+    ArgValue<std::string> route_file;
+    argparse::reset_alloc_counts();
+    auto router_parser = argparse::ArgumentParser("router", "Router", os);
+    router_parser.add_parent(common_parser);
+    size_t child_allocations = total_allocations();
+    router_parser.add_argument(route_file, "--route_file");
+
+    ArgValue<float> inner_num;
+    auto placer_parser = argparse::ArgumentParser("placer", "Placer", os);
+    placer_parser.add_parent(common_parser);
+    placer_parser.add_argument(inner_num, "--inner_num").default_value("1.0");
+
+    if (argparse::alloc_counting_enabled()) {
+        check("definitions shared (" + std::to_string(child_allocations) + " vs. " + std::to_string(common_allocations) + " allocations)",
+              child_allocations * 20 < common_allocations);
+    }
+
+    //Adding to (or freezing) a parser copies only its own groups' argument lists
+    const auto& common_groups = common_parser.argument_groups();
+    check("copy-on-write", common_groups.size() == 2 && common_groups[0].arguments().size() == num_common
+                           && router_parser.argument_groups()[0].arguments().size() == num_common + 1
+                           && router_parser.argument_groups()[1].arguments()[0] == common_groups[1].arguments()[0]);
+
+    router_parser.parse_args_throw({"--common_option_3", "42", "--route_file", "r.route", "--log_file", "router.log"});
+    check("child parses shared options", common[3] == 42 && common[79] == 79 && route_file.value() == "r.route"
+                                         && log_file.value() == "router.log");
+    router_parser.reset_destinations();
+
+    placer_parser.parse_args_throw({"--common_option_3", "7", "--inner_num", "2"});
+    check("sibling unaffected", common[3] == 7 && inner_num == 2.f && route_file.value().empty());
+    check("parent not modified", expect_fail(common_parser, {"--inner_num", "2"}) && expect_pass(common_parser, {"--common_option_0", "1"}));
+
+    std::string help = router_parser.argument_groups()[0].arguments().back()->name();
+    check("own help", help == "--help/-h");
+
+    return num_failed;
+}
+
+int test_subcommands() {
+    std::cout << "\n";
+
+    int num_failed = 0;
+    CheckReporter check("Subcommands", num_failed);
+
+    ArgValue<bool> verbose;
+    ArgValue<std::string> route_file;
+    ArgValue<int> route_iters;
+    ArgValue<std::string> place_file;
+    std::vector<ArgValue<int>> tool_options(50);
+
+    std::map<std::string,size_t> num_builds;
+
+    argparse::StringOutputSink sink;
+    auto parser = argparse::ArgumentParser("flow", "Runs a tool", sink);
+    parser.add_argument(verbose, "--verbose").action(argparse::Action::STORE_TRUE);
+    parser.add_subcommand("route", "Routes the design", [&](argparse::ArgumentParser& route_parser) {
+        ++num_builds["route"];
+        route_parser.add_argument(route_file, "route_file");
+        route_parser.add_argument(route_iters, "--iters").default_value("50");
+    });
+    parser.add_subcommand("place", "Places the design", [&](argparse::ArgumentParser& place_parser) {
+        ++num_builds["place"];
+        place_parser.add_argument(place_file, "--place_file").default_value("design.place");
+    });
+    for (size_t i = 0; i < tool_options.size(); ++i) {
+        std::string name = "tool_" + std::to_string(i);
+        parser.add_subcommand(name, "Tool number " + std::to_string(i), [&, i, name](argparse::ArgumentParser& tool_parser) {
+            ++num_builds[name];
+            tool_parser.add_argument(tool_options[i], "--option");
+        });
+    }
+
+    check("duplicate rejected", [&]() {
+        try {
+            parser.add_subcommand("route", "Again", [](argparse::ArgumentParser&) {});
+        } catch (const argparse::ArgParseError&) {
+            return true;
+        }
+        return false;
+    }());
+
+    parser.parse_args_throw({"--verbose", "route", "r.route", "--iters", "10"});
+    check("selected subcommand parses the remaining tokens", parser.subcommand() == "route" && verbose
+                                                            && route_file.value() == "r.route" && route_iters == 10);
+    check("only the selected subcommand is built", num_builds.size() == 1 && num_builds["route"] == 1);
+    parser.reset_destinations();
+    check("subcommand destinations reset", route_file.value().empty() && route_iters == 0);
+
+    parser.parse_args_throw({"route", "other.route"});
+    check("built once", num_builds["route"] == 1 && route_file.value() == "other.route" && route_iters == 50 && !verbose);
+    parser.reset_destinations();
+
+    parser.parse_args_throw({"tool_42", "--option", "3"});
+    check("dispatch among many", parser.subcommand() == "tool_42" && tool_options[42] == 3 && num_builds.size() == 2);
+    parser.reset_destinations();
+
+    check("missing subcommand", expect_fail(parser, {"--verbose"}));
+    check("unknown subcommand", expect_fail(parser, {"--verbose", "reroute"}));
+    check("subcommand's errors", expect_fail(parser, {"route"}) && expect_fail(parser, {"place", "--iters", "3"}));
+    check("parent options precede the subcommand", expect_fail(parser, {"place", "--verbose"}));
+
+    sink.clear();
+    parser.print_help();
+    check("help lists subcommands without building them",
+          sink.str().find("{route,place,tool_0,") != std::string::npos
+          && sink.str().find("subcommands:") != std::string::npos
+          && sink.str().find("Places the design") != std::string::npos
+          && num_builds.size() == 3);
+
+    sink.clear();
+    parser.print_full_help();
+    check("full help builds all subcommands", num_builds.size() == 2 + tool_options.size()
+                                              && sink.str().find("usage: flow place [--place_file PLACE_FILE]") != std::string::npos);
+
+    ArgValue<bool> unused;
+    auto help_parser = argparse::ArgumentParser("flow", "Runs a tool", sink);
+    help_parser.add_subcommand("route", "Routes the design", [&](argparse::ArgumentParser& route_parser) {
+        route_parser.add_argument(unused, "--unused").action(argparse::Action::STORE_TRUE);
+    });
+    check("subcommand help", [&]() {
+        try {
+            help_parser.parse_args_throw({"route", "--help"});
+        } catch (const argparse::ArgParseHelp&) {
+            return help_parser.subcommand() == "route";
+        }
+        return false;
+    }());
+
+    return num_failed;
+}
+
+int test_default_providers() {
+    std::cout << "\n";
+
+    int num_failed = 0;
+    CheckReporter check("Default providers", num_failed);
+
+    ArgValue<size_t> num_workers;
+    ArgValue<std::string> calibration;
+    ArgValue<std::vector<std::string>> sites;
+    size_t num_probes = 0;
+    size_t num_reads = 0;
+    size_t num_scans = 0;
+
+    std::stringstream os;
+    auto parser = argparse::ArgumentParser("tool", "Default providers", os);
+    parser.add_argument(num_workers, "--num_workers")
+        .help("Number of worker threads")
+        .default_value([&]() {
+            ++num_probes;
+            return std::to_string(8);
+        });
+    parser.add_argument(calibration, "--calibration")
+        .default_value([&]() {
+            ++num_reads;
+            return std::string("calibrated");
+        });
+    parser.add_argument(sites, "--sites")
+        .nargs('+')
+        .default_value([&]() {
+            ++num_scans;
+            return std::vector<std::string>{"site_a", "site_b"};
+        });
+
+    check("scalar provider for multiple values rejected", [&]() {
+        ArgValue<std::vector<int>> values;
+        auto values_parser = argparse::ArgumentParser("tool", "Default providers", os);
+        try {
+            values_parser.add_argument(values, "--values").nargs('+').default_value([]() { return std::string("1"); });
+        } catch (const argparse::ArgParseError&) {
+            return true;
+        }
+        return false;
+    }());
+
+    parser.parse_args_throw({"--num_workers", "2", "--calibration", "file.cal", "--sites", "site_c"});
+    check("not called when specified", num_probes == 0 && num_reads == 0 && num_scans == 0 && num_workers == 2u
+                                       && sites.value() == std::vector<std::string>{"site_c"});
+    parser.reset_destinations();
+
+    parser.parse_args_throw({"--num_workers", "4"});
+    check("called when unspecified", num_probes == 0 && num_reads == 1 && num_scans == 1
+                                     && calibration.value() == "calibrated" && calibration.provenance() == argparse::Provenance::DEFAULT
+                                     && sites.value() == std::vector<std::string>{"site_a", "site_b"});
+    parser.reset_destinations();
+
+    parser.parse_args_throw({});
+    parser.reset_destinations();
+    parser.parse_args_throw({"--sites", "site_d"});
+    check("value kept", num_probes == 1 && num_reads == 1 && num_scans == 1 && num_workers == 8u
+                        && sites.value() == std::vector<std::string>{"site_d"});
+    parser.reset_destinations();
+
+    auto& help_arg = *parser.argument_groups()[0].arguments()[0];
+    ArgValue<int> unused;
+    auto help_parser = argparse::ArgumentParser("tool", "Default providers", os);
+    size_t num_help_calls = 0;
+    help_parser.add_argument(unused, "--unused").default_value([&]() {
+        ++num_help_calls;
+        return std::string("42");
+    });
+    check("deferred", help_arg.default_deferred() && num_help_calls == 0);
+
+    os.str("");
+    help_parser.print_help();
+    check("called by help", num_help_calls == 1 && os.str().find("(Default: 42)") != std::string::npos);
+
+    return num_failed;
+}
+
+int test_choice_providers() {
+    std::cout << "\n";
+
+    int num_failed = 0;
+    CheckReporter check("Choice providers", num_failed);
+
+    //A library of 50k sorted cell names
+    const size_t num_cells = 50000;
+    const std::string filename = "argparse_test_cells.txt";
+    {
+        std::ofstream os(filename);
+        char name[32];
+        for (size_t i = 0; i < num_cells; ++i) {
+            std::snprintf(name, sizeof(name), "cell_%05zu", i);
+            os << name << "\n";
+        }
+    }
+
+    ArgValue<std::string> cell;
+    ArgValue<std::vector<std::string>> cells;
+    auto cell_choices = std::make_shared<argparse::SortedFileChoices>(filename);
+
+    std::stringstream os;
+    auto parser = argparse::ArgumentParser("tool", "Choice providers", os);
+    parser.add_argument(cell, "--cell").choice_provider(cell_choices);
+    parser.add_argument(cells, "--cells").nargs('+').choice_provider(cell_choices);
+
+    parser.print_usage();
+    check("not loaded by usage", !cell_choices->loaded() && os.str().find("cell_00000") == std::string::npos
+                                 && os.str().find("[--cell CELL]") != std::string::npos);
+
+    check("first, middle and last", expect_pass(parser, {"--cell", "cell_00000"})
+                                    && expect_pass(parser, {"--cell", "cell_25000"})
+                                    && expect_pass(parser, {"--cells", "cell_49999", "cell_00001"}));
+    check("loaded on first validation", cell_choices->loaded());
+
+    check("invalid", expect_fail(parser, {"--cell", "cell_50000"}) && expect_fail(parser, {"--cell", "cell_0000"})
+                     && expect_fail(parser, {"--cell", "aaa"}) && expect_fail(parser, {"--cell", ""}));
+    check("not copied", parser.memory_usage().choices < 1000);
+
+    auto missing_parser = argparse::ArgumentParser("tool", "Choice providers", os);
+    missing_parser.add_argument(cell, "--cell")
+        .choice_provider(std::make_shared<argparse::SortedFileChoices>("argparse_test_missing.txt"));
+    check("missing file", expect_fail(missing_parser, {"--cell", "cell_00000"}));
+
+    //Lists of choices are still listed in full, however long
+    std::vector<std::string> many_choices;
+    for (size_t i = 0; i < 17; ++i) {
+        many_choices.push_back("c" + std::to_string(i));
+    }
+    ArgValue<std::string> choice;
+    auto list_parser = argparse::ArgumentParser("tool", "Choice providers", os);
+    list_parser.add_argument(choice, "--choice").choices(many_choices);
+    os.str("");
+    list_parser.print_help();
+    check("listed choices unchanged", os.str().find("--choice {" + argparse::join(many_choices, ", ") + "}") != std::string::npos);
+
+    std::remove(filename.c_str());
+    return num_failed;
+}
+
+int test_flag_sets() {
+    std::cout << "\n";
+
+    int num_failed = 0;
+    CheckReporter check("Flag sets", num_failed);
+
+    //Many feature flags
+    const size_t num_flags = 150;
+    const size_t no_cache = num_flags; //A flag disabling a feature
+    const size_t mode = num_flags + 1; //A flag with an explicit value
+
+    argparse::FlagSet flags(num_flags + 2);
+    std::stringstream os;
+    auto parser = argparse::ArgumentParser("tool", "Flag sets", os);
+    for (size_t i = 0; i < num_flags; ++i) {
+        parser.add_flag(flags, i, "--enable_feature_" + std::to_string(i))
+            .default_value("false");
+    }
+    parser.add_flag(flags, no_cache, "--no_cache")
+        .action(argparse::Action::STORE_FALSE)
+        .default_value("true");
+    parser.add_flag(flags, mode, "--mode", "-m")
+        .action(argparse::Action::STORE);
+
+    check("out of range", [&]() {
+        try {
+            parser.add_flag(flags, num_flags + 2, "--outside");
+        } catch (const argparse::ArgParseError&) {
+            return true;
+        }
+        return false;
+    }());
+
+    parser.parse_args_throw({"--enable_feature_3", "--enable_feature_70", "--no_cache", "-m", "true"});
+    check("values", flags.test(3) && flags[70] && !flags.test(4) && !flags.test(no_cache) && flags.test(mode));
+    check("provenance", flags.provenance(3) == argparse::Provenance::SPECIFIED && flags.specified(no_cache)
+                        && flags.provenance(4) == argparse::Provenance::DEFAULT);
+    check("words", flags.num_words() == 3 && flags.word(0) == (uint64_t(1) << 3) && flags.word(1) == (uint64_t(1) << (70 - 64))
+                   && flags.word(2) == (uint64_t(1) << (mode - 128)));
+    check("repeated value", expect_fail(parser, {"--mode", "true", "--mode", "false"}));
+    check("invalid value", expect_fail(parser, {"--mode", "maybe"}));
+
+    parser.reset_destinations();
+    check("reset", flags.word(0) == 0 && flags.word(2) == 0 && flags.provenance(3) == argparse::Provenance::UNSPECIFIED);
+
+    parser.parse_args_throw({});
+    check("defaults", !flags.test(3) && flags.test(no_cache) && !flags.test(mode)
+                      && flags.provenance(mode) == argparse::Provenance::UNSPECIFIED);
+    parser.reset_destinations();
+
+    //The same options with separate values
+    std::vector<ArgValue<bool>> values(num_flags);
+    auto values_parser = argparse::ArgumentParser("tool", "Flag sets", os);
+    for (size_t i = 0; i < num_flags; ++i) {
+        values_parser.add_argument(values[i], "--enable_feature_" + std::to_string(i))
+            .action(argparse::Action::STORE_TRUE)
+            .default_value("false");
+    }
+    values_parser.parse_args_throw({"--enable_feature_3"});
+    parser.parse_args_throw({"--enable_feature_3"});
+
+    size_t values_bytes = num_flags * sizeof(ArgValue<bool>) + values_parser.memory_usage().destinations;
+    size_t flags_bytes = sizeof(flags) + parser.memory_usage().destinations;
+    check("footprint (" + std::to_string(flags_bytes) + " vs. " + std::to_string(values_bytes) + " bytes)",
+          10 * flags_bytes < values_bytes);
+
+    return num_failed;
+}
+
+enum class Placement {
+    WIRELENGTH,
+    TIMING,
+    CONGESTION,
+    ROUTABILITY,
+    POWER
+};
+
+namespace argparse {
+    template<>
+    struct EnumTraits<Placement> {
+        static constexpr auto names() {
+            return enum_names<Placement>({{"wirelength", Placement::WIRELENGTH},
+                                          {"timing", Placement::TIMING},
+                                          {"congestion", Placement::CONGESTION},
+                                          {"routability", Placement::ROUTABILITY},
+                                          {"power", Placement::POWER}});
+        }
+    };
+}
+
+int test_enum_converter() {
+    using argparse::Phase;
+    std::cout << "\n";
+
+    int num_failed = 0;
+    CheckReporter check("Enum converter", num_failed);
+
+    auto total_allocations = []() {
+        size_t allocations = 0;
+        for (size_t iphase = 0; iphase < static_cast<size_t>(Phase::NUM_PHASES); ++iphase) {
+            allocations += argparse::alloc_counts(static_cast<Phase>(iphase)).allocations;
+        }
+        return allocations;
+    };
+
+    typedef argparse::EnumConverter<Placement> Converter;
+
+    const std::string timing_str = "timing";
+    const std::string power_str = "power";
+    const std::string invalid_str = "timin";
+
+    argparse::reset_alloc_counts();
+    Placement timing = Placement::WIRELENGTH;
+    Placement power = Placement::WIRELENGTH;
+    Placement invalid = Placement::WIRELENGTH;
+    bool converted = Converter().from_str(timing_str, timing) && Converter().from_str(power_str, power);
+    bool rejected = !Converter().from_str(argparse::StringView("routability_driven"), invalid);
+    auto choices = Converter().default_choices();
+    size_t allocations = total_allocations();
+
+    check("from_str", converted && rejected && timing == Placement::TIMING && power == Placement::POWER
+                      && Converter().from_str(power_str).value() == Placement::POWER);
+    check("invalid", !Converter().from_str(invalid_str).valid() && !Converter().from_str("").valid()
+                     && Converter().from_str(invalid_str).error() == "Unexpected value 'timin' (expected one of: wirelength, timing, congestion, routability, power)");
+    check("to_str", Converter().to_str(Placement::ROUTABILITY).value() == "routability"
+                    && !Converter().to_str(static_cast<Placement>(42)).valid());
+    check("default choices", choices.size() == 5 && std::string(*choices.begin()) == "wirelength");
+    if (argparse::alloc_counting_enabled()) {
+        check("no allocations (" + std::to_string(allocations) + ")", allocations == 0);
+    }
+
+    ArgValue<Placement> placement;
+    ArgValue<int> effort;
+    std::stringstream os;
+    auto parser = argparse::ArgumentParser("placer", "Enum converter", os);
+
+    //The names are not copied to the argument's choices
+    argparse::reset_alloc_counts();
+    parser.add_argument(effort, "--effort");
+    size_t int_allocations = total_allocations();
+    argparse::reset_alloc_counts();
+    parser.add_argument<Placement,Converter>(placement, "--placement");
+    size_t enum_allocations = total_allocations();
+    if (argparse::alloc_counting_enabled()) {
+        check("registration allocations (" + std::to_string(enum_allocations) + " vs " + std::to_string(int_allocations) + ")",
+              enum_allocations == int_allocations);
+    }
+    parser.argument_groups()[0].arguments()[1]->default_value("wirelength");
+
+    parser.parse_args_throw({"--placement", "congestion"});
+    check("parse", placement == Placement::CONGESTION);
+    parser.reset_destinations();
+    const auto& placement_arg = *parser.argument_groups()[0].arguments()[1];
+    check("choices", placement_arg.choices().empty() && placement_arg.choice_provider()->num_listed() == 5
+                     && placement_arg.describe_choices() == "one of: wirelength, timing, congestion, routability, power"
+                     && expect_fail(parser, {"--placement", "area"}));
+
+    parser.print_usage();
+    check("usage", os.str().find("{wirelength, timing, congestion, routability, power}") != std::string::npos);
+
+    return num_failed;
+}
+
+//Converts cell names ("cell_<index>") to their index with the StringView interface,
+//recording how many times an instance is re-used
+struct CellIndexConverter {
+    argparse::ConversionStatus from_str(argparse::StringView str, int& value) {
+        ++uses;
+        max_uses = std::max(max_uses, uses);
+
+        if (str.substr(0, 5) != "cell_" || !argparse::DefaultConverter<int>().from_str(str.substr(5), value)) {
+            return argparse::ConversionStatus::invalid("cell name");
+        }
+        return argparse::ConversionStatus();
+    }
+
+    ConvertedValue<std::string> to_str(int val) {
+        ConvertedValue<std::string> converted_value;
+        converted_value.set_value("cell_" + std::to_string(val));
+        return converted_value;
+    }
+
+    std::vector<std::string> default_choices() { return {}; }
+
+    size_t uses = 0;
+    static size_t max_uses;
+};
+size_t CellIndexConverter::max_uses = 0;
+
+int test_view_converters() {
+    using argparse::Phase;
+    using argparse::ResetMode;
+    std::cout << "\n";
+
+    int num_failed = 0;
+    CheckReporter check("View converters", num_failed);
+
+    check("detected", argparse::detail::is_view_converter<int,CellIndexConverter>::value
+                      && argparse::detail::is_view_converter<int,argparse::DefaultConverter<int>>::value
+                      && !argparse::detail::is_view_converter<int,CountingIntConverter>::value
+                      && !argparse::detail::is_view_converter<bool,OnOff>::value);
+
+    int index = 0;
+    auto status = CellIndexConverter().from_str("cell_x", index);
+    check("error message", !status && status.message("cell_x") == "Invalid conversion from 'cell_x' to cell name");
+    check("original interface", argparse::DefaultConverter<int>().from_str("12").value() == 12
+                                && argparse::DefaultConverter<bool>().from_str("maybe").error() == "Unexpected value 'maybe' (expected one of: true, false)");
+
+    ArgValue<int> cell;
+    ArgValue<std::vector<int>> cells;
+    ArgValue<int> count;
+    ArgValue<int> legacy_count;
+
+    std::stringstream os;
+    auto parser = argparse::ArgumentParser("view_test", "View converters", os);
+    parser.add_argument<int,CellIndexConverter>(cell, "--cell");
+    parser.add_argument<int,CellIndexConverter>(cells, "--cells")
+        .nargs('+');
+    parser.add_argument(count, "--count");
+    parser.add_argument<int,CountingIntConverter>(legacy_count, "--legacy_count");
+
+    CellIndexConverter::max_uses = 0;
+    parser.parse_args_throw({"--cell", "cell_7", "--cells", "cell_1", "cell_2", "cell_3"});
+    check("parse", cell == 7 && cells.value() == std::vector<int>{1, 2, 3});
+    check("converter re-used (" + std::to_string(CellIndexConverter::max_uses) + " uses)", CellIndexConverter::max_uses >= 3);
+    parser.reset_destinations();
+
+    check("invalid value", expect_fail(parser, {"--cell", "cell_x"}));
+
+    //Long strings are converted in place, where the original interface copies them
+    auto reparse_allocations = [&](std::vector<std::string> cmd_line) {
+        size_t allocations = 0;
+        for (size_t iter = 0; iter < 2; ++iter) {
+            //The first pass warms up
+            if (iter == 1) argparse::reset_alloc_counts();
+            parser.reset_destinations(ResetMode::KEEP_CAPACITY);
+            parser.parse_args_throw(cmd_line);
+        }
+        for (size_t iphase = 0; iphase < static_cast<size_t>(Phase::NUM_PHASES); ++iphase) {
+            allocations += argparse::alloc_counts(static_cast<Phase>(iphase)).allocations;
+        }
+        return allocations;
+    };
+
+    if (argparse::alloc_counting_enabled()) {
+        std::string long_cell = "cell_000000000000000000000042";
+        std::string long_count = "000000000000000000000042";
+        size_t view_allocations = reparse_allocations({"--cell", long_cell, "--cells", long_cell, long_cell, "--count", long_count});
+        size_t legacy_allocations = reparse_allocations({"--legacy_count", long_count});
+        check("views do not allocate (" + std::to_string(view_allocations) + ")", view_allocations == 0);
+        check("original interface copies (" + std::to_string(legacy_allocations) + ")", legacy_allocations > 0);
+        check("values", cell.provenance() == argparse::Provenance::UNSPECIFIED && legacy_count == 42);
+    }
+
+    return num_failed;
+}
+
+//A value written in hexadecimal, whose operator>> changes the stream's format
+struct HexValue {
+    int value = 0;
+};
+
+std::istream& operator>>(std::istream& is, HexValue& val);
+std::istream& operator>>(std::istream& is, HexValue& val) {
+    return is >> std::hex >> val.value;
+}
+
+int test_stream_format_state() {
+    std::cout << "\n";
+
+    int num_failed = 0;
+    CheckReporter check("Stream format state", num_failed);
+
+    ArgValue<HexValue> mask;
+    ArgValue<int> count;
+    ArgValue<std::vector<int>> seeds;
+
+    std::stringstream os;
+    auto parser = argparse::ArgumentParser("stream_test", "Stream format state", os);
+    parser.add_argument(mask, "--mask");
+    parser.add_argument(count, "--count");
+    parser.add_argument(seeds, "--seeds")
+        .nargs('+');
+
+    parser.parse_args_throw({"--mask", "ff", "--count", "10", "--seeds", "11", "12"});
+    check("hexadecimal value", mask.value().value == 255);
+    check("later conversions decimal", count == 10 && seeds.value() == std::vector<int>{11, 12});
+    parser.reset_destinations();
+
+    check("hexadecimal rejected", expect_fail(parser, {"--mask", "ff", "--count", "a"}));
+
+    return num_failed;
+}
+
+int test_numeric_locale() {
+    std::cout << "\n";
+
+    //Floating-point values always use '.' as the decimal point, even if the C locale does not
+    const char* comma_locales[] = {"de_DE.UTF-8", "de_DE.utf8", "fr_FR.UTF-8", "fr_FR.utf8", "nl_NL.UTF-8"};
+    const char* comma_locale = nullptr;
+    for (const char* name : comma_locales) {
+        if (std::setlocale(LC_NUMERIC, name)) {
+            comma_locale = name;
+            break;
+        }
+    }
+    if (!comma_locale) {
+        std::cout << "[SKIP] No locale with a decimal comma available" << std::endl;
+        return 0;
+    }
+
+    int num_failed = 0;
+    CheckReporter check("Numeric locale", num_failed);
+
+    ArgValue<float> utilization;
+    ArgValue<double> period;
+    ArgValue<long double> scale;
+
+    std::stringstream os;
+    auto parser = argparse::ArgumentParser("locale_test", "Numeric locale", os);
+    parser.add_argument(utilization, "--utilization");
+    parser.add_argument(period, "--period");
+    parser.add_argument(scale, "--scale");
+
+    parser.parse_args_throw({"--utilization", "0.5", "--period", "2.5", "--scale", "1.25"});
+    check(std::string("decimal point in ") + comma_locale, utilization == 0.5f && period == 2.5 && scale == 1.25L);
+    parser.reset_destinations();
+
+    check("decimal comma rejected", expect_fail(parser, {"--period", "2,5"}));
+
+    std::setlocale(LC_NUMERIC, "C");
+    return num_failed;
+}
@@ -1,29 +1,107 @@
 #include <algorithm>
 #include <array>
-#include <list>
 #include <cassert>
 #include <string>
-#include <set>
+#include <sstream>
+#include <limits>
+#include <unordered_map>
 
 #include "argparse.hpp"
 #include "argparse_util.hpp"
 
 namespace argparse {
 
+    namespace {
+        //Inferred values' indices, sorted by the address of their destinations
+        typedef std::vector<std::pair<const ArgValueBase*,size_t>> InferredLookup;
+
+        enum class VisitState : char { UNVISITED, VISITING, VISITED };
+
+        //Depth-first search of the inferred values which inferred[i] depends on.
+        //Reaching a value still being visited means there is a cycle, which is reported along path
+        void visit_inferred(size_t i, const std::vector<std::unique_ptr<InferredValue>>& inferred, const InferredLookup& lookup,
+                            std::vector<VisitState>& states, std::vector<size_t>& path) {
+            path.push_back(i);
+            if (states[i] == VisitState::VISITING) {
+                auto cycle_begin = std::find(path.begin(), path.end(), i);
+                std::string msg = "Inferred values have a circular dependency: ";
+                for (auto iter = cycle_begin; iter != path.end(); ++iter) {
+                    if (iter != cycle_begin) msg += " -> ";
+                    msg += inferred[*iter]->name();
+                }
+                throw ArgParseError(msg);
+            }
+
+            if (states[i] == VisitState::UNVISITED) {
+                states[i] = VisitState::VISITING;
+                for (const auto& input : inferred[i]->inputs()) {
+                    auto key = std::make_pair(&input->value(), size_t(0));
+                    auto iter = std::lower_bound(lookup.begin(), lookup.end(), key);
+                    if (iter != lookup.end() && iter->first == key.first) {
+                        visit_inferred(iter->second, inferred, lookup, states, path);
+                    }
+                }
+                states[i] = VisitState::VISITED;
+            }
+            path.pop_back();
+        }
+
+        //Sets arg's destination to its default value
+        void set_default(Argument& arg) {
+            TraceSpan span(ParseTrace::EventType::DEFAULT);
+            if (span) {
+                span.set_argument(&arg);
+                span.set_text(arg.default_value());
+            }
+
+            arg.set_dest_to_default();
+        }
+
+        //Returns the names of subcommands (see ArgumentParser::subcommands())
+        std::vector<std::string> subcommand_names(const std::vector<std::pair<std::string,std::string>>& subcommands) {
+            std::vector<std::string> names;
+            for (const auto& subcommand : subcommands) {
+                names.push_back(subcommand.first);
+            }
+            return names;
+        }
+    }
 
     /*
      * ArgumentParser
      */
+    struct ArgumentParser::OptionRegistry {
+        std::unordered_map<std::string,size_t> option_groups; //Option string to group index
+        std::vector<size_t> num_registered; //Number of arguments registered from each group
+    };
 
-    ArgumentParser::ArgumentParser(std::string prog_name, std::string description_str, std::ostream& os)
+    ArgumentParser::ArgumentParser(std::string prog_name, std::string description_str)
+        : ArgumentParser(prog_name, description_str, stdout_sink())
+        {}
+
+    ArgumentParser::ArgumentParser(std::string prog_name, std::string description_str, OutputSink& sink)
         : description_(description_str)
         , formatter_(new DefaultFormatter())
-        , os_(os)
+        , sink_(&sink)
+        , option_registry_(new OptionRegistry())
         {
         prog(prog_name);
         argument_groups_.push_back(ArgumentGroup("arguments"));
     }
 
+#ifndef ARGPARSE_NO_IOSTREAM
+    ArgumentParser::ArgumentParser(std::string prog_name, std::string description_str, std::ostream& os)
+        : ArgumentParser(prog_name, description_str, stdout_sink())
+        {
+        owned_sink_.reset(new OstreamOutputSink(os));
+        sink_ = owned_sink_.get();
+    }
+#endif
+
+    ArgumentParser::ArgumentParser(ArgumentParser&&) = default;
+    ArgumentParser& ArgumentParser::operator=(ArgumentParser&&) = default;
+    ArgumentParser::~ArgumentParser() = default;
+
     ArgumentParser& ArgumentParser::prog(std::string prog_name, bool basename_only) {
         if (basename_only) {
             prog_ = basename(prog_name);
@@ -43,81 +121,149 @@ namespace argparse {
         return *this;
     }
 
+    ArgumentParser& ArgumentParser::enable_trace(bool enable) {
+        trace_enabled_ = enable;
+        if (!enable) {
+            trace_.clear();
+        }
+        return *this;
+    }
+
+    Argument& ArgumentParser::add_flag(FlagSet& dest, size_t flag, std::string long_opt, std::string short_opt) {
+        return argument_groups_[0].add_flag(dest, flag, long_opt, short_opt);
+    }
+
     ArgumentGroup& ArgumentParser::add_argument_group(std::string description_str) {
         argument_groups_.push_back(ArgumentGroup(description_str));
         return argument_groups_[argument_groups_.size() - 1];
     }
 
+    ArgumentParser& ArgumentParser::add_parent(const ArgumentParser& parent) {
+        for (const auto& parent_group : parent.argument_groups_) {
+            const auto& parent_args = parent_group.arguments();
+            bool has_help = std::any_of(parent_args.begin(), parent_args.end(),
+                                        [](const std::shared_ptr<Argument>& arg) { return arg->action() == Action::HELP; });
+
+            auto iter = std::find_if(argument_groups_.begin(), argument_groups_.end(),
+                                     [&](const ArgumentGroup& group) { return group.name() == parent_group.name(); });
+            if (iter == argument_groups_.end()) {
+                argument_groups_.push_back(ArgumentGroup(parent_group.name()));
+                iter = argument_groups_.end() - 1;
+            }
+
+            if (!has_help && iter->arguments().empty() && iter->constraints().empty() && iter->epilog().empty()) {
+                //Share the parent's definition of the group
+                iter->share(parent_group);
+            } else {
+                //Append the parent's arguments (the Argument objects are still shared) and constraints
+                auto& data = iter->mutable_data();
+                for (const auto& arg : parent_args) {
+                    if (arg->action() == Action::HELP) continue;
+                    data.arguments.push_back(arg);
+                }
+                data.constraints.insert(data.constraints.end(), parent_group.constraints().begin(), parent_group.constraints().end());
+            }
+        }
+        return *this;
+    }
+
+    ArgumentParser& ArgumentParser::mutually_exclusive(std::vector<std::string> args) {
+        argument_groups_[0].mutually_exclusive(args);
+        return *this;
+    }
+
+    ArgumentParser& ArgumentParser::at_least_one_of(std::vector<std::string> args) {
+        argument_groups_[0].at_least_one_of(args);
+        return *this;
+    }
+
+    ArgumentParser& ArgumentParser::requires_all(std::string arg, std::vector<std::string> required_args) {
+        argument_groups_[0].requires_all(arg, required_args);
+        return *this;
+    }
+
+    ArgumentParser& ArgumentParser::conflicts_with(std::string arg, std::vector<std::string> conflicting_args) {
+        argument_groups_[0].conflicts_with(arg, conflicting_args);
+        return *this;
+    }
+
     void ArgumentParser::parse_args(int argc, const char* const* argv, int error_exit_code, int help_exit_code, int version_exit_code) {
         try {
             parse_args_throw(argc, argv);
         } catch (const argparse::ArgParseHelp&) {
             //Help requested
-            print_help();
+            active_parser().print_help();
+            sink_->flush();
             std::exit(help_exit_code);
         } catch (const argparse::ArgParseVersion&) {
-            print_version();
+            active_parser().print_version();
+            sink_->flush();
             std::exit(version_exit_code);
         } catch (const argparse::ArgParseError& e) {
             //Failed to parse
-            std::cout << e.what() << "\n";
-
-            std::cout << "\n";
-            print_usage();
+            sink_->write(e.what());
+            sink_->write("\n\n", 2);
+            active_parser().print_usage();
+            sink_->flush();
             std::exit(error_exit_code);
         }
     }
 
     void ArgumentParser::parse_args_throw(int argc, const char* const* argv) {
-        std::vector<std::string> arg_strs;
+        //Assign into the previous parse's strings, re-using their capacity
+        argv_strs_.resize(argc > 1 ? argc - 1 : 0);
         for (int i = 1; i < argc; ++i) {
-            arg_strs.push_back(argv[i]);
+            argv_strs_[i - 1] = argv[i];
         }
 
-        parse_args_throw(arg_strs);
+        parse_args_throw(argv_strs_);
     }
     
-    void ArgumentParser::parse_args_throw(std::vector<std::string> arg_strs) {
-        add_help_option_if_unspecified();
+    void ArgumentParser::parse_args_throw(const std::vector<std::string>& arg_strs) {
+        StatsScope stats_scope(stats_);
 
-        //Reset all the defaults
-        for (const auto& group : argument_groups()) {
-            for (const auto& arg : group.arguments()) {
-                if (arg->default_set()) {
-                    arg->set_dest_to_default();
-                }
-            }
+        //The trace records the most recent parse
+        if (trace_enabled_) {
+            trace_.clear();
         }
+        TraceScope trace_scope(trace_enabled_ ? &trace_ : nullptr);
 
-        //Create a look-up of expected argument strings and positional arguments
-        std::map<std::string,std::shared_ptr<Argument>> str_to_option_arg;
-        std::list<std::shared_ptr<Argument>> positional_args;
-        for (const auto& group : argument_groups()) {
-            for (const auto& arg : group.arguments()) {
-                if (arg->positional()) {
-                    positional_args.push_back(arg);
-                } else {
-                    for (const auto& opt : {arg->long_option(), arg->short_option()}) {
-                        if (opt.empty()) continue;
+        if (!frozen()) {
+            freeze();
+        }
 
-                        auto ret = str_to_option_arg.insert(std::make_pair(opt, arg));
+        //Inferred values are re-checked when next read, as their inputs may change
+        invalidate_inferred();
 
-                        if (!ret.second) {
-                            //Option string already specified
-                            std::stringstream ss;
-                            ss << "Option string '" << opt << "' maps to multiple options";
-                            throw ArgParseError(ss.str());
-                        }
+        {
+            PhaseScope phase(Phase::DEFAULTS);
+
+            //Reset all the defaults (except those from providers, which are only computed if needed)
+            for (const auto& group : argument_groups_) {
+                for (const auto& arg : group.arguments()) {
+                    if (arg->default_set() && !arg->default_deferred()) {
+                        set_default(*arg);
                     }
                 }
             }
         }
 
-        std::set<std::shared_ptr<Argument>> specified_arguments;
+        PhaseScope phase(Phase::PARSE);
+
+        size_t next_positional = 0;
+        size_t subcommand_token = arg_strs.size();
+
+        specified_arguments_.clear();
+        subcommand_selected_ = false;
 
         //Process the arguments
         for (size_t i = 0; i < arg_strs.size(); i++) {
-            ShortArgInfo short_arg_info = no_space_short_arg(arg_strs[i], str_to_option_arg);
+            ARGPARSE_STATS(detail::record_token());
+
+            TraceSpan token_span(ParseTrace::EventType::TOKEN, i);
+            token_span.set_text(arg_strs[i]);
+
+            ShortArgInfo short_arg_info = no_space_short_arg(arg_strs[i]);
 
             std::shared_ptr<Argument> arg;
 
@@ -125,16 +271,16 @@ namespace argparse {
                 //Short argument with no space between value
                 arg = short_arg_info.arg;
             } else { //Full argument
-                auto iter = str_to_option_arg.find(arg_strs[i]);
-                if (iter != str_to_option_arg.end()) {
-                    arg = iter->second;
-                }
+                ARGPARSE_STATS(detail::record_option_lookup());
+                arg = find_option(arg_strs[i]);
             }
 
             if (arg) {
                 //Start of an argument
+                token_span.set_argument(arg.get());
+                token_span.set_token_kind(short_arg_info.is_no_space_short_arg ? TokenKind::OPTION_WITH_VALUE : TokenKind::OPTION);
 
-                specified_arguments.insert(arg);
+                specified_arguments_.push_back(arg.get());
 
                 if (arg->action() == Action::STORE_TRUE) {
                     arg->set_dest_to_true(); 
@@ -146,8 +292,19 @@ namespace argparse {
                 } else if (arg->action() == Action::VERSION) {
                     arg->set_dest_to_true(); 
                     throw ArgParseVersion();
+                } else if (arg->action() == Action::COUNT) {
+                    size_t count = 1;
+                    if (short_arg_info.is_no_space_short_arg) {
+                        //Repeated short option (e.g. -vvv)
+                        const auto& repeats = short_arg_info.value;
+                        if (repeats.find_first_not_of(arg_strs[i][1]) != std::string::npos) {
+                            throw ArgParseError("Unexpected value '" + repeats + "' for counted option " + arg->name());
+                        }
+                        count += repeats.size();
+                    }
+                    arg->increment_dest(count);
                 } else {
-                    assert(arg->action() == Action::STORE);
+                    assert(arg->action() == Action::STORE || arg->action() == Action::APPEND || arg->action() == Action::EXTEND);
 
 
                     size_t max_values_to_read = 0;
@@ -167,12 +324,14 @@ namespace argparse {
                         min_values_to_read = 1;
                     }
 
-                    std::vector<std::string> values;
+                    //The values are referred to in place (in arg_strs or short_arg_info)
+                    auto& values = values_;
+                    values.clear();
                     size_t nargs_read = 0;
                     if (short_arg_info.is_no_space_short_arg) {
                         //It is a short argument, we already have the first value
                         if (!short_arg_info.value.empty()) {
-                            values.push_back(short_arg_info.value);
+                            values.push_back(&short_arg_info.value);
                             ++nargs_read;
                         }
                     }
@@ -181,14 +340,22 @@ namespace argparse {
                         if (next_idx >= arg_strs.size()) {
                             break;
                         }
-                        std::string str = arg_strs[next_idx];
+                        const std::string& str = arg_strs[next_idx];
 
-
-                        if (is_argument(str, str_to_option_arg)) break;
+                        ARGPARSE_STATS(detail::record_token());
+                        ARGPARSE_STATS(detail::record_option_lookup());
+                        if (is_argument(str)) break;
 
                         if (!arg->is_valid_value(str)) break;
 
-                        values.push_back(str);
+                        TraceSpan value_span(ParseTrace::EventType::TOKEN, next_idx);
+                        if (value_span) {
+                            value_span.set_text(str);
+                            value_span.set_argument(arg.get());
+                            value_span.set_token_kind(TokenKind::VALUE);
+                        }
+
+                        values.push_back(&str);
                     }
 
                     if (nargs_read < min_values_to_read) {
@@ -211,23 +378,23 @@ namespace argparse {
                     }
                     assert (nargs_read <= max_values_to_read);
 
-                    for (const auto& val : values) {
-                        if (!is_valid_choice(val, arg->choices())) {
+                    for (const std::string* val : values) {
+                        if (!arg->is_valid_choice(*val)) {
                             std::stringstream msg;
-                            msg << "Unexpected option value '" << values[0] << "' (expected one of: " << join(arg->choices(), ", ");
+                            msg << "Unexpected option value '" << *values[0] << "' (expected " << arg->describe_choices();
                             msg << ") for " << arg->name();
                             throw ArgParseError(msg.str());
                         }
                     }
 
                     //Set the option values appropriately
-                    if (arg->nargs() == '1') {
+                    if (arg->nargs() == '1' && arg->action() == Action::STORE) {
                         assert(nargs_read == 1);
                         assert(values.size() == 1);
 
 
                         try {
-                            arg->set_dest_to_value(values[0]); 
+                            arg->set_dest_to_value(*values[0]);
                         } catch (const ArgParseConversionError& e) {
                             std::stringstream msg;
                             msg << e.what() << " for " << arg->long_option();
@@ -237,15 +404,16 @@ namespace argparse {
                             }
                             throw ArgParseConversionError(msg.str());
                         }
-                    } else if (arg->nargs() == '+' || arg->nargs() == '*') {
+                    } else if (arg->nargs() == '1' || arg->nargs() == '+' || arg->nargs() == '*') {
+                        //Multiple values, or an APPEND occurrence
                         if (arg->nargs() == '+') {
                             assert(nargs_read >= 1);
                             assert(values.size() >= 1);
                         }
 
-                        for (const auto& value : values) {
+                        for (const std::string* value : values) {
                             try {
-                                arg->add_value_to_dest(value); 
+                                arg->add_value_to_dest(*value);
                             } catch (const ArgParseConversionError& e) {
                                 std::stringstream msg;
                                 msg << e.what() << " for " << arg->long_option();
@@ -268,15 +436,25 @@ namespace argparse {
                 }
 
             } else {
-                if (positional_args.empty()) {
+                if (next_positional == positional_args_.size() && !subcommands_.empty()) {
+                    //The subcommand's parser parses the remaining tokens (once this parser's are checked)
+                    token_span.set_token_kind(TokenKind::SUBCOMMAND);
+                    subcommand_token = i;
+                    break;
+                } else if (next_positional == positional_args_.size()) {
                     //Unrecognized
+                    token_span.set_token_kind(TokenKind::UNRECOGNIZED);
+
                     std::stringstream ss;
                     ss << "Unexpected command-line argument '" << arg_strs[i] << "'";
                     throw ArgParseError(ss.str());
                 } else {
                     //Positional argument
-                    auto pos_arg = positional_args.front();
-                    positional_args.pop_front();
+                    auto pos_arg = positional_args_[next_positional];
+                    ++next_positional;
+
+                    token_span.set_argument(pos_arg.get());
+                    token_span.set_token_kind(TokenKind::POSITIONAL);
 
                     try {
                         pos_arg->set_dest_to_value(arg_strs[i]); 
@@ -286,62 +464,180 @@ namespace argparse {
                         throw ArgParseConversionError(msg.str());
                     }
 
-                    auto value = arg_strs[i];
-                    specified_arguments.insert(pos_arg);
+                    specified_arguments_.push_back(pos_arg.get());
                 }
             }
         }
 
         //Missing positionals?
-        for(const auto& remaining_positional : positional_args) {
+        if (next_positional < positional_args_.size()) {
             std::stringstream ss;
-            ss << "Missing required positional argument: " << remaining_positional->long_option();
+            ss << "Missing required positional argument: " << positional_args_[next_positional]->long_option();
             throw ArgParseError(ss.str());
         }
 
-        //Missing required?
-        for (const auto& group : argument_groups()) {
+        //Missing required, or violated constraints?
+        specified_set_.clear();
+        for (const Argument* arg : specified_arguments_) {
+            auto iter = std::lower_bound(argument_indices_.begin(), argument_indices_.end(), std::make_pair(arg, size_t(0)));
+            assert(iter != argument_indices_.end() && iter->first == arg);
+            specified_set_.insert(iter->second);
+        }
+        check_constraints();
+
+        {
+            PhaseScope defaults_phase(Phase::DEFAULTS);
+
+            //Compute the defaults from providers of unspecified arguments (the arguments are indexed in this order)
+            size_t iarg = 0;
+            for (const auto& group : argument_groups_) {
+                for (const auto& arg : group.arguments()) {
+                    if (arg->default_deferred() && !specified_set_.contains(iarg)) {
+                        set_default(*arg);
+                    }
+                    ++iarg;
+                }
+            }
+        }
+
+        if (!subcommands_.empty()) {
+            if (subcommand_token == arg_strs.size()) {
+                throw ArgParseError("Missing required subcommand (expected one of: " + join(subcommand_names(subcommands()), ", ") + ")");
+            }
+
+            const std::string& name = arg_strs[subcommand_token];
+            size_t index = find_subcommand(name);
+            if (index == subcommands_.size()) {
+                throw ArgParseError("Unknown subcommand '" + name + "' (expected one of: " + join(subcommand_names(subcommands()), ", ") + ")");
+            }
+
+            ArgumentParser& parser = build_subcommand(index);
+            subcommand_selected_ = true;
+            selected_subcommand_ = index;
+
+            parser.argv_strs_.assign(arg_strs.begin() + subcommand_token + 1, arg_strs.end());
+            parser.parse_args_throw(parser.argv_strs_);
+        }
+    }
+
+    void ArgumentParser::freeze() {
+        StatsScope stats_scope(stats_);
+        PhaseScope phase(Phase::FREEZE);
+
+        add_help_option_if_unspecified();
+
+        //Create a look-up of expected argument strings and positional arguments
+        str_to_option_arg_.clear();
+        positional_args_.clear();
+        frozen_ = false;
+        for (const auto& group : argument_groups_) {
             for (const auto& arg : group.arguments()) {
-                if (arg->required()) {
-                    //potentially slow...
-                    if (!specified_arguments.count(arg)) {
-                        std::stringstream msg;
-                        msg << "Missing required argument: " << arg->long_option();
-                        auto short_opt = arg->short_option();
-                        if (!short_opt.empty()) {
-                            msg << "/" << short_opt;
-                        }
-                        throw ArgParseError(msg.str());
+                if (arg->positional()) {
+                    positional_args_.push_back(arg);
+                } else {
+                    for (const auto& opt : {arg->long_option(), arg->short_option()}) {
+                        if (opt.empty()) continue;
+
+                        str_to_option_arg_.emplace_back(opt, arg);
                     }
                 }
             }
         }
+
+        //Sort for binary search, keeping registration order among equal option strings
+        std::stable_sort(str_to_option_arg_.begin(), str_to_option_arg_.end(),
+                         [](const std::pair<std::string,std::shared_ptr<Argument>>& lhs, const std::pair<std::string,std::shared_ptr<Argument>>& rhs) {
+                             return lhs.first < rhs.first;
+                         });
+
+        for (size_t i = 1; i < str_to_option_arg_.size(); ++i) {
+            if (str_to_option_arg_[i].first == str_to_option_arg_[i - 1].first) {
+                //Option string already specified
+                std::stringstream ss;
+                ss << "Option string '" << str_to_option_arg_[i].first << "' maps to multiple options";
+                throw ArgParseError(ss.str());
+            }
+        }
+
+        check_inferred_dependencies();
+        compile_constraints();
+
+        frozen_num_arguments_ = num_arguments();
+        frozen_num_inferred_ = inferred_values_.size();
+        frozen_num_constraints_ = num_constraints();
+        frozen_ = true;
     }
 
-    void ArgumentParser::reset_destinations() {
-        for (const auto& group : argument_groups()) {
+    void ArgumentParser::reset_destinations(ResetMode mode) {
+        for (const auto& group : argument_groups_) {
             for (const auto& arg : group.arguments()) {
-                arg->reset_dest();
+                arg->reset_dest(mode);
+            }
+        }
+        invalidate_inferred();
+
+        for (const auto& subcommand : subcommands_) {
+            if (subcommand.parser) {
+                subcommand.parser->reset_destinations(mode);
             }
         }
     }
 
+    void ArgumentParser::validate() {
+        StatsScope stats_scope(stats_);
+        TraceScope trace_scope(trace_enabled_ ? &trace_ : nullptr);
+        PhaseScope phase(Phase::PARSE);
+
+        for (const auto& group : argument_groups_) {
+            for (const auto& arg : group.arguments()) {
+                arg->resolve_dest();
+            }
+        }
+
+        for (const auto& inferred : inferred_values_) {
+            inferred->dest().resolve_pending();
+        }
+    }
+
+    void ArgumentParser::invalidate_inferred() {
+        for (const auto& inferred : inferred_values_) {
+            inferred->invalidate();
+        }
+    }
+
     void ArgumentParser::print_usage() {
+        StatsScope stats_scope(stats_);
+        TraceScope trace_scope(trace_enabled_ ? &trace_ : nullptr);
+        PhaseScope phase(Phase::FORMAT);
         formatter_->set_parser(this);
-        os_ << formatter_->format_usage();
+        sink_->write(formatter_->format_usage());
     }
 
     void ArgumentParser::print_help() {
+        StatsScope stats_scope(stats_);
+        TraceScope trace_scope(trace_enabled_ ? &trace_ : nullptr);
+        PhaseScope phase(Phase::FORMAT);
         formatter_->set_parser(this);
-        os_ << formatter_->format_usage();
-        os_ << formatter_->format_description();
-        os_ << formatter_->format_arguments();
-        os_ << formatter_->format_epilog();
+        sink_->write(formatter_->format_usage());
+        sink_->write(formatter_->format_description());
+        sink_->write(formatter_->format_arguments());
+        sink_->write(formatter_->format_epilog());
+    }
+
+    void ArgumentParser::print_full_help() {
+        print_help();
+        for (size_t i = 0; i < subcommands_.size(); ++i) {
+            sink_->write("\n", 1);
+            build_subcommand(i).print_full_help();
+        }
     }
 
     void ArgumentParser::print_version() {
+        StatsScope stats_scope(stats_);
+        TraceScope trace_scope(trace_enabled_ ? &trace_ : nullptr);
+        PhaseScope phase(Phase::FORMAT);
         formatter_->set_parser(this);
-        os_ << formatter_->format_version();
+        sink_->write(formatter_->format_version());
     }
 
     std::string ArgumentParser::prog() const { return prog_; }
@@ -349,6 +645,70 @@ namespace argparse {
     std::string ArgumentParser::description() const { return description_; }
     std::string ArgumentParser::epilog() const { return epilog_; }
     std::vector<ArgumentGroup> ArgumentParser::argument_groups() const { return argument_groups_; }
+    const ParseStats& ArgumentParser::stats() const { return stats_; }
+    const ParseTrace& ArgumentParser::trace() const { return trace_; }
+
+    std::vector<std::pair<std::string,std::string>> ArgumentParser::subcommands() const {
+        std::vector<std::pair<std::string,std::string>> names_and_help;
+        for (const auto& subcommand : subcommands_) {
+            names_and_help.emplace_back(subcommand.name, subcommand.help);
+        }
+        return names_and_help;
+    }
+
+    const std::string& ArgumentParser::subcommand() const {
+        static const std::string none;
+        if (!subcommand_selected_) return none;
+        return subcommands_[selected_subcommand_].name;
+    }
+
+    ArgumentParser& ArgumentParser::subcommand_parser(const std::string& name) {
+        size_t index = find_subcommand(name);
+        if (index == subcommands_.size()) {
+            throw ArgParseError("Unknown subcommand '" + name + "'");
+        }
+        return build_subcommand(index);
+    }
+
+    MemoryUsage ArgumentParser::memory_usage() const {
+        MemoryUsage usage;
+
+        usage.other += sizeof(*this) + trace_.memory_usage();
+        usage.other += stats_.converter_conversions.size() * tree_node_bytes<decltype(stats_.converter_conversions)::value_type>();
+
+        usage.strings += heap_bytes(prog_) + heap_bytes(description_) + heap_bytes(epilog_) + heap_bytes(version_);
+
+        usage.argument_objects += argument_groups_.capacity() * sizeof(ArgumentGroup);
+        for (const auto& group : argument_groups_) {
+            const auto& data = *group.data_;
+            usage.strings += heap_bytes(data.name) + heap_bytes(data.epilog) + heap_bytes(data.module_name);
+            usage.argument_objects += data.arguments.capacity() * sizeof(std::shared_ptr<Argument>);
+
+            for (const auto& arg : data.arguments) {
+                arg->add_memory_usage(usage);
+            }
+        }
+
+        usage.lookup_tables += str_to_option_arg_.capacity() * sizeof(decltype(str_to_option_arg_)::value_type);
+        for (const auto& kv : str_to_option_arg_) {
+            usage.lookup_tables += heap_bytes(kv.first);
+        }
+        usage.lookup_tables += positional_args_.capacity() * sizeof(std::shared_ptr<Argument>);
+
+        usage.formatter_caches += formatter_->memory_usage();
+
+        usage.argument_objects += subcommands_.capacity() * sizeof(Subcommand);
+        usage.lookup_tables += sorted_subcommands_.capacity() * sizeof(size_t);
+        for (const auto& subcommand : subcommands_) {
+            usage.strings += heap_bytes(subcommand.name) + heap_bytes(subcommand.help);
+            if (subcommand.parser) {
+                usage += subcommand.parser->memory_usage();
+            }
+        }
+
+        return usage;
+    }
+    void ArgumentParser::reset_stats() { stats_ = ParseStats(); }
 
     void ArgumentParser::add_help_option_if_unspecified() {
         //Has a help already been specified
@@ -372,32 +732,223 @@ namespace argparse {
         }
     }
 
-    ArgumentParser::ShortArgInfo ArgumentParser::no_space_short_arg(std::string str, const std::map<std::string, std::shared_ptr<Argument>>& str_to_option_arg) const {
+    bool ArgumentParser::frozen() const {
+        //Arguments can only be added (not removed), so a change in
+        //the number of arguments means the tables are stale
+        return frozen_ && frozen_num_arguments_ == num_arguments()
+               && frozen_num_inferred_ == inferred_values_.size()
+               && frozen_num_constraints_ == num_constraints();
+    }
 
-        ShortArgInfo short_arg_info;
-        for(const auto& kv : str_to_option_arg) {
-            if (kv.first.size() == 2) {
-                //Is a short arg
-                
-                //String starts with short arg
-                bool match = true;
-                for (size_t i = 0; i < kv.first.size(); ++i) {
-                    if (kv.first[i] != str[i]) {
-                        match = false;
-                        break;
+    size_t ArgumentParser::num_arguments() const {
+        size_t num_args = 0;
+        for (const auto& group : argument_groups_) {
+            num_args += group.arguments().size();
+        }
+        return num_args;
+    }
+
+    void ArgumentParser::register_options() {
+        auto& registry = *option_registry_;
+        registry.num_registered.resize(argument_groups_.size(), 0);
+
+        for (size_t igroup = 0; igroup < argument_groups_.size(); ++igroup) {
+            const auto& args = argument_groups_[igroup].arguments();
+            for (size_t& iarg = registry.num_registered[igroup]; iarg < args.size(); ++iarg) {
+                const auto& arg = args[iarg];
+                if (arg->positional()) continue;
+
+                for (const auto& opt : {arg->long_option(), arg->short_option()}) {
+                    if (opt.empty()) continue;
+
+                    auto result = registry.option_groups.emplace(opt, igroup);
+                    if (result.second) continue;
+
+                    std::string msg = "Option '" + opt + "' of " + describe_group(igroup)
+                                      + " conflicts with " + describe_group(result.first->second);
+
+                    bool last_group = (igroup + 1 == argument_groups_.size());
+                    if (last_group && !argument_groups_[igroup].module_name().empty()) {
+                        //Remove the conflicting module, so the parser remains usable
+                        for (auto iter = registry.option_groups.begin(); iter != registry.option_groups.end();) {
+                            if (iter->second == igroup) {
+                                iter = registry.option_groups.erase(iter);
+                            } else {
+                                ++iter;
+                            }
+                        }
+                        registry.num_registered.pop_back();
+                        argument_groups_.pop_back();
+                    }
+                    throw ArgParseError(msg);
+                }
+            }
+        }
+    }
+
+    std::string ArgumentParser::describe_group(size_t group_index) const {
+        const auto& group = argument_groups_[group_index];
+        if (!group.module_name().empty()) {
+            return "module '" + group.module_name() + "'";
+        }
+        return "argument group '" + group.name() + "'";
+    }
+
+    size_t ArgumentParser::num_constraints() const {
+        size_t num = 0;
+        for (const auto& group : argument_groups_) {
+            num += group.constraints().size();
+        }
+        return num;
+    }
+
+    size_t ArgumentParser::constraint_argument_index(const std::string& str) const {
+        const Argument* arg = find_option(str).get();
+        if (!arg) {
+            auto iter = std::find_if(positional_args_.begin(), positional_args_.end(),
+                                     [&](const std::shared_ptr<Argument>& pos_arg) { return pos_arg->long_option() == str; });
+            if (iter != positional_args_.end()) {
+                arg = iter->get();
+            }
+        }
+        if (!arg) {
+            throw ArgParseError("Constraint refers to unknown argument '" + str + "'");
+        }
+
+        auto iter = std::lower_bound(argument_indices_.begin(), argument_indices_.end(), std::make_pair(arg, size_t(0)));
+        assert(iter != argument_indices_.end() && iter->first == arg);
+        return iter->second;
+    }
+
+    void ArgumentParser::compile_constraints() {
+        //Index the arguments in registration order
+        indexed_arguments_.clear();
+        argument_indices_.clear();
+        indexed_arguments_.reserve(num_arguments());
+        argument_indices_.reserve(num_arguments());
+        for (const auto& group : argument_groups_) {
+            for (const auto& arg : group.arguments()) {
+                argument_indices_.emplace_back(arg.get(), indexed_arguments_.size());
+                indexed_arguments_.push_back(arg.get());
+            }
+        }
+        std::sort(argument_indices_.begin(), argument_indices_.end());
+
+        size_t num_args = indexed_arguments_.size();
+        specified_set_.resize(num_args);
+
+        required_set_.resize(num_args);
+        for (size_t i = 0; i < num_args; ++i) {
+            if (indexed_arguments_[i]->required()) {
+                required_set_.insert(i);
+            }
+        }
+
+        constraints_.clear();
+        for (const auto& group : argument_groups_) {
+            for (const auto& constraint : group.constraints()) {
+                CompiledConstraint compiled;
+                compiled.kind = constraint.kind;
+                compiled.subject = 0;
+                compiled.arguments.resize(num_args);
+
+                if (constraint.kind == ArgumentConstraint::Kind::REQUIRES
+                    || constraint.kind == ArgumentConstraint::Kind::CONFLICTS) {
+                    compiled.subject = constraint_argument_index(constraint.subject);
+                }
+
+                if (constraint.arguments.empty()) {
+                    for (const auto& arg : group.arguments()) {
+                        compiled.arguments.insert(constraint_argument_index(arg->long_option()));
+                    }
+                } else {
+                    for (const auto& arg_str : constraint.arguments) {
+                        compiled.arguments.insert(constraint_argument_index(arg_str));
                     }
                 }
 
-                bool no_space_between_short_arg_and_value = str.size() > kv.first.size();
+                constraints_.push_back(std::move(compiled));
+            }
+        }
+    }
+
+    void ArgumentParser::check_constraints() const {
+        //Returns the names of the arguments in both set and other
+        auto common_names = [&](const detail::ArgumentSet& set, const detail::ArgumentSet& other, bool in_other) {
+            std::vector<std::string> names;
+            for (size_t i = 0; i < set.size(); ++i) {
+                if (set.contains(i) && other.contains(i) == in_other) {
+                    names.push_back(indexed_arguments_[i]->name());
+                }
+            }
+            return names;
+        };
 
-                if (match && no_space_between_short_arg_and_value) {
-                    //Only handles cases where there is no space between short arg and value
-                    short_arg_info.is_no_space_short_arg = true;
-                    short_arg_info.arg = kv.second;
-                    short_arg_info.value = std::string(str.begin() + kv.first.size(), str.end());
+        if (!specified_set_.contains_all(required_set_)) {
+            auto missing = common_names(required_set_, specified_set_, false);
+            throw ArgParseError("Missing required argument: " + missing[0]);
+        }
 
-                    return short_arg_info;
+        for (const auto& constraint : constraints_) {
+            const auto& args = constraint.arguments;
+            if (constraint.kind == ArgumentConstraint::Kind::MUTUALLY_EXCLUSIVE) {
+                if (specified_set_.count_common(args) > 1) {
+                    auto specified = common_names(args, specified_set_, true);
+                    throw ArgParseError("Arguments " + join(specified, ", ") + " are mutually exclusive");
+                }
+            } else if (constraint.kind == ArgumentConstraint::Kind::AT_LEAST_ONE_OF) {
+                if (specified_set_.count_common(args) == 0) {
+                    throw ArgParseError("One of the arguments " + join(common_names(args, args, true), ", ") + " is required");
                 }
+            } else if (constraint.kind == ArgumentConstraint::Kind::REQUIRES) {
+                if (specified_set_.contains(constraint.subject) && !specified_set_.contains_all(args)) {
+                    auto missing = common_names(args, specified_set_, false);
+                    throw ArgParseError("Argument " + indexed_arguments_[constraint.subject]->name()
+                                        + " requires " + join(missing, ", "));
+                }
+            } else {
+                assert(constraint.kind == ArgumentConstraint::Kind::CONFLICTS);
+                if (specified_set_.contains(constraint.subject) && specified_set_.count_common(args) > 0) {
+                    auto conflicting = common_names(args, specified_set_, true);
+                    throw ArgParseError("Argument " + indexed_arguments_[constraint.subject]->name()
+                                        + " conflicts with " + join(conflicting, ", "));
+                }
+            }
+        }
+    }
+
+    void ArgumentParser::check_inferred_dependencies() const {
+        if (inferred_values_.empty()) return;
+
+        InferredLookup lookup;
+        for (size_t i = 0; i < inferred_values_.size(); ++i) {
+            lookup.emplace_back(&inferred_values_[i]->dest(), i);
+        }
+        std::sort(lookup.begin(), lookup.end());
+
+        std::vector<VisitState> states(inferred_values_.size(), VisitState::UNVISITED);
+        std::vector<size_t> path;
+        for (size_t i = 0; i < inferred_values_.size(); ++i) {
+            visit_inferred(i, inferred_values_, lookup, states, path);
+        }
+    }
+
+    ArgumentParser::ShortArgInfo ArgumentParser::no_space_short_arg(const std::string& str) const {
+
+        ShortArgInfo short_arg_info;
+
+        //Only handles cases where there is no space between short arg and value,
+        //so the string must be longer than a short option
+        if (str.size() > 2 && str[0] == '-') {
+            ARGPARSE_STATS(detail::record_option_lookup());
+            auto arg = find_option(str.substr(0, 2));
+            if (arg) {
+                //String starts with short arg
+                short_arg_info.is_no_space_short_arg = true;
+                short_arg_info.arg = arg;
+                short_arg_info.value.assign(str, 2, std::string::npos);
+
+                return short_arg_info;
             }
         }
 
@@ -405,20 +956,147 @@ namespace argparse {
         return short_arg_info;
     }
 
+    std::shared_ptr<Argument> ArgumentParser::find_option(const std::string& str) const {
+        auto iter = std::lower_bound(str_to_option_arg_.begin(), str_to_option_arg_.end(), str,
+                                     [](const std::pair<std::string,std::shared_ptr<Argument>>& kv, const std::string& value) {
+                                         return kv.first < value;
+                                     });
+        if (iter != str_to_option_arg_.end() && iter->first == str) {
+            return iter->second;
+        }
+        return nullptr;
+    }
+
+    void ArgumentParser::insert_subcommand(std::string name, std::string help, std::unique_ptr<detail::SubcommandFactory> factory) {
+        auto iter = std::lower_bound(sorted_subcommands_.begin(), sorted_subcommands_.end(), name,
+                                     [&](size_t i, const std::string& str) { return subcommands_[i].name < str; });
+        if (iter != sorted_subcommands_.end() && subcommands_[*iter].name == name) {
+            throw ArgParseError("Subcommand '" + name + "' already exists");
+        }
+        sorted_subcommands_.insert(iter, subcommands_.size());
+
+        Subcommand subcommand;
+        subcommand.name = name;
+        subcommand.help = help;
+        subcommand.factory = std::move(factory);
+        subcommands_.push_back(std::move(subcommand));
+    }
+
+    size_t ArgumentParser::find_subcommand(const std::string& name) const {
+        auto iter = std::lower_bound(sorted_subcommands_.begin(), sorted_subcommands_.end(), name,
+                                     [&](size_t i, const std::string& str) { return subcommands_[i].name < str; });
+        if (iter != sorted_subcommands_.end() && subcommands_[*iter].name == name) {
+            return *iter;
+        }
+        return subcommands_.size();
+    }
+
+    ArgumentParser& ArgumentParser::build_subcommand(size_t index) {
+        auto& subcommand = subcommands_[index];
+        if (!subcommand.parser) {
+            //The subcommand's parser writes to the same sink, and is named after it in usage
+            std::unique_ptr<ArgumentParser> parser(new ArgumentParser(prog_, subcommand.help, *sink_));
+            parser->prog(prog_ + " " + subcommand.name, false);
+            parser->enable_trace(trace_enabled_);
+            subcommand.factory->build(*parser);
+
+            subcommand.parser = std::move(parser);
+        }
+        return *subcommand.parser;
+    }
+
+    ArgumentParser& ArgumentParser::active_parser() {
+        if (subcommand_selected_) {
+            return subcommands_[selected_subcommand_].parser->active_parser();
+        }
+        return *this;
+    }
+
+    bool ArgumentParser::is_argument(const std::string& str) const {
+        if (find_option(str)) {
+            //Exact match to short/long option
+            return true;
+        }
+
+        if (str.size() > 2 && str[0] == '-') {
+            //Check iff this is a short option with no spaces (i.e. the
+            //first two characters match a short option)
+            if (find_option(str.substr(0, 2))) {
+                return true;
+            }
+        }
+        return false;
+    }
+
     /*
      * ArgumentGroup
      */
     ArgumentGroup::ArgumentGroup(std::string name_str)
-        : name_(name_str)
-        {}
+        : data_(std::make_shared<Data>()) {
+        data_->name = name_str;
+    }
+
+    Argument& ArgumentGroup::add_flag(FlagSet& dest, size_t flag, std::string long_opt, std::string short_opt) {
+        if (flag >= dest.size()) {
+            throw ArgParseError("Flag " + std::to_string(flag) + " of " + long_opt + " is outside its FlagSet (of size "
+                                + std::to_string(dest.size()) + ")");
+        }
+
+        auto& arguments = mutable_data().arguments;
+        arguments.push_back(std::make_shared<FlagArgument>(dest, flag, long_opt, short_opt));
+
+        auto& arg = arguments.back();
+        arg->group_name(name()); //Tag the option with the group
+        arg->action(Action::STORE_TRUE);
+        arg->choices(DefaultConverter<bool>().default_choices());
+        return *arg;
+    }
 
     ArgumentGroup& ArgumentGroup::epilog(std::string str) {
-        epilog_ = str;
+        mutable_data().epilog = str;
+        return *this;
+    }
+    ArgumentGroup& ArgumentGroup::mutually_exclusive(std::vector<std::string> args) {
+        mutable_data().constraints.push_back({ArgumentConstraint::Kind::MUTUALLY_EXCLUSIVE, std::string(), args});
+        return *this;
+    }
+
+    ArgumentGroup& ArgumentGroup::at_least_one_of(std::vector<std::string> args) {
+        mutable_data().constraints.push_back({ArgumentConstraint::Kind::AT_LEAST_ONE_OF, std::string(), args});
+        return *this;
+    }
+
+    ArgumentGroup& ArgumentGroup::requires_all(std::string arg, std::vector<std::string> required_args) {
+        mutable_data().constraints.push_back({ArgumentConstraint::Kind::REQUIRES, arg, required_args});
+        return *this;
+    }
+
+    ArgumentGroup& ArgumentGroup::conflicts_with(std::string arg, std::vector<std::string> conflicting_args) {
+        mutable_data().constraints.push_back({ArgumentConstraint::Kind::CONFLICTS, arg, conflicting_args});
         return *this;
     }
-    std::string ArgumentGroup::name() const { return name_; }
-    std::string ArgumentGroup::epilog() const { return epilog_; }
-    const std::vector<std::shared_ptr<Argument>>& ArgumentGroup::arguments() const { return arguments_; }
+
+    std::string ArgumentGroup::name() const { return data_->name; }
+    std::string ArgumentGroup::epilog() const { return data_->epilog; }
+    const std::vector<std::shared_ptr<Argument>>& ArgumentGroup::arguments() const { return data_->arguments; }
+    const std::vector<ArgumentConstraint>& ArgumentGroup::constraints() const { return data_->constraints; }
+    const std::string& ArgumentGroup::module_name() const { return data_->module_name; }
+
+    ArgumentGroup::Data& ArgumentGroup::mutable_data() {
+        if (shared()) {
+            //The arguments themselves remain shared
+            data_ = std::make_shared<Data>(*data_);
+        }
+        return *data_;
+    }
+
+    void ArgumentGroup::share(const ArgumentGroup& other) {
+        data_ = other.data_;
+    }
+
+    bool ArgumentGroup::shared() const {
+        return data_.use_count() > 1;
+    }
 
     /*
      * Argument
@@ -441,6 +1119,11 @@ namespace argparse {
 
         //Set defaults
         metavar_ = toupper(dashes_name[1]);
+
+        name_ = long_opt_;
+        if (!short_opt_.empty()) {
+            name_ += "/" + short_opt_;
+        }
     }
 
     Argument& Argument::help(std::string help_str) {
@@ -466,6 +1149,12 @@ namespace argparse {
             throw ArgParseError("HELP action requires nargs to be '0'");
         } else if (action() == Action::STORE && (nargs_type != '1' && nargs_type != '+' && nargs_type != '*')) {
             throw ArgParseError("STORE action requires nargs to be '1', '+' or '*'");
+        } else if (action() == Action::APPEND && nargs_type != '1') {
+            throw ArgParseError("APPEND action requires nargs to be '1'");
+        } else if (action() == Action::EXTEND && (nargs_type != '+' && nargs_type != '*')) {
+            throw ArgParseError("EXTEND action requires nargs to be '+' or '*'");
+        } else if (action() == Action::COUNT && nargs_type != '0') {
+            throw ArgParseError("COUNT action requires nargs to be '0'");
         }
 
         nargs_ = nargs_type;
@@ -481,6 +1170,13 @@ namespace argparse {
 
     Argument& Argument::choices(std::vector<std::string> choice_values) {
         choices_ = choice_values;
+        choice_provider_.reset();
+        return *this;
+    }
+
+    Argument& Argument::choice_provider(std::shared_ptr<const ChoiceProvider> provider) {
+        choices_.clear();
+        choice_provider_ = provider;
         return *this;
     }
 
@@ -490,10 +1186,13 @@ namespace argparse {
         if (   action_ == Action::STORE_FALSE 
             || action_ == Action::STORE_TRUE 
             || action_ == Action::HELP 
-            || action_ == Action::VERSION) {
+            || action_ == Action::VERSION
+            || action_ == Action::COUNT) {
             this->nargs('0');
-        } else if (action_ == Action::STORE) {
+        } else if (action_ == Action::STORE || action_ == Action::APPEND) {
             this->nargs('1');
+        } else if (action_ == Action::EXTEND) {
+            this->nargs('+');
         } else {
             throw ArgParseError("Unrecognized argparse action");
         }
@@ -507,26 +1206,34 @@ namespace argparse {
     }
 
     Argument& Argument::default_value(const std::string& value) {
-        if (nargs() != '0' && nargs() != '1' && nargs() != '?') {
-            std::stringstream msg;
-            msg << "Scalar default value not allowed for nargs='" << nargs() << "'";
-            throw ArgParseError(msg.str());
-        }
+        check_default_allowed(false);
         default_value_.clear();
         default_value_.push_back(value);
+        default_provider_.reset();
         default_set_ = true;
         return *this;
     }
 
     Argument& Argument::default_value(const std::vector<std::string>& values) {
-        if (nargs() != '+' && nargs() != '*') {
+        check_default_allowed(true);
+        default_value_ = values;
+        default_provider_.reset();
+        default_set_ = true;
+        return *this;
+    }
+
+    void Argument::check_default_allowed(bool multiple_values) const {
+        if (!multiple_values && nargs() != '0' && nargs() != '1' && nargs() != '?') {
+            std::stringstream msg;
+            msg << "Scalar default value not allowed for nargs='" << nargs() << "'";
+            throw ArgParseError(msg.str());
+        }
+        //APPEND collects multiple values, one per occurrence
+        if (multiple_values && nargs() != '+' && nargs() != '*' && action() != Action::APPEND) {
             std::stringstream msg;
             msg << "Multiple default value not allowed for nargs='" << nargs() << "'";
             throw ArgParseError(msg.str());
         }
-        default_value_ = values;
-        default_set_ = true;
-        return *this;
     }
 
     Argument& Argument::default_value(const std::initializer_list<std::string>& values) {
@@ -544,35 +1251,89 @@ namespace argparse {
         return *this;
     }
 
-    std::string Argument::name() const { 
-        std::string name_str = long_option();
-        if (!short_option().empty()) {
-            name_str += "/" + short_option();
+    Argument& Argument::capacity_hint(size_t num_values) {
+        capacity_hint_ = num_values;
+        reserve_dest(capacity_hint_);
+        return *this;
+    }
+
+    Argument& Argument::lazy(bool is_lazy) {
+        if (is_lazy && !lazy_supported()) {
+            throw ArgParseError("Only single-value arguments can be lazy (" + name() + ")");
         }
-        return name_str;
+        lazy_ = is_lazy;
+        return *this;
     }
 
-    std::string Argument::long_option() const { return long_opt_; }
-    std::string Argument::short_option() const { return short_opt_; }
-    std::string Argument::help() const { return help_; }
+    void Argument::add_memory_usage(MemoryUsage& usage) const {
+        usage.argument_objects += object_size() + shared_ptr_control_bytes();
+        usage.strings += heap_bytes(long_opt_) + heap_bytes(short_opt_) + heap_bytes(name_) + heap_bytes(help_)
+                         + heap_bytes(metavar_) + heap_bytes(group_name_);
+        usage.choices += heap_bytes(choices_);
+        if (choice_provider_) {
+            usage.choices += choice_provider_->memory_usage();
+        }
+        usage.defaults += heap_bytes(default_value_);
+        usage.destinations += dest_memory_usage();
+    }
+
+    const std::string& Argument::name() const { return name_; }
+    const std::string& Argument::long_option() const { return long_opt_; }
+    const std::string& Argument::short_option() const { return short_opt_; }
+    const std::string& Argument::help() const { return help_; }
     char Argument::nargs() const { return nargs_; }
-    std::string Argument::metavar() const { return metavar_; }
-    std::vector<std::string> Argument::choices() const { return choices_; }
+    const std::string& Argument::metavar() const { return metavar_; }
+    const std::vector<std::string>& Argument::choices() const { return choices_; }
+    const std::shared_ptr<const ChoiceProvider>& Argument::choice_provider() const { return choice_provider_; }
+
+    bool Argument::is_valid_choice(const std::string& value) const {
+        if (choice_provider_) {
+            ARGPARSE_STATS(detail::record_choice_check());
+            return choice_provider_->contains(value);
+        }
+        return argparse::is_valid_choice(value, choices_);
+    }
+
+    std::string Argument::describe_choices() const {
+        if (choice_provider_ && choice_provider_->num_listed() == 0) {
+            return "one of " + choice_provider_->description();
+        } else if (choice_provider_) {
+            std::string listed = "one of: ";
+            for (size_t i = 0; i < choice_provider_->num_listed(); ++i) {
+                if (i != 0) listed += ", ";
+                listed += choice_provider_->listed(i);
+            }
+            return listed;
+        }
+        return "one of: " + join(choices_, ", ");
+    }
     Action Argument::action() const { return action_; }
     std::string Argument::default_value() const { 
-        if (default_value_.size() > 1) {
+        const auto& values = default_values();
+        if (values.size() > 1) {
             std::stringstream msg;
-            msg << "{" << join(default_value_, ", ") << "}";
+            msg << "{" << join(values, ", ") << "}";
             return msg.str();
-        } else if (default_value_.size() == 1) {
-            return default_value_[0]; 
+        } else if (values.size() == 1) {
+            return values[0]; 
         } else {
             return "";
         }
     }
-    std::string Argument::group_name() const { return group_name_; }
+    const std::string& Argument::group_name() const { return group_name_; }
     ShowIn Argument::show_in() const { return show_in_; }
     bool Argument::default_set() const { return default_set_; }
+    bool Argument::default_deferred() const { return default_provider_ != nullptr; }
+
+    const std::vector<std::string>& Argument::default_values() const {
+        if (default_provider_ && !default_provided_) {
+            default_value_ = default_provider_->provide();
+            default_provided_ = true;
+        }
+        return default_value_;
+    }
+    size_t Argument::capacity_hint() const { return capacity_hint_; }
+    bool Argument::lazy() const { return lazy_; }
 
     bool Argument::required() const {
         if(positional()) {
@@ -582,7 +1343,452 @@ namespace argparse {
         return required_;
     }
     bool Argument::positional() const {
-        assert(long_option().size() > 1);
-        return long_option()[0] != '-';
+        assert(long_opt_.size() > 1);
+        return long_opt_[0] != '-';
+    }
+
+    /*
+     * SingleValueArgument
+     */
+    SingleValueArgument::SingleValueArgument(ArgValueBase& dest, const detail::ValueOps& ops, std::string long_opt, std::string short_opt)
+        : Argument(long_opt, short_opt)
+        , dest_(dest)
+        , ops_(ops)
+        , converter_(ops.make_converter())
+        {}
+
+    void SingleValueArgument::set_dest_to_default() {
+        store(default_values()[0], Provenance::DEFAULT);
+        dest_.set_argument_name(name());
+        dest_.set_argument_group(group_name());
+    }
+
+    void SingleValueArgument::set_dest_to_value(const std::string& value) {
+        if (dest_.provenance() == Provenance::SPECIFIED
+            && dest_.argument_name() == name()) {
+            throw ArgParseError("Argument " + name() + " specified multiple times");
+        }
+
+        store(value, Provenance::SPECIFIED);
+        dest_.set_argument_name(name());
+        dest_.set_argument_group(group_name());
+    }
+
+    void SingleValueArgument::add_value_to_dest(const std::string& /*value*/) {
+        throw ArgParseError("Single value option can not have multiple values set");
+    }
+
+    void SingleValueArgument::set_dest_to_true() {
+        if (!ops_.store_flag) {
+            throw ArgParseError("Non-boolean destination can not be set true");
+        }
+        set_dest_to_flag(true);
+    }
+
+    void SingleValueArgument::set_dest_to_false() {
+        if (!ops_.store_flag) {
+            throw ArgParseError("Non-boolean destination can not be set false");
+        }
+        set_dest_to_flag(false);
+    }
+
+    void SingleValueArgument::increment_dest(size_t count) {
+        if (!ops_.increment) {
+            throw ArgParseError("Non-integer destination can not be counted");
+        }
+        ops_.increment(dest_, count);
+        dest_.set_argument_name(name());
+        dest_.set_argument_group(group_name());
+    }
+
+    void SingleValueArgument::set_dest_to_flag(bool value) {
+        ops_.store_flag(dest_, value);
+        dest_.set_argument_name(name());
+        dest_.set_argument_group(group_name());
+    }
+
+    bool SingleValueArgument::valid_action() {
+        if (action() == Action::APPEND || action() == Action::EXTEND) {
+            std::stringstream msg;
+            msg << "Single-value destination can not have " << (action() == Action::APPEND ? "APPEND" : "EXTEND")
+                << " action (" << long_option() << ")";
+            throw ArgParseError(msg.str());
+        } else if (action() == Action::COUNT) {
+            if (!ops_.increment) {
+                std::stringstream msg;
+                msg << "Non-integer destination can not have COUNT action (" << long_option() << ")";
+                throw ArgParseError(msg.str());
+            }
+            return true;
+        }
+
+        if (ops_.store_flag) {
+            //Any supported action is valid on a boolean destination
+            return true;
+        }
+
+        //Sanity check that we aren't processing a boolean action with a non-boolean destination
+        if (action() == Action::STORE_TRUE) {
+            std::stringstream msg;
+            msg << "Non-boolean destination can not have STORE_TRUE action (" << long_option() << ")";
+            throw ArgParseError(msg.str());
+        } else if (action() == Action::STORE_FALSE) {
+            std::stringstream msg;
+            msg << "Non-boolean destination can not have STORE_FALSE action (" << long_option() << ")";
+            throw ArgParseError(msg.str());
+        } else if (action() != Action::STORE) {
+            throw ArgParseError("Unexpected action (expected STORE)");
+        }
+        return true;
+    }
+
+    void SingleValueArgument::reset_dest(ResetMode mode) {
+        if (mode == ResetMode::KEEP_CAPACITY) {
+            ops_.reset_keep_capacity(dest_);
+        } else {
+            ops_.reset(dest_);
+            reserve_dest(capacity_hint());
+        }
+    }
+
+    void SingleValueArgument::resolve_dest() {
+        dest_.resolve_pending();
+    }
+
+    bool SingleValueArgument::is_valid_value(const std::string& value) {
+        //Lazy values are only converted when read
+        if (!lazy() && !ops_.convertible(value, converter_.get())) {
+            return false;
+        }
+        return is_valid_choice(value);
+    }
+
+    size_t SingleValueArgument::object_size() const { return sizeof(*this); }
+
+    size_t SingleValueArgument::dest_memory_usage() const {
+        return ops_.value_heap_bytes(dest_) + heap_bytes(dest_.argument_name()) + heap_bytes(dest_.argument_group());
+    }
+
+    void SingleValueArgument::reserve_dest(size_t num_values) {
+        if (num_values > 0) {
+            ops_.reserve(dest_, num_values);
+        }
+    }
+
+    bool SingleValueArgument::lazy_supported() const { return true; }
+
+    void SingleValueArgument::store(const std::string& value, Provenance prov) {
+        if (lazy()) {
+            ops_.defer(dest_, value, prov);
+        } else {
+            ops_.store(dest_, value, prov, converter_.get());
+        }
+    }
+
+    /*
+     * MultiValueArgument
+     */
+    MultiValueArgument::MultiValueArgument(ArgValueBase& dest, const detail::ValueOps& ops, std::string long_opt, std::string short_opt)
+        : Argument(long_opt, short_opt)
+        , dest_(dest)
+        , ops_(ops)
+        , converter_(ops.make_converter())
+        {}
+
+    void MultiValueArgument::set_dest_to_default() {
+        for (const auto& default_str : default_values()) {
+            ops_.store(dest_, default_str, Provenance::DEFAULT, converter_.get());
+        }
+
+        dest_.set_argument_name(name());
+        dest_.set_argument_group(group_name());
+    }
+
+    void MultiValueArgument::set_dest_to_value(const std::string& /*value*/) {
+        throw ArgParseError("Multi-value option can not be set to a single value");
+    }
+
+    void MultiValueArgument::add_value_to_dest(const std::string& value) {
+        if (dest_.provenance() == Provenance::SPECIFIED
+            && dest_.argument_name() != name()) {
+            throw ArgParseError("Argument destination already set by " + dest_.argument_name() + " (trying to set from " + name() + ")");
+        }
+
+        if (dest_.provenance() == Provenance::DEFAULT) {
+            ops_.clear(dest_);
+        }
+
+        ops_.store(dest_, value, Provenance::SPECIFIED, converter_.get());
+
+        dest_.set_argument_name(name());
+        dest_.set_argument_group(group_name());
+    }
+
+    void MultiValueArgument::set_dest_to_true() {
+        throw ArgParseError("Non-boolean destination can not be set true");
+    }
+
+    void MultiValueArgument::set_dest_to_false() {
+        throw ArgParseError("Non-boolean destination can not be set false");
+    }
+
+    void MultiValueArgument::increment_dest(size_t /*count*/) {
+        throw ArgParseError("Non-integer destination can not be counted");
+    }
+
+    bool MultiValueArgument::valid_action() {
+        //Sanity check that we aren't processing a boolean action with a non-boolean destination
+        if (action() != Action::STORE && action() != Action::APPEND && action() != Action::EXTEND) {
+            throw ArgParseError("Unexpected action (expected STORE, APPEND or EXTEND)");
+        }
+        return true;
+    }
+
+    void MultiValueArgument::reset_dest(ResetMode mode) {
+        if (mode == ResetMode::KEEP_CAPACITY) {
+            ops_.reset_keep_capacity(dest_);
+        } else {
+            ops_.reset(dest_);
+            reserve_dest(capacity_hint());
+        }
+    }
+
+    void MultiValueArgument::resolve_dest() {
+        dest_.resolve_pending();
+    }
+
+    bool MultiValueArgument::is_valid_value(const std::string& value) {
+        if (!ops_.convertible(value, converter_.get())) {
+            return false;
+        }
+        return is_valid_choice(value);
+    }
+
+    size_t MultiValueArgument::object_size() const { return sizeof(*this); }
+
+    size_t MultiValueArgument::dest_memory_usage() const {
+        return ops_.value_heap_bytes(dest_) + heap_bytes(dest_.argument_name()) + heap_bytes(dest_.argument_group());
+    }
+
+    void MultiValueArgument::reserve_dest(size_t num_values) {
+        if (num_values > 0) {
+            ops_.reserve(dest_, num_values);
+        }
+    }
+
+    bool MultiValueArgument::lazy_supported() const { return false; }
+
+    namespace detail {
+        namespace {
+            size_t popcount(uint64_t word) {
+                size_t count = 0;
+                for (; word != 0; word &= word - 1) {
+                    ++count;
+                }
+                return count;
+            }
+        }
+
+        void ArgumentSet::resize(size_t num_arguments) {
+            size_ = num_arguments;
+            words_.assign((num_arguments + 63) / 64, 0);
+        }
+
+        void ArgumentSet::clear() {
+            std::fill(words_.begin(), words_.end(), 0);
+        }
+
+        void ArgumentSet::insert(size_t index) {
+            assert(index < size_);
+            words_[index / 64] |= uint64_t(1) << (index % 64);
+        }
+
+        bool ArgumentSet::contains(size_t index) const {
+            assert(index < size_);
+            return words_[index / 64] & (uint64_t(1) << (index % 64));
+        }
+
+        size_t ArgumentSet::size() const { return size_; }
+
+        size_t ArgumentSet::count_common(const ArgumentSet& other) const {
+            assert(other.size_ == size_);
+            size_t count = 0;
+            for (size_t i = 0; i < words_.size(); ++i) {
+                count += popcount(words_[i] & other.words_[i]);
+            }
+            return count;
+        }
+
+        bool ArgumentSet::contains_all(const ArgumentSet& other) const {
+            assert(other.size_ == size_);
+            for (size_t i = 0; i < words_.size(); ++i) {
+                if ((words_[i] & other.words_[i]) != other.words_[i]) return false;
+            }
+            return true;
+        }
+    }
+
+    /*
+     * FlagArgument
+     */
+    constexpr size_t FlagSet::FLAGS_PER_WORD;
+
+    FlagArgument::FlagArgument(FlagSet& dest, size_t flag, std::string long_opt, std::string short_opt)
+        : Argument(long_opt, short_opt)
+        , dest_(dest)
+        , flag_(flag)
+        {}
+
+    void FlagArgument::set_dest_to_default() {
+        dest_.set(flag_, convert_flag(default_values()[0]), Provenance::DEFAULT);
+    }
+
+    void FlagArgument::set_dest_to_value(const std::string& value) {
+        if (dest_.specified(flag_)) {
+            throw ArgParseError("Argument " + name() + " specified multiple times");
+        }
+        dest_.set(flag_, convert_flag(value), Provenance::SPECIFIED);
+    }
+
+    void FlagArgument::add_value_to_dest(const std::string& /*value*/) {
+        throw ArgParseError("Single value option can not have multiple values set");
+    }
+
+    void FlagArgument::set_dest_to_true() {
+        dest_.set(flag_, true, Provenance::SPECIFIED);
+    }
+
+    void FlagArgument::set_dest_to_false() {
+        dest_.set(flag_, false, Provenance::SPECIFIED);
+    }
+
+    void FlagArgument::increment_dest(size_t /*count*/) {
+        throw ArgParseError("Flag destination can not be counted");
+    }
+
+    bool FlagArgument::valid_action() {
+        if (action() != Action::STORE_TRUE && action() != Action::STORE_FALSE && action() != Action::STORE) {
+            std::stringstream msg;
+            msg << "Flag destination can only have STORE_TRUE, STORE_FALSE or STORE action (" << long_option() << ")";
+            throw ArgParseError(msg.str());
+        }
+        return true;
+    }
+
+    void FlagArgument::reset_dest(ResetMode /*mode*/) {
+        dest_.set(flag_, false, Provenance::UNSPECIFIED);
+    }
+
+    void FlagArgument::resolve_dest() {
+        //Flags are never converted lazily
+    }
+
+    bool FlagArgument::is_valid_value(const std::string& value) {
+        DefaultConverter<bool> converter;
+        bool flag = false;
+        return detail::convert<bool,DefaultConverter<bool>>(&converter, value, flag, nullptr) && is_valid_choice(value);
+    }
+
+    size_t FlagArgument::object_size() const { return sizeof(*this); }
+
+    size_t FlagArgument::dest_memory_usage() const {
+        //The flag's share of its FlagSet (rounded up)
+        return (dest_.heap_bytes() + dest_.size() - 1) / dest_.size();
+    }
+
+    void FlagArgument::reserve_dest(size_t /*num_values*/) {
+        //Nothing to reserve
+    }
+
+    bool FlagArgument::lazy_supported() const { return false; }
+
+    bool FlagArgument::convert_flag(const std::string& str) {
+        DefaultConverter<bool> converter;
+        bool flag = false;
+        detail::convert_or_throw<bool,DefaultConverter<bool>>(&converter, str, flag);
+        return flag;
+    }
+
+    /*
+     * InferredValue
+     */
+    InferredValue::InferredValue(ArgValueBase& dest, std::string name_str)
+        : dest_(dest)
+        , name_(name_str)
+        {}
+
+    const std::string& InferredValue::name() const { return name_; }
+    const ArgValueBase& InferredValue::dest() const { return dest_; }
+    const std::vector<std::unique_ptr<detail::InferenceInput>>& InferredValue::inputs() const { return inputs_; }
+    size_t InferredValue::num_computations() const { return num_computations_; }
+
+    void InferredValue::invalidate() {
+        dest_.set_pending(std::string(), dest_.provenance(), &InferredValue::update_pending, this);
+    }
+
+    void InferredValue::update() {
+        if (updating_) {
+            throw ArgParseError("Inferred value " + name_ + " depends on itself");
+        }
+
+        struct UpdatingGuard {
+            bool& updating;
+            ~UpdatingGuard() { updating = false; }
+        } guard{updating_};
+        updating_ = true;
+
+        bool changed = !computed_;
+        for (const auto& input : inputs_) {
+            if (changed) break;
+            changed = input->changed();
+        }
+
+        if (changed) {
+            compute(dest_);
+            dest_.set_argument_name(name_);
+            for (const auto& input : inputs_) {
+                input->record();
+            }
+            computed_ = true;
+            ++num_computations_;
+        }
+    }
+
+    void InferredValue::detach() noexcept {
+        if (dest_.pending_context() != this) return; //Not (or no longer) pending on this value
+
+        try {
+            update();
+        } catch (...) {
+            //Keep the last value (e.g. of a circular dependency)
+        }
+        dest_.drop_pending();
+    }
+
+    void InferredValue::update_pending(ArgValueBase& dest, const std::string& /*str*/, void* context) {
+        auto& inferred = *static_cast<InferredValue*>(context);
+        if (&dest == &inferred.dest_) {
+            inferred.update();
+        } else {
+            //Not the tracked destination (e.g. a copy), so computed afresh
+            inferred.compute(dest);
+            dest.set_argument_name(inferred.name_);
+        }
+    }
+
+    namespace detail {
+        ConversionScope::ConversionScope(const std::type_info& converter_type, const std::string& str)
+            : span_(ParseTrace::EventType::CONVERSION) {
+            ARGPARSE_STATS(record_conversion(converter_type));
+
+            if (span_) {
+                span_.set_text(str);
+                span_.set_converter(converter_type);
+            }
+        }
+
+        void store_flag(ArgValueBase& dest, bool value) {
+            static_cast<ArgValue<bool>&>(dest).set(value, Provenance::SPECIFIED);
+        }
     }
 } //namespace
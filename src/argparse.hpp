@@ -1,29 +1,38 @@
 #ifndef ARGPARSE_H
 #define ARGPARSE_H
+#include <cstdint>
 #include <iosfwd>
+#include <memory>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
-#include <iostream>
-#include <sstream>
-#include <memory>
-#include <map>
 
+#include "argparse_choices.hpp"
 #include "argparse_formatter.hpp"
 #include "argparse_default_converter.hpp"
 #include "argparse_error.hpp"
+#include "argparse_flags.hpp"
+#include "argparse_instrument.hpp"
+#include "argparse_output.hpp"
+#include "argparse_trace.hpp"
 #include "argparse_value.hpp"
 
 namespace argparse {
 
     class Argument;
     class ArgumentGroup;
+    class InferredValue;
 
     enum class Action {
         STORE,
         STORE_TRUE,
         STORE_FALSE,
         HELP,
-        VERSION
+        VERSION,
+        APPEND, //Each occurrence appends its value to a multi-value destination
+        EXTEND, //Each occurrence appends its values (nargs '+' or '*') to a multi-value destination
+        COUNT   //Each occurrence increments an integer destination (a short option may be repeated, e.g. -vvv)
     };
 
     enum class ShowIn {
@@ -31,10 +40,100 @@ namespace argparse {
         HELP_ONLY
     };
 
+    //A rule about which arguments may be specified together.
+    //Arguments are referred to by any of their option strings (or their name, if positional)
+    struct ArgumentConstraint {
+        enum class Kind {
+            MUTUALLY_EXCLUSIVE, //At most one of the arguments may be specified
+            AT_LEAST_ONE_OF,    //At least one of the arguments must be specified
+            REQUIRES,           //If the subject is specified, all of the arguments must be too
+            CONFLICTS           //If the subject is specified, none of the arguments may be
+        };
+
+        Kind kind;
+        std::string subject; //Only used by REQUIRES and CONFLICTS
+        std::vector<std::string> arguments; //If empty, all the arguments of the group declaring the constraint
+    };
+
+    namespace detail {
+        //A set of arguments, identified by the indices assigned to them by ArgumentParser::freeze()
+        class ArgumentSet {
+            public:
+                //Sets the number of arguments, and removes all of them from the set
+                void resize(size_t num_arguments);
+
+                //Removes all the arguments from the set (keeping its capacity)
+                void clear();
+
+                void insert(size_t index);
+                bool contains(size_t index) const;
+
+                //Returns the number of arguments (which may be in the set)
+                size_t size() const;
+
+                //Returns the number of arguments also in other
+                size_t count_common(const ArgumentSet& other) const;
+
+                //Returns true if all of other's arguments are in this set
+                bool contains_all(const ArgumentSet& other) const;
+            private:
+                std::vector<uint64_t> words_;
+                size_t size_ = 0;
+        };
+
+        //Builds the parser of a subcommand (see ArgumentParser::add_subcommand())
+        class SubcommandFactory {
+            public:
+                virtual ~SubcommandFactory() {}
+
+                //Adds the subcommand's arguments to parser
+                virtual void build(ArgumentParser& parser) = 0;
+        };
+
+        template<typename BuildParser>
+        class TypedSubcommandFactory;
+
+        //Computes the default value of an argument (see Argument::default_value())
+        class DefaultProvider {
+            public:
+                virtual ~DefaultProvider() {}
+
+                virtual std::vector<std::string> provide() = 0;
+        };
+
+        template<typename Provider>
+        class TypedDefaultProvider;
+
+        //True if Provider is callable with no arguments
+        template<typename Provider, typename = void>
+        struct is_default_provider : std::false_type {};
+
+        template<typename Provider>
+        struct is_default_provider<Provider,decltype(void(std::declval<Provider&>()()))> : std::true_type {};
+    }
+
+    //How reset_destinations() resets the argument values
+    enum class ResetMode {
+        REINITIALIZE, //Values are re-initialized, releasing any memory they hold
+        KEEP_CAPACITY //Values are cleared, but strings and containers keep their capacity for re-use
+    };
+
     class ArgumentParser {
         public:
-            //Initializes an argument parser
-            ArgumentParser(std::string prog_name, std::string description_str=std::string(), std::ostream& os=std::cout);
+            //Initializes an argument parser which prints to stdout (see stdout_sink())
+            ArgumentParser(std::string prog_name, std::string description_str=std::string());
+
+            //Initializes an argument parser which prints to sink (which must outlive the parser)
+            ArgumentParser(std::string prog_name, std::string description_str, OutputSink& sink);
+
+#ifndef ARGPARSE_NO_IOSTREAM
+            //Initializes an argument parser which prints to os
+            ArgumentParser(std::string prog_name, std::string description_str, std::ostream& os);
+#endif
+
+            ArgumentParser(ArgumentParser&&);
+            ArgumentParser& operator=(ArgumentParser&&);
+            ~ArgumentParser();
 
             //Overrides the program name
             ArgumentParser& prog(std::string prog, bool basename_only=true);
@@ -45,6 +144,9 @@ namespace argparse {
             //Specifies the epilog text at the bottom of the help description
             ArgumentParser& epilog(std::string prog);
 
+            //Enables (or disables) recording of a trace of each parse (see trace())
+            ArgumentParser& enable_trace(bool enable=true);
+
             //Adds an argument or option with a single name (single value)
             template<typename T, typename Converter=DefaultConverter<T>>
             Argument& add_argument(ArgValue<T>& dest, std::string option);
@@ -61,9 +163,55 @@ namespace argparse {
             template<typename T, typename Converter=DefaultConverter<T>>
             Argument& add_argument(ArgValue<std::vector<T>>& dest, std::string long_opt, std::string short_opt);
 
+            //Adds a boolean option (with action STORE_TRUE) whose value is bit flag of dest
+            Argument& add_flag(FlagSet& dest, size_t flag, std::string long_opt, std::string short_opt=std::string());
+
             //Adds a group to collect related arguments
             ArgumentGroup& add_argument_group(std::string description_str);
 
+            //Includes the argument groups of parent (like the parents of Python's argparse), so arguments
+            //common to several parsers are defined once. The groups' definitions are shared (not copied) until
+            //this parser or parent modifies them; arguments added to a group of the same name are
+            //appended to this parser's copy of it. The arguments keep their destinations.
+            //Help options of parent are not included (this parser adds its own)
+            ArgumentParser& add_parent(const ArgumentParser& parent);
+
+            //Adds the options of an independent component (e.g. a library) as a module: an argument group,
+            //named module_name, to which add_options (callable as add_options(ArgumentGroup&)) adds
+            //the module's arguments.
+            //The module's option strings are checked (in constant time each) against those already registered;
+            //on a conflict the module is removed and ArgParseError, naming both modules, is thrown.
+            //The module is also removed if add_options throws (the exception is propagated)
+            template<typename AddOptions>
+            ArgumentGroup& add_module(std::string module_name, AddOptions add_options);
+
+            //Declares constraints on which arguments may be specified together (see ArgumentGroup).
+            //They are checked after the command-line is parsed
+            ArgumentParser& mutually_exclusive(std::vector<std::string> args);
+            ArgumentParser& at_least_one_of(std::vector<std::string> args);
+            ArgumentParser& requires_all(std::string arg, std::vector<std::string> required_args);
+            ArgumentParser& conflicts_with(std::string arg, std::vector<std::string> conflicting_args);
+
+            //Adds a value inferred from other values: dest is set to compute() (with Provenance::INFERRED)
+            //when it is first read, and re-computed only if one of its inputs (see InferredValue::depends_on())
+            //has changed since. compute must be callable as T compute().
+            //Any value still pending when the parser is destroyed (or move-assigned over) is computed
+            //then, so dest and the inputs must outlive the parser. If that computation fails (e.g.
+            //compute() throws) the error is dropped and dest silently keeps its previous value; call
+            //validate() before destroying the parser to have such errors reported.
+            //Copying or moving dest brings it up-to-date first (so may throw as reading it would)
+            template<typename T, typename Compute>
+            InferredValue& add_inferred(ArgValue<T>& dest, std::string name, Compute compute);
+
+            //Adds a subcommand (like the subparsers of Python's argparse), selected by the first
+            //command-line token after any positional arguments; the remaining tokens are parsed by
+            //the subcommand's parser. That parser is built by build_parser (callable as
+            //build_parser(ArgumentParser&)) only when the subcommand is first selected, or its help
+            //is printed (see print_full_help()), so programs with many subcommands only pay for one.
+            //Once a parser has subcommands, one of them must be specified
+            template<typename BuildParser>
+            ArgumentParser& add_subcommand(std::string name, std::string help, BuildParser build_parser);
+
             //Like parse_arg_throw(), but catches exceptions and exits the program
             void parse_args(int argc, const char* const* argv, int error_exit_code=1, int help_exit_code=0, int version_exit_code=0);
 
@@ -72,10 +220,30 @@ namespace argparse {
             //If an error occurs throws ArgParseError
             //If an help is requested occurs throws ArgParseHelp
             void parse_args_throw(int argc, const char* const* argv);
-            void parse_args_throw(std::vector<std::string> args);
-
-            //Reset the target values to their initial state
-            void reset_destinations();
+            void parse_args_throw(const std::vector<std::string>& args);
+
+            //Builds the look-up tables used to parse the command-line, reporting any
+            //option strings which map to multiple arguments.
+            //This is done automatically by parse_args_throw() (and redone if arguments
+            //have since been added), but may be called explicitly to front-load the cost
+            void freeze();
+
+            //Reset the target values to their initial state.
+            //With ResetMode::KEEP_CAPACITY (and capacity hints, see Argument::capacity_hint()),
+            //repeatedly re-parsing similar command-lines does not allocate once warmed up
+            void reset_destinations(ResetMode mode=ResetMode::REINITIALIZE);
+
+            //Converts any values of lazy arguments (see Argument::lazy()) which are still pending,
+            //so conversion errors can be reported up front rather than when the values are read,
+            //and brings the inferred values up-to-date. Until then, reading those values is not
+            //thread-safe (see ArgValue::value()).
+            //Throws ArgParseConversionError for the first value which fails to convert
+            void validate();
+
+            //Marks the inferred values to be checked for changed inputs when they are next read.
+            //This is done by each parse and reset_destinations(), but must be called after
+            //setting inputs directly (e.g. when reloading a configuration)
+            void invalidate_inferred();
 
             //Prints the basic usage
             void print_usage();
@@ -83,6 +251,9 @@ namespace argparse {
             //Prints the usage and full help description for each option
             void print_help();
 
+            //Prints the help, followed by the help of each subcommand (building their parsers)
+            void print_full_help();
+
             //Prints the version information
             void print_version();
         public:
@@ -100,15 +271,88 @@ namespace argparse {
             //Returns all the argument groups in this parser
             std::vector<ArgumentGroup> argument_groups() const;
 
+            //Returns the statistics accumulated by parsing and formatting since
+            //the last reset_stats() (all zero unless built with ARGPARSE_ENABLE_STATS)
+            const ParseStats& stats() const;
+
+            //Resets the accumulated statistics
+            void reset_stats();
+
+            //Returns a breakdown of the memory used by the parser, its arguments and their destinations
+            MemoryUsage memory_usage() const;
+
+            //Returns the trace of the most recent parse (and any subsequent formatting)
+            //if tracing is enabled, see enable_trace()
+            const ParseTrace& trace() const;
+
+            //Returns the names and help of the subcommands, in the order they were added
+            std::vector<std::pair<std::string,std::string>> subcommands() const;
+
+            //Returns the subcommand selected by the most recent parse (empty if none)
+            const std::string& subcommand() const;
+
+            //Returns the parser of subcommand name, building it if required.
+            //Throws ArgParseError if there is no such subcommand
+            ArgumentParser& subcommand_parser(const std::string& name);
+
         private:
             void add_help_option_if_unspecified();
 
+            //Returns true if the look-up tables are up-to-date with the registered arguments
+            bool frozen() const;
+
+            //Returns the total number of arguments across all groups
+            size_t num_arguments() const;
+
+            //Returns the total number of constraints across all groups
+            size_t num_constraints() const;
+
+            //Returns the index of the argument with option string (or positional name) str.
+            //Throws ArgParseError if there is none
+            size_t constraint_argument_index(const std::string& str) const;
+
+            //Translates the argument constraints into sets of argument indices
+            void compile_constraints();
+
+            //Throws ArgParseError if the specified arguments (see specified_set_) violate a constraint
+            void check_constraints() const;
+
+            //Throws ArgParseError if the inferred values have circular dependencies
+            void check_inferred_dependencies() const;
+
+            //Adds the option strings of arguments added since the last call to the hashed option registry.
+            //Throws ArgParseError if an option string is already registered (removing the last group, if
+            //it is a module which registered it)
+            void register_options();
+
+            //Describes the group at group_index in errors (e.g. "module 'router'")
+            std::string describe_group(size_t group_index) const;
+
             struct ShortArgInfo {
                 bool is_no_space_short_arg = false;
                 std::shared_ptr<argparse::Argument> arg;
                 std::string value;
             };
-            ShortArgInfo no_space_short_arg(std::string str, const std::map<std::string, std::shared_ptr<Argument>>& str_to_option_arg) const;
+            ShortArgInfo no_space_short_arg(const std::string& str) const;
+
+            //Returns the argument with option string str (or null if there is none)
+            std::shared_ptr<Argument> find_option(const std::string& str) const;
+
+            //Returns true if str is an option string, or a short option immediately followed by its value
+            bool is_argument(const std::string& str) const;
+
+            //Adds a subcommand (keeping sorted_subcommands_ sorted).
+            //Throws ArgParseError if there is already a subcommand named name
+            void insert_subcommand(std::string name, std::string help, std::unique_ptr<detail::SubcommandFactory> factory);
+
+            //Returns the index of subcommand name in subcommands_ (or subcommands_.size() if there is none)
+            size_t find_subcommand(const std::string& name) const;
+
+            //Returns the parser of the subcommand at index, building it if required
+            ArgumentParser& build_subcommand(size_t index);
+
+            //Returns the parser the most recent parse ended in (the selected subcommand's, if any)
+            ArgumentParser& active_parser();
         private:
             std::string prog_;
             std::string description_;
@@ -117,10 +361,63 @@ namespace argparse {
             std::vector<ArgumentGroup> argument_groups_;
 
             std::unique_ptr<Formatter> formatter_;
-            std::ostream& os_;
+            std::unique_ptr<OutputSink> owned_sink_; //Set if the parser adapted a std::ostream
+            OutputSink* sink_;
             ArgValue<bool> show_help_dummy_; //Dummy variable used as destination for automatically generated help option
+
+            //Look-up tables built by freeze()
+            std::vector<std::pair<std::string,std::shared_ptr<Argument>>> str_to_option_arg_; //Sorted by option string
+            std::vector<std::shared_ptr<Argument>> positional_args_;
+            size_t frozen_num_arguments_ = 0;
+            size_t frozen_num_inferred_ = 0;
+            size_t frozen_num_constraints_ = 0;
+            bool frozen_ = false;
+
+            //Constraints (including required arguments), compiled by freeze() into sets of argument indices
+            struct CompiledConstraint {
+                ArgumentConstraint::Kind kind;
+                size_t subject;
+                detail::ArgumentSet arguments;
+            };
+            std::vector<const Argument*> indexed_arguments_; //By index
+            std::vector<std::pair<const Argument*,size_t>> argument_indices_; //Sorted by argument
+            detail::ArgumentSet required_set_;
+            std::vector<CompiledConstraint> constraints_;
+
+            std::vector<std::unique_ptr<InferredValue>> inferred_values_;
+
+            struct Subcommand {
+                std::string name;
+                std::string help;
+                std::unique_ptr<detail::SubcommandFactory> factory;
+                std::unique_ptr<ArgumentParser> parser; //Null until built
+            };
+            std::vector<Subcommand> subcommands_; //In the order added
+            std::vector<size_t> sorted_subcommands_; //Indices into subcommands_, sorted by name
+            bool subcommand_selected_ = false; //Set if the last parse selected a subcommand
+            size_t selected_subcommand_ = 0; //Index of the selected subcommand in subcommands_
+
+            //Maps each option string to the group which registered it (see register_options())
+            struct OptionRegistry;
+            std::unique_ptr<OptionRegistry> option_registry_;
+
+            //Scratch space re-used by each parse (so parsing need not allocate)
+            std::vector<std::string> argv_strs_;
+            std::vector<const std::string*> values_;
+            std::vector<const Argument*> specified_arguments_;
+            detail::ArgumentSet specified_set_;
+
+            ParseStats stats_;
+
+            ParseTrace trace_;
+            bool trace_enabled_ = false;
     };
 
+    /*
+     * ArgumentGroup is a handle to a group's definition (its arguments, constraints etc.),
+     * which copies of the group (e.g. in the parsers including it, see ArgumentParser::add_parent())
+     * share until one of them is modified (copy-on-write).
+     */
     class ArgumentGroup {
         public:
 
@@ -140,9 +437,24 @@ namespace argparse {
             template<typename T, typename Converter=DefaultConverter<T>>
             Argument& add_argument(ArgValue<std::vector<T>>& dest, std::string long_opt, std::string short_opt);
 
+            //Adds a boolean option (with action STORE_TRUE) whose value is bit flag of dest
+            Argument& add_flag(FlagSet& dest, size_t flag, std::string long_opt, std::string short_opt=std::string());
+
             //Adds an epilog to the group
             ArgumentGroup& epilog(std::string str);
 
+            //Declares that at most one of args (by default, the group's arguments) may be specified
+            ArgumentGroup& mutually_exclusive(std::vector<std::string> args=std::vector<std::string>());
+
+            //Declares that at least one of args (by default, the group's arguments) must be specified
+            ArgumentGroup& at_least_one_of(std::vector<std::string> args=std::vector<std::string>());
+
+            //Declares that if arg is specified, all of required_args must be too
+            ArgumentGroup& requires_all(std::string arg, std::vector<std::string> required_args);
+
+            //Declares that if arg is specified, none of conflicting_args may be
+            ArgumentGroup& conflicts_with(std::string arg, std::vector<std::string> conflicting_args);
+
         public:
             //Returns the name of the group
             std::string name() const;
@@ -152,6 +464,12 @@ namespace argparse {
 
             //Returns the arguments within the group
             const std::vector<std::shared_ptr<Argument>>& arguments() const;
+
+            //Returns the constraints declared by the group
+            const std::vector<ArgumentConstraint>& constraints() const;
+
+            //Returns the name of the module which added the group (or an empty string if none)
+            const std::string& module_name() const;
         public:
             ArgumentGroup(const ArgumentGroup&) = default;
             ArgumentGroup(ArgumentGroup&&) = default;
@@ -160,10 +478,25 @@ namespace argparse {
         private:
             friend class ArgumentParser;
             ArgumentGroup(std::string name_str=std::string());
+
+            struct Data {
+                std::string name;
+                std::string epilog;
+                std::vector<std::shared_ptr<Argument>> arguments;
+                std::vector<ArgumentConstraint> constraints;
+                std::string module_name;
+            };
+
+            //Returns the definition for modification, first copying it if it is shared
+            Data& mutable_data();
+
+            //Makes this group share other's definition
+            void share(const ArgumentGroup& other);
+
+            //Returns true if the definition is shared with another group
+            bool shared() const;
         private:
-            std::string name_;
-            std::string epilog_;
-            std::vector<std::shared_ptr<Argument>> arguments_;
+            std::shared_ptr<Data> data_;
     };
 
     class Argument {
@@ -178,6 +511,15 @@ namespace argparse {
             Argument& default_value(const std::vector<std::string>& default_val);
             Argument& default_value(const std::initializer_list<std::string>& default_val);
 
+            //Sets a provider of the default value, callable as provider() returning a std::string (or
+            //std::vector<std::string>, for multiple values), for defaults which are expensive to compute.
+            //It is only called once the argument is parsed without being specified, or its default is
+            //shown in the help; the value is then kept for the argument's lifetime.
+            //Unlike other defaults, the value is not set at all if the argument is specified (so
+            //Action::APPEND does not append to it)
+            template<typename Provider, typename = typename std::enable_if<detail::is_default_provider<Provider>::value>::type>
+            Argument& default_value(Provider provider);
+
             //Sets the action
             Argument& action(Action action);
 
@@ -193,21 +535,36 @@ namespace argparse {
             //Sets the valid choices for this option's value
             Argument& choices(std::vector<std::string> choice_values);
 
+            //Sets a provider of the valid choices (see argparse_choices.hpp), for sets too large to list.
+            //This replaces any choices(), and the choices are only listed in the usage or help if the
+            //provider lists them
+            Argument& choice_provider(std::shared_ptr<const ChoiceProvider> provider);
+
             //Sets the group name this argument is associated with
             Argument& group_name(std::string grp);
 
             //Sets where this option appears in the help
             Argument& show_in(ShowIn show);
 
+            //Reserves space for num_values values in the destination (elements of a
+            //multi-value destination, or characters of a string), which is kept when
+            //values are reset. This avoids re-allocating as values are added
+            Argument& capacity_hint(size_t num_values);
+
+            //Sets whether the value is converted lazily: parsing then only stores the string,
+            //which is converted when the destination is first read (see ArgValue::value() and
+            //ArgumentParser::validate()). Only single-value arguments may be lazy
+            Argument& lazy(bool is_lazy);
+
         public: //Option setting mutators
             //Sets the target value to the specified default
             virtual void set_dest_to_default() = 0;
 
             //Sets the target value to the specified value
-            virtual void set_dest_to_value(std::string value) = 0;
+            virtual void set_dest_to_value(const std::string& value) = 0;
 
             //Adds the specified value to the taget values
-            virtual void add_value_to_dest(std::string value) = 0;
+            virtual void add_value_to_dest(const std::string& value) = 0;
 
             //Set the target value to true
             virtual void set_dest_to_true() = 0;
@@ -215,32 +572,48 @@ namespace argparse {
             //Set the target value to false
             virtual void set_dest_to_false() = 0;
 
-            virtual void reset_dest() = 0;
+            //Adds count to the target value
+            virtual void increment_dest(size_t count) = 0;
+
+            //Resets the target value to its initial state
+            virtual void reset_dest(ResetMode mode) = 0;
+
+            //Converts the target value if its conversion is pending (see lazy())
+            virtual void resolve_dest() = 0;
         public: //Accessors
 
             //Returns a discriptive name build from the long/short option
-            std::string name() const;
+            const std::string& name() const;
 
             //Returns the long option name (or positional name) for this argument.
             //Note that this may be a single-letter option if only a short option name was specified
-            std::string long_option() const;
+            const std::string& long_option() const;
 
             //Returns the short option name for this argument, note that this returns
             //the empty string if no short option is specified, or if only the short option
             //is specified.
-            std::string short_option() const;
+            const std::string& short_option() const;
 
             //Returns the help description for this option
-            std::string help() const;
+            const std::string& help() const;
 
             //Returns the number of arguments this option expects
             char nargs() const;
 
             //Returns the specified metavar for this option
-            std::string metavar() const;
+            const std::string& metavar() const;
 
             //Returns the list of valid choices for this option
-            std::vector<std::string> choices() const;
+            const std::vector<std::string>& choices() const;
+
+            //Returns the provider of valid choices for this option (null if none)
+            const std::shared_ptr<const ChoiceProvider>& choice_provider() const;
+
+            //Returns true if value is one of the valid choices (or any value is valid)
+            bool is_valid_choice(const std::string& value) const;
+
+            //Describes the valid choices in error messages (e.g. "one of: fast, slow")
+            std::string describe_choices() const;
 
             //Returns the action associated with this option
             Action action() const;
@@ -252,7 +625,7 @@ namespace argparse {
             std::string default_value() const;
 
             //Returns the group name associated with this argument
-            std::string group_name() const;
+            const std::string& group_name() const;
 
             //Indicates where this option should appear in the help
             ShowIn show_in() const;
@@ -263,8 +636,21 @@ namespace argparse {
             //Returns true if the default_value() was set
             bool default_set() const;
 
+            //Returns true if the default value is computed by a provider, and so is only
+            //set (after parsing) if the argument was not specified
+            bool default_deferred() const;
+
+            //Returns the capacity hint (zero if none)
+            size_t capacity_hint() const;
+
+            //Returns true if the value is converted lazily
+            bool lazy() const;
+
             //Returns true if the proposed value is legal
-            virtual bool is_valid_value(std::string value) = 0;
+            virtual bool is_valid_value(const std::string& value) = 0;
+
+            //Adds the memory used by this argument (and the heap memory of its destination) to usage
+            void add_memory_usage(MemoryUsage& usage) const;
         public: //Lifetime
             virtual ~Argument() {}
             Argument(const Argument&) = default;
@@ -273,15 +659,37 @@ namespace argparse {
             Argument& operator=(const Argument&&) = delete;
         protected:
             virtual bool valid_action() = 0;
-            std::vector<std::string> default_value_;
+
+            //Returns the size of the (most derived) argument object
+            virtual size_t object_size() const = 0;
+
+            //Returns the heap memory used by the destination value and its metadata
+            virtual size_t dest_memory_usage() const = 0;
+
+            //Reserves capacity for num_values values in the destination
+            virtual void reserve_dest(size_t num_values) = 0;
+
+            //Returns true if the destination's conversion can be deferred
+            virtual bool lazy_supported() const = 0;
+
+            //Returns the default values (calling the default provider if it has not been called)
+            const std::vector<std::string>& default_values() const;
+        private:
+            //Throws ArgParseError if a default with multiple values (or a single value) is not allowed
+            void check_default_allowed(bool multiple_values) const;
         private: //Data
+            mutable std::vector<std::string> default_value_; //Filled in by default_provider_ when first needed
+            std::shared_ptr<detail::DefaultProvider> default_provider_;
+            mutable bool default_provided_ = false; //Set once default_provider_ has been called
             std::string long_opt_;
             std::string short_opt_;
+            std::string name_;
 
             std::string help_;
             std::string metavar_;
             char nargs_ = '1';
             std::vector<std::string> choices_;
+            std::shared_ptr<const ChoiceProvider> choice_provider_;
             Action action_ = Action::STORE;
             bool required_ = false;
 
@@ -289,227 +697,325 @@ namespace argparse {
             std::string group_name_;
             ShowIn show_in_ = ShowIn::USAGE_AND_HELP;
             bool default_set_ = false;
+            size_t capacity_hint_ = 0;
+            bool lazy_ = false;
     };
 
-    template<typename T, typename Converter>
-    class SingleValueArgument : public Argument {
-        public: //Constructors
-            SingleValueArgument(ArgValue<T>& dest, std::string long_opt, std::string short_opt)
-                : Argument(long_opt, short_opt)
-                , dest_(dest)
-                {}
-        public: //Mutators
-            void set_dest_to_default() override {
-                dest_.set(Converter().from_str(default_value()), Provenance::DEFAULT);
-                dest_.set_argument_name(name());
-                dest_.set_argument_group(group_name());
-            }
-
-            void set_dest_to_value(std::string value) override {
-                if (dest_.provenance() == Provenance::SPECIFIED
-                    && dest_.argument_name() == name()) {
-                    throw ArgParseError("Argument " + name() + " specified multiple times");
+    namespace detail {
+        //Records a conversion of str by converter_type (in the parse statistics and any active trace)
+        class ConversionScope {
+            public:
+                ConversionScope(const std::type_info& converter_type, const std::string& str);
+
+                void set_failed() { span_.set_failed(); }
+            private:
+                TraceSpan span_;
+        };
+
+        //True if Converter converts to T with the StringView interface (see ConversionStatus)
+        template<typename T, typename Converter, typename = void>
+        struct is_view_converter : std::false_type {};
+
+        template<typename T, typename Converter>
+        struct is_view_converter<T,Converter,decltype(void(std::declval<Converter&>().from_str(std::declval<StringView>(), std::declval<T&>())))>
+            : std::is_same<decltype(std::declval<Converter&>().from_str(std::declval<StringView>(), std::declval<T&>())),ConversionStatus> {};
+
+        //Adapts Converter to the StringView interface.
+        //Converters with the original interface are stateless, constructed for each conversion
+        template<typename T, typename Converter, typename = void>
+        struct ConverterAdapter {
+            struct Instance {};
+
+            static ConversionStatus from_str(Instance& /*converter*/, const std::string& str, T& value, std::string* error) {
+                auto converted_value = Converter().from_str(str);
+                if (!converted_value.valid()) {
+                    if (error) *error = converted_value.error();
+                    return ConversionStatus::invalid();
                 }
-
-                dest_.set(Converter().from_str(value), Provenance::SPECIFIED);
-                dest_.set_argument_name(name());
-                dest_.set_argument_group(group_name());
+                value = std::move(converted_value).value();
+                return ConversionStatus();
             }
+        };
 
-            void add_value_to_dest(std::string /*value*/) override {
-                throw ArgParseError("Single value option can not have multiple values set");
-            }
+        template<typename T, typename Converter>
+        struct ConverterAdapter<T,Converter,typename std::enable_if<is_view_converter<T,Converter>::value>::type> {
+            typedef Converter Instance;
 
-            void set_dest_to_true() override {
-                throw ArgParseError("Non-boolean destination can not be set true");
+            static ConversionStatus from_str(Instance& converter, const std::string& str, T& value, std::string* error) {
+                ConversionStatus status = converter.from_str(StringView(str), value);
+                if (!status && error) {
+                    *error = status.message(str);
+                }
+                return status;
             }
-            void set_dest_to_false() override {
-                throw ArgParseError("Non-boolean destination can not be set false");
+        };
+
+        //The object Converter's conversions to T are performed with
+        template<typename T, typename Converter>
+        using ConverterInstance = typename ConverterAdapter<T,Converter>::Instance;
+
+        //Returns a new ConverterInstance, held by an argument and passed to its conversions.
+        //Stateless (empty) converters share a single instance, so need no allocation
+        template<typename Instance>
+        typename std::enable_if<std::is_empty<Instance>::value, std::shared_ptr<void>>::type
+        make_converter_instance() {
+            static Instance instance;
+            return std::shared_ptr<void>(std::shared_ptr<void>(), &instance);
+        }
+
+        template<typename Instance>
+        typename std::enable_if<!std::is_empty<Instance>::value, std::shared_ptr<void>>::type
+        make_converter_instance() {
+            return std::make_shared<Instance>();
+        }
+
+        //Converts str to value with converter (a ConverterInstance<T,Converter>), returning
+        //false if it fails (setting any error to the message).
+        //All conversions performed by arguments go through here.
+        template<typename T, typename Converter>
+        bool convert(void* converter, const std::string& str, T& value, std::string* error) {
+            ConversionScope scope(typeid(Converter), str);
+
+            auto& instance = *static_cast<ConverterInstance<T,Converter>*>(converter);
+            if (!ConverterAdapter<T,Converter>::from_str(instance, str, value, error)) {
+                scope.set_failed();
+                return false;
             }
-
-            bool valid_action() override {
-                //Sanity check that we aren't processing a boolean action with a non-boolean destination
-                if (action() == Action::STORE_TRUE) {
-                    std::stringstream msg;
-                    msg << "Non-boolean destination can not have STORE_TRUE action (" << long_option() << ")";
-                    throw ArgParseError(msg.str());
-                } else if (action() == Action::STORE_FALSE) {
-                    std::stringstream msg;
-                    msg << "Non-boolean destination can not have STORE_FALSE action (" << long_option() << ")";
-                    throw ArgParseError(msg.str());
-                } else if (action() != Action::STORE) {
-                    throw ArgParseError("Unexpected action (expected STORE)");
-                }
-                return true;
+            return true;
+        }
+
+        //Converts str to value with converter, throwing ArgParseConversionError if it fails
+        template<typename T, typename Converter>
+        void convert_or_throw(void* converter, const std::string& str, T& value) {
+            std::string error;
+            if (!convert<T,Converter>(converter, str, value, &error)) {
+                throw ArgParseConversionError(error);
             }
+        }
+    }
 
-            void reset_dest() override {
-                dest_ = ArgValue<T>();
-            }
+    namespace detail {
+        /*
+         * The operations on an ArgValue<T> destination which depend on T and its Converter.
+         *
+         * Each distinct T/Converter only contributes these small functions (see
+         * single_value_ops() and multi_value_ops() in argparse.tpp), while the
+         * argument classes which use them are shared by all types.
+         */
+        struct ValueOps {
+            typedef void (*StoreFlag)(ArgValueBase& dest, bool value);
 
-            bool is_valid_value(std::string value) override {
-                auto converted_value = Converter().from_str(value);
+            //Returns the converter instance passed to store and convertible (see make_converter_instance())
+            std::shared_ptr<void> (*make_converter)();
 
-                if (!converted_value) {
-                    return false;
-                }
-                return is_valid_choice(value, choices());
-            }
+            //Converts str with converter and stores it in dest (appending it for multi-value destinations).
+            //Throws ArgParseConversionError if the conversion fails
+            void (*store)(ArgValueBase& dest, const std::string& str, Provenance prov, void* converter);
 
-        private: //Data
-            ArgValue<T>& dest_;
-    };
+            //Stores str in dest to be converted (as by store) when dest is first read
+            //(null for multi-value destinations). The destination may outlive the
+            //argument, so this conversion uses its own converter
+            void (*defer)(ArgValueBase& dest, const std::string& str, Provenance prov);
 
-    //bool specialization for STORE_TRUE/STORE_FALSE
-    template<typename Converter>
-    class SingleValueArgument<bool,Converter> : public Argument {
-        public: //Constructors
-            SingleValueArgument(ArgValue<bool>& dest, std::string long_opt, std::string short_opt)
-                : Argument(long_opt, short_opt)
-                , dest_(dest)
-                {}
-        public: //Mutators
-            void set_dest_to_default() override {
-                dest_.set(Converter().from_str(default_value()), Provenance::DEFAULT);
-                dest_.set_argument_name(name());
-                dest_.set_argument_group(group_name());
-            }
+            //Returns true if str converts successfully with converter
+            bool (*convertible)(const std::string& str, void* converter);
 
-            void add_value_to_dest(std::string /*value*/) override {
-                throw ArgParseError("Single value option can not have multiple values set");
-            }
+            //Sets a boolean destination (null if the destination is not boolean)
+            StoreFlag store_flag;
 
-            void set_dest_to_value(std::string value) override {
-                if (dest_.provenance() == Provenance::SPECIFIED
-                    && dest_.argument_name() == name()) {
-                    throw ArgParseError("Argument " + name() + " specified multiple times");
-                }
+            //Adds count to an integer destination (null if the destination is not an integer)
+            void (*increment)(ArgValueBase& dest, size_t count);
 
-                dest_.set(Converter().from_str(value), Provenance::SPECIFIED);
-                dest_.set_argument_name(name());
-                dest_.set_argument_group(group_name());
-            }
+            //Removes the values of a multi-value destination (null for single-value destinations)
+            void (*clear)(ArgValueBase& dest);
 
-            void set_dest_to_true() override {
-                ConvertedValue<bool> val;
-                val.set_value(true);
+            //Resets dest to its initial state
+            void (*reset)(ArgValueBase& dest);
 
-                dest_.set(val, Provenance::SPECIFIED);
-                dest_.set_argument_name(name());
-                dest_.set_argument_group(group_name());
-            }
+            //Resets dest to its initial value, but keeps any capacity its value has allocated
+            void (*reset_keep_capacity)(ArgValueBase& dest);
 
-            void set_dest_to_false() override {
-                ConvertedValue<bool> val;
-                val.set_value(false);
+            //Reserves capacity for num_values values in dest (does nothing if its type can't reserve)
+            void (*reserve)(ArgValueBase& dest, size_t num_values);
 
-                dest_.set(val, Provenance::SPECIFIED);
-                dest_.set_argument_name(name());
-                dest_.set_argument_group(group_name());
-            }
+            //Returns the heap memory used by dest's value
+            size_t (*value_heap_bytes)(const ArgValueBase& dest);
+        };
 
-            bool valid_action() override { 
-                //Any supported action is valid on a boolean destination
-                return true; 
-            }
+        //Sets an ArgValue<bool>
+        void store_flag(ArgValueBase& dest, bool value);
 
-            void reset_dest() override {
-                dest_ = ArgValue<bool>();
-            }
+        template<typename T, typename Converter>
+        const ValueOps& single_value_ops();
 
-            bool is_valid_value(std::string value) override {
-                auto converted_value = Converter().from_str(value);
+        template<typename T, typename Converter>
+        const ValueOps& multi_value_ops();
+    }
 
-                if (!converted_value) {
-                    return false;
-                }
-                return is_valid_choice(value, choices());
-            }
+    //An argument which sets a single value
+    class SingleValueArgument : public Argument {
+        public: //Constructors
+            SingleValueArgument(ArgValueBase& dest, const detail::ValueOps& ops, std::string long_opt, std::string short_opt);
+        public: //Mutators
+            void set_dest_to_default() override;
+            void set_dest_to_value(const std::string& value) override;
+            void add_value_to_dest(const std::string& value) override;
+            void set_dest_to_true() override;
+            void set_dest_to_false() override;
+            void increment_dest(size_t count) override;
+            bool valid_action() override;
+            void reset_dest(ResetMode mode) override;
+            void resolve_dest() override;
+            bool is_valid_value(const std::string& value) override;
+        protected:
+            size_t object_size() const override;
+            size_t dest_memory_usage() const override;
+            void reserve_dest(size_t num_values) override;
+            bool lazy_supported() const override;
+        private:
+            void set_dest_to_flag(bool value);
+
+            //Stores (or, if lazy, defers converting) value
+            void store(const std::string& value, Provenance prov);
         private: //Data
-            ArgValue<bool>& dest_;
+            ArgValueBase& dest_;
+            const detail::ValueOps& ops_;
+            std::shared_ptr<void> converter_;
     };
 
-    template<typename T, typename Converter>
+    //An argument which collects multiple values
     class MultiValueArgument : public Argument {
         public: //Constructors
-            MultiValueArgument(ArgValue<T>& dest, std::string long_opt, std::string short_opt)
-                : Argument(long_opt, short_opt)
-                , dest_(dest)
-                {}
-
+            MultiValueArgument(ArgValueBase& dest, const detail::ValueOps& ops, std::string long_opt, std::string short_opt);
         public: //Mutators
-            void set_dest_to_default() override {
-                auto& target = dest_.mutable_value(Provenance::DEFAULT);
-                for (auto default_str : default_value_) {
-                    auto val = Converter().from_str(default_str);
-                    target.insert(std::end(target), val.value());
-                }
-
-                dest_.set_argument_name(name());
-                dest_.set_argument_group(group_name());
-            }
+            void set_dest_to_default() override;
+            void set_dest_to_value(const std::string& value) override;
+            void add_value_to_dest(const std::string& value) override;
+            void set_dest_to_true() override;
+            void set_dest_to_false() override;
+            void increment_dest(size_t count) override;
+            bool valid_action() override;
+            void reset_dest(ResetMode mode) override;
+            void resolve_dest() override;
+            bool is_valid_value(const std::string& value) override;
+        protected:
+            size_t object_size() const override;
+            size_t dest_memory_usage() const override;
+            void reserve_dest(size_t num_values) override;
+            bool lazy_supported() const override;
+        private: //Data
+            ArgValueBase& dest_;
+            const detail::ValueOps& ops_;
+            std::shared_ptr<void> converter_;
+    };
 
-            void set_dest_to_value(std::string /*value*/) override {
-                throw ArgParseError("Multi-value option can not be set to a single value");
-            }
+    //A boolean argument whose value is a flag of a FlagSet.
+    //Flags do not record the argument which set them
+    class FlagArgument : public Argument {
+        public: //Constructors
+            FlagArgument(FlagSet& dest, size_t flag, std::string long_opt, std::string short_opt);
+        public: //Mutators
+            void set_dest_to_default() override;
+            void set_dest_to_value(const std::string& value) override;
+            void add_value_to_dest(const std::string& value) override;
+            void set_dest_to_true() override;
+            void set_dest_to_false() override;
+            void increment_dest(size_t count) override;
+            bool valid_action() override;
+            void reset_dest(ResetMode mode) override;
+            void resolve_dest() override;
+            bool is_valid_value(const std::string& value) override;
+        protected:
+            size_t object_size() const override;
+            size_t dest_memory_usage() const override;
+            void reserve_dest(size_t num_values) override;
+            bool lazy_supported() const override;
+        private:
+            //Converts str to the flag's value (throwing ArgParseConversionError if it does not convert)
+            static bool convert_flag(const std::string& str);
+        private: //Data
+            FlagSet& dest_;
+            size_t flag_;
+    };
 
-            void add_value_to_dest(std::string value) override {
-                if (dest_.provenance() == Provenance::SPECIFIED
-                    && dest_.argument_name() != name()) {
-                    throw ArgParseError("Argument destination already set by " + dest_.argument_name() + " (trying to set from " + name() + ")");
-                }
+    namespace detail {
+        //An input of an inferred value, which remembers the input's value (and provenance)
+        //when the inferred value was last computed
+        class InferenceInput {
+            public:
+                virtual ~InferenceInput() {}
+
+                virtual const ArgValueBase& value() const = 0;
+
+                //Returns true if the input has changed since record() (or was never recorded)
+                virtual bool changed() const = 0;
+
+                //Records the input's current state
+                virtual void record() = 0;
+        };
+
+        template<typename T>
+        class TypedInferenceInput;
+    }
+
+    /*
+     * A value computed from other values (see ArgumentParser::add_inferred()).
+     *
+     * It is computed lazily, when its destination is read, and the result is
+     * memoized: it is only re-computed once one of its declared inputs changes.
+     * Inputs which are themselves inferred are brought up-to-date first.
+     */
+    class InferredValue {
+        public:
+            InferredValue(ArgValueBase& dest, std::string name_str);
+            virtual ~InferredValue() {}
 
-                auto previous_provenance = dest_.provenance();
+            //Declares that the value is computed from input.
+            //Inputs read by the computation but not declared are not checked for changes
+            template<typename T>
+            InferredValue& depends_on(const ArgValue<T>& input);
 
-                auto& target = dest_.mutable_value(Provenance::SPECIFIED);
+        public:
+            //Returns the name of the inferred value (set as its destination's argument name)
+            const std::string& name() const;
 
-                if (previous_provenance == Provenance::DEFAULT) {
-                    target.clear();
-                }
+            //Returns the destination of the value
+            const ArgValueBase& dest() const;
 
-                //Insert is more general than push_back
-                auto converted_value = Converter().from_str(value);
-                if (!converted_value) {
-                    throw ArgParseConversionError(converted_value.error());
-                }
-                target.insert(std::end(target), converted_value.value());
+            //Returns the declared inputs
+            const std::vector<std::unique_ptr<detail::InferenceInput>>& inputs() const;
 
-                dest_.set_argument_name(name());
-                dest_.set_argument_group(group_name());
-            }
+            //Returns the number of times the value has been computed
+            size_t num_computations() const;
 
-            void set_dest_to_true() override {
-                throw ArgParseError("Non-boolean destination can not be set true");
-            }
-            void set_dest_to_false() override {
-                throw ArgParseError("Non-boolean destination can not be set false");
-            }
+        public:
+            //Marks the destination to be brought up-to-date (see update()) when it is next read
+            void invalidate();
 
-            bool valid_action() override {
-                //Sanity check that we aren't processing a boolean action with a non-boolean destination
-                if (action() != Action::STORE) {
-                    throw ArgParseError("Unexpected action (expected STORE)");
-                }
-                return true;
-            }
+            //Re-computes the value if it has never been computed, or an input has changed.
+            //Throws ArgParseError if the value is (indirectly) needed to compute itself
+            void update();
 
-            void reset_dest() override {
-                dest_ = ArgValue<T>();
-            }
+        protected:
+            //Computes the value and stores it in dest
+            virtual void compute(ArgValueBase& dest) = 0;
 
-            bool is_valid_value(std::string value) override {
-                auto converted_value = Converter().from_str(value);
+            //Brings a pending destination up-to-date and drops its reference to this value, so
+            //it can still be read once this is destroyed. If that fails (e.g. compute() throws)
+            //the destination keeps its last value. Called as the concrete value is destroyed
+            void detach() noexcept;
 
-                if (!converted_value) {
-                    return false;
-                }
-                return is_valid_choice(value, choices());
-            }
-        private: //Data
-            ArgValue<T>& dest_;
+        private:
+            static void update_pending(ArgValueBase& dest, const std::string& str, void* context);
+        private:
+            ArgValueBase& dest_;
+            std::string name_;
+            std::vector<std::unique_ptr<detail::InferenceInput>> inputs_;
+            size_t num_computations_ = 0;
+            bool computed_ = false;
+            bool updating_ = false;
     };
 
-
 } //namespace
 
 #include "argparse.tpp"
@@ -1,32 +1,313 @@
-#include <sstream>
-#include "argparse_util.hpp"
 
 namespace argparse {
 
+    namespace detail {
+        template<typename T, typename Converter>
+        std::shared_ptr<void> make_converter() {
+            return make_converter_instance<ConverterInstance<T,Converter>>();
+        }
+
+        template<typename T, typename Converter>
+        struct ConvertValue {
+            static void store(ArgValueBase& dest, const std::string& str, Provenance prov, void* converter) {
+                //Converted separately, so dest is unchanged if the conversion fails
+                T value = T();
+                convert_or_throw<T,Converter>(converter, str, value);
+                static_cast<ArgValue<T>&>(dest).set(std::move(value), prov);
+            }
+
+            static bool convertible(const std::string& str, void* converter) {
+                T value = T();
+                return convert<T,Converter>(converter, str, value, nullptr);
+            }
+        };
+
+        //Strings need no conversion, so are copy-assigned (which re-uses the destination's capacity)
+        template<>
+        struct ConvertValue<std::string,DefaultConverter<std::string>> {
+            static void store(ArgValueBase& dest, const std::string& str, Provenance prov, void* /*converter*/) {
+                ConversionScope scope(typeid(DefaultConverter<std::string>), str);
+                static_cast<ArgValue<std::string>&>(dest).mutable_value(prov) = str;
+            }
+
+            static bool convertible(const std::string& str, void* /*converter*/) {
+                ConversionScope scope(typeid(DefaultConverter<std::string>), str);
+                return true;
+            }
+        };
+
+        //Converts the string of a lazy argument when its value is first read
+        template<typename T, typename Converter>
+        void convert_pending(ArgValueBase& dest, const std::string& str, void* /*context*/) {
+            try {
+                ConverterInstance<T,Converter> converter;
+                ConvertValue<T,Converter>::store(dest, str, dest.provenance(), &converter);
+            } catch (const ArgParseConversionError& e) {
+                throw ArgParseConversionError(std::string(e.what()) + " for " + dest.argument_name());
+            }
+        }
+
+        template<typename T, typename Converter>
+        void defer_value(ArgValueBase& dest, const std::string& str, Provenance prov) {
+            dest.set_pending(str, prov, &convert_pending<T,Converter>);
+        }
+
+        template<typename T, typename Converter>
+        void append_value(ArgValueBase& dest, const std::string& str, Provenance prov, void* converter) {
+            typename T::value_type value = typename T::value_type();
+            convert_or_throw<typename T::value_type,Converter>(converter, str, value);
+
+            //Insert is more general than push_back
+            auto& target = static_cast<ArgValue<T>&>(dest).mutable_value(prov);
+            target.insert(std::end(target), std::move(value));
+        }
+
+        //Only boolean destinations can be set by STORE_TRUE/STORE_FALSE
+        template<typename T>
+        constexpr ValueOps::StoreFlag store_flag_fn() { return nullptr; }
+
+        template<>
+        constexpr ValueOps::StoreFlag store_flag_fn<bool>() { return &store_flag; }
+
+        template<typename T>
+        void increment_value(ArgValueBase& dest, size_t count) {
+            auto& value_dest = static_cast<ArgValue<T>&>(dest);
+            value_dest.resolve_pending(); //Counting starts from any (lazy) default
+            value_dest.mutable_value(Provenance::SPECIFIED) += static_cast<T>(count);
+        }
+
+        //Only (non-boolean) integer destinations can be counted
+        template<typename T>
+        constexpr auto increment_fn() -> typename std::enable_if<std::is_integral<T>::value && !std::is_same<T,bool>::value,
+                                                                 void (*)(ArgValueBase&, size_t)>::type {
+            return &increment_value<T>;
+        }
+
+        template<typename T>
+        constexpr auto increment_fn() -> typename std::enable_if<!std::is_integral<T>::value || std::is_same<T,bool>::value,
+                                                                 void (*)(ArgValueBase&, size_t)>::type {
+            return nullptr;
+        }
+
+        template<typename T>
+        void clear_values(ArgValueBase& dest) {
+            static_cast<ArgValue<T>&>(dest).mutable_value(dest.provenance()).clear();
+        }
+
+        template<typename T>
+        void reset_value(ArgValueBase& dest) {
+            //Swap (rather than move-assign, which may keep a string's buffer) so the old value's memory is released
+            ArgValue<T> initial;
+            std::swap(static_cast<ArgValue<T>&>(dest), initial);
+        }
+
+        //Clears value, keeping its capacity if it has a clear() (e.g. strings and containers)
+        template<typename T>
+        auto clear_keeping_capacity(T& value, int) -> decltype(value.clear(), void()) { value.clear(); }
+
+        template<typename T>
+        void clear_keeping_capacity(T& value, long) { value = T(); }
+
+        template<typename T>
+        void reset_value_keep_capacity(ArgValueBase& dest) {
+            clear_keeping_capacity(static_cast<ArgValue<T>&>(dest).mutable_value(Provenance::UNSPECIFIED), 0);
+            dest.clear_metadata();
+        }
+
+        //Reserves capacity for num_values in value if it has a reserve()
+        template<typename T>
+        auto reserve_capacity(T& value, size_t num_values, int) -> decltype(value.reserve(num_values), void()) { value.reserve(num_values); }
+
+        template<typename T>
+        void reserve_capacity(T& /*value*/, size_t /*num_values*/, long) {}
+
+        template<typename T>
+        void reserve_value(ArgValueBase& dest, size_t num_values) {
+            auto& value_dest = static_cast<ArgValue<T>&>(dest);
+            reserve_capacity(value_dest.mutable_value(value_dest.provenance()), num_values, 0);
+        }
+
+        template<typename T>
+        size_t value_heap_bytes(const ArgValueBase& dest) {
+            //Don't trigger a pending conversion (its string is counted instead)
+            if (dest.conversion_pending()) {
+                return heap_bytes(dest.pending_str());
+            }
+            return heap_bytes(static_cast<const ArgValue<T>&>(dest).value());
+        }
+
+        template<typename T, typename Converter>
+        const ValueOps& single_value_ops() {
+            static constexpr ValueOps ops = {
+                &make_converter<T,Converter>,
+                &ConvertValue<T,Converter>::store,
+                &defer_value<T,Converter>,
+                &ConvertValue<T,Converter>::convertible,
+                store_flag_fn<T>(),
+                increment_fn<T>(),
+                nullptr,
+                &reset_value<T>,
+                &reset_value_keep_capacity<T>,
+                &reserve_value<T>,
+                &value_heap_bytes<T>
+            };
+            return ops;
+        }
+
+        //T is the vector type, Converter converts its elements
+        template<typename T, typename Converter>
+        const ValueOps& multi_value_ops() {
+            static constexpr ValueOps ops = {
+                &make_converter<typename T::value_type,Converter>,
+                &append_value<T,Converter>,
+                nullptr,
+                &ConvertValue<typename T::value_type,Converter>::convertible,
+                nullptr,
+                nullptr,
+                &clear_values<T>,
+                &reset_value<T>,
+                &reset_value_keep_capacity<T>,
+                &reserve_value<T>,
+                &value_heap_bytes<T>
+            };
+            return ops;
+        }
+    }
+
+    namespace detail {
+        template<typename T>
+        class TypedInferenceInput : public InferenceInput {
+            public:
+                TypedInferenceInput(const ArgValue<T>& input)
+                    : input_(input) {}
+
+                const ArgValueBase& value() const override { return input_; }
+
+                bool changed() const override {
+                    return !recorded_
+                           || input_.provenance() != provenance_
+                           || !(input_.value() == value_);
+                }
+
+                void record() override {
+                    value_ = input_.value();
+                    provenance_ = input_.provenance();
+                    recorded_ = true;
+                }
+            private:
+                const ArgValue<T>& input_;
+                T value_ = T();
+                Provenance provenance_ = Provenance::UNSPECIFIED;
+                bool recorded_ = false;
+        };
+
+        template<typename T, typename Compute>
+        class TypedInferredValue : public InferredValue {
+            public:
+                TypedInferredValue(ArgValue<T>& dest, std::string name_str, Compute compute_fn)
+                    : InferredValue(dest, name_str)
+                    , compute_(std::move(compute_fn)) {}
+                ~TypedInferredValue() override { detach(); }
+            protected:
+                void compute(ArgValueBase& dest) override {
+                    static_cast<ArgValue<T>&>(dest).set(compute_(), Provenance::INFERRED);
+                }
+            private:
+                Compute compute_;
+        };
+
+        inline std::vector<std::string> default_strings(std::string value) {
+            return std::vector<std::string>(1, std::move(value));
+        }
+
+        inline std::vector<std::string> default_strings(std::vector<std::string> values) {
+            return values;
+        }
+
+        template<typename Provider>
+        class TypedDefaultProvider : public DefaultProvider {
+            public:
+                explicit TypedDefaultProvider(Provider provider)
+                    : provider_(std::move(provider)) {}
+
+                std::vector<std::string> provide() override {
+                    return default_strings(provider_());
+                }
+            private:
+                Provider provider_;
+        };
+
+        template<typename BuildParser>
+        class TypedSubcommandFactory : public SubcommandFactory {
+            public:
+                explicit TypedSubcommandFactory(BuildParser build_parser)
+                    : build_parser_(std::move(build_parser)) {}
+
+                void build(ArgumentParser& parser) override {
+                    build_parser_(parser);
+                }
+            private:
+                BuildParser build_parser_;
+        };
+    }
+
+    namespace detail {
+        //Returns the (static) provider of a range of choices with a provider() member (e.g. EnumChoices),
+        //or null if it has none
+        template<typename Choices>
+        auto default_choice_provider(const Choices& choices, int) -> decltype(choices.provider()) {
+            return choices.provider();
+        }
+
+        template<typename Choices>
+        const ChoiceProvider* default_choice_provider(const Choices& /*choices*/, long) {
+            return nullptr;
+        }
+
+        //Sets a converter's (non-empty) default choices as arg's choices: a std::vector<std::string>,
+        //or any range of strings, which is copied unless it has a provider (see default_choice_provider())
+        inline void set_default_choices(Argument& arg, std::vector<std::string> choices) {
+            if (!choices.empty()) {
+                arg.choices(std::move(choices));
+            }
+        }
+
+        template<typename Choices>
+        void set_default_choices(Argument& arg, const Choices& choices) {
+            if (const ChoiceProvider* provider = default_choice_provider(choices, 0)) {
+                //The provider is static, so is not owned
+                arg.choice_provider(std::shared_ptr<const ChoiceProvider>(std::shared_ptr<const ChoiceProvider>(), provider));
+                return;
+            }
+            if (choices.empty()) return;
+
+            std::vector<std::string> strs;
+            strs.reserve(choices.size());
+            for (const auto& choice : choices) {
+                strs.emplace_back(choice);
+            }
+            arg.choices(std::move(strs));
+        }
+    }
+
     template<typename T, typename Converter>
     std::shared_ptr<Argument> make_singlevalue_argument(ArgValue<T>& dest, std::string long_opt, std::string short_opt) {
-        auto ptr = std::make_shared<SingleValueArgument<T, Converter>>(dest, long_opt, short_opt);
+        auto ptr = std::make_shared<SingleValueArgument>(dest, detail::single_value_ops<T,Converter>(), long_opt, short_opt);
 
         //If the conversion object specifies a non-empty set of choices
         //use those by default
-        auto default_choices = Converter().default_choices();
-        if (!default_choices.empty()) {
-            ptr->choices(default_choices);
-        }
+        detail::set_default_choices(*ptr, Converter().default_choices());
 
         return ptr;
     }
 
     template<typename T, typename Converter>
     std::shared_ptr<Argument> make_multivalue_argument(ArgValue<T>& dest, std::string long_opt, std::string short_opt) {
-        auto ptr = std::make_shared<MultiValueArgument<T, Converter>>(dest, long_opt, short_opt);
+        auto ptr = std::make_shared<MultiValueArgument>(dest, detail::multi_value_ops<T,Converter>(), long_opt, short_opt);
 
         //If the conversion object specifies a non-empty set of choices
         //use those by default
-        auto default_choices = Converter().default_choices();
-        if (!default_choices.empty()) {
-            ptr->choices(default_choices);
-        }
+        detail::set_default_choices(*ptr, Converter().default_choices());
 
         return ptr;
     }
@@ -54,6 +335,56 @@ namespace argparse {
     Argument& ArgumentParser::add_argument(ArgValue<std::vector<T>>& dest, std::string long_opt, std::string short_opt) {
         return argument_groups_[0].add_argument<T,Converter>(dest, long_opt, short_opt);
     }
+    template<typename AddOptions>
+    ArgumentGroup& ArgumentParser::add_module(std::string module_name, AddOptions add_options) {
+        //Options registered so far are checked first, so conflicts are attributed to the module
+        register_options();
+
+        argument_groups_.push_back(ArgumentGroup(module_name));
+        argument_groups_.back().mutable_data().module_name = module_name;
+        try {
+            add_options(argument_groups_.back());
+        } catch (...) {
+            //Remove the partially added module, as on a conflict (see register_options())
+            argument_groups_.pop_back();
+            throw;
+        }
+
+        register_options();
+        return argument_groups_.back();
+    }
+
+    template<typename T, typename Compute>
+    InferredValue& ArgumentParser::add_inferred(ArgValue<T>& dest, std::string name, Compute compute) {
+        inferred_values_.emplace_back(new detail::TypedInferredValue<T,Compute>(dest, name, std::move(compute)));
+
+        auto& inferred = *inferred_values_.back();
+        inferred.invalidate();
+        return inferred;
+    }
+
+    template<typename BuildParser>
+    ArgumentParser& ArgumentParser::add_subcommand(std::string name, std::string help, BuildParser build_parser) {
+        std::unique_ptr<detail::SubcommandFactory> factory(new detail::TypedSubcommandFactory<BuildParser>(std::move(build_parser)));
+        insert_subcommand(name, help, std::move(factory));
+        return *this;
+    }
+
+    /*
+     * Argument
+     */
+    template<typename Provider, typename>
+    Argument& Argument::default_value(Provider provider) {
+        typedef decltype(provider()) Result;
+        check_default_allowed(!std::is_convertible<Result,std::string>::value);
+
+        default_value_.clear();
+        default_provider_ = std::make_shared<detail::TypedDefaultProvider<Provider>>(std::move(provider));
+        default_provided_ = false;
+        default_set_ = true;
+        return *this;
+    }
+
     /*
      * ArgumentGroup
      */
@@ -64,9 +395,10 @@ namespace argparse {
 
     template<typename T, typename Converter>
     Argument& ArgumentGroup::add_argument(ArgValue<T>& dest, std::string long_opt, std::string short_opt) {
-        arguments_.push_back(make_singlevalue_argument<T,Converter>(dest, long_opt, short_opt));
+        auto& arguments = mutable_data().arguments;
+        arguments.push_back(make_singlevalue_argument<T,Converter>(dest, long_opt, short_opt));
 
-        auto& arg = arguments_[arguments_.size() - 1];
+        auto& arg = arguments[arguments.size() - 1];
         arg->group_name(name()); //Tag the option with the group
         return *arg;
     }
@@ -78,11 +410,22 @@ namespace argparse {
 
     template<typename T, typename Converter>
     Argument& ArgumentGroup::add_argument(ArgValue<std::vector<T>>& dest, std::string long_opt, std::string short_opt) {
-        arguments_.push_back(make_multivalue_argument<std::vector<T>,Converter>(dest, long_opt, short_opt));
+        auto& arguments = mutable_data().arguments;
+        arguments.push_back(make_multivalue_argument<std::vector<T>,Converter>(dest, long_opt, short_opt));
 
-        auto& arg = arguments_[arguments_.size() - 1];
+        auto& arg = arguments[arguments.size() - 1];
         arg->group_name(name()); //Tag the option with the group
         return *arg;
     }
 
+    /*
+     * InferredValue
+     */
+    template<typename T>
+    InferredValue& InferredValue::depends_on(const ArgValue<T>& input) {
+        inputs_.emplace_back(new detail::TypedInferenceInput<T>(input));
+        invalidate();
+        return *this;
+    }
+
 } //namespace
@@ -0,0 +1,137 @@
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#   include <memory>
+#else
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+
+#include "argparse_choices.hpp"
+#include "argparse_error.hpp"
+#include "argparse_instrument.hpp"
+
+namespace argparse {
+
+    /*
+     * SortedFileChoices
+     */
+    SortedFileChoices::SortedFileChoices(std::string filename)
+        : filename_(filename) {}
+
+    SortedFileChoices::~SortedFileChoices() {
+#ifndef _WIN32
+        if (mapped_) {
+            ::munmap(const_cast<char*>(data_), size_);
+            return;
+        }
+#endif
+        delete[] data_;
+    }
+
+    bool SortedFileChoices::contains(const std::string& str) const {
+        load();
+
+        //Binary search of the lines within [begin, end), which both fall on line starts.
+        //Each probe compares str with the line containing the midpoint
+        size_t begin = 0;
+        size_t end = size_;
+        while (begin < end) {
+            size_t mid = begin + (end - begin) / 2;
+
+            size_t line_begin = mid;
+            while (line_begin > begin && data_[line_begin - 1] != '\n') {
+                --line_begin;
+            }
+            const void* newline = std::memchr(data_ + mid, '\n', end - mid);
+            size_t line_end = newline ? static_cast<size_t>(static_cast<const char*>(newline) - data_) : end;
+
+            //Tolerate Windows line endings
+            size_t line_size = line_end - line_begin;
+            if (line_size > 0 && data_[line_end - 1] == '\r') {
+                --line_size;
+            }
+
+            int cmp = str.compare(0, std::string::npos, data_ + line_begin, line_size);
+            if (cmp == 0) {
+                return true;
+            } else if (cmp > 0) {
+                begin = line_end + 1;
+            } else {
+                end = line_begin;
+            }
+        }
+        return false;
+    }
+
+    std::string SortedFileChoices::description() const {
+        return "the names in " + filename_;
+    }
+
+    size_t SortedFileChoices::memory_usage() const {
+        size_t bytes = heap_bytes(filename_);
+        if (!mapped_) {
+            bytes += size_;
+        }
+        return bytes;
+    }
+
+    bool SortedFileChoices::loaded() const { return loaded_; }
+
+    void SortedFileChoices::load() const {
+        if (loaded_) return;
+
+#ifdef _WIN32
+        //No mmap(), so read the file
+        std::FILE* file = std::fopen(filename_.c_str(), "rb");
+        if (!file) {
+            throw ArgParseError("Failed to open choices file '" + filename_ + "'");
+        }
+        std::fseek(file, 0, SEEK_END);
+        long file_size = std::ftell(file);
+        std::fseek(file, 0, SEEK_SET);
+
+        std::unique_ptr<char[]> buffer(new char[file_size > 0 ? file_size : 1]);
+        size_t num_read = std::fread(buffer.get(), 1, static_cast<size_t>(file_size), file);
+        std::fclose(file);
+        if (file_size < 0 || num_read != static_cast<size_t>(file_size)) {
+            throw ArgParseError("Failed to read choices file '" + filename_ + "'");
+        }
+        data_ = buffer.release();
+        size_ = num_read;
+#else
+        int fd = ::open(filename_.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw ArgParseError("Failed to open choices file '" + filename_ + "'");
+        }
+
+        struct stat file_stat;
+        if (::fstat(fd, &file_stat) != 0) {
+            ::close(fd);
+            throw ArgParseError("Failed to read choices file '" + filename_ + "'");
+        }
+
+        size_t file_size = static_cast<size_t>(file_stat.st_size);
+        if (file_size > 0) {
+            void* mapping = ::mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+            if (mapping == MAP_FAILED) {
+                throw ArgParseError("Failed to map choices file '" + filename_ + "'");
+            }
+            //Binary search touches few, scattered pages
+            ::posix_madvise(mapping, file_size, POSIX_MADV_RANDOM);
+
+            data_ = static_cast<const char*>(mapping);
+            size_ = file_size;
+            mapped_ = true;
+        } else {
+            ::close(fd);
+        }
+#endif
+        loaded_ = true;
+    }
+
+} //namespace
@@ -0,0 +1,79 @@
+#ifndef ARGPARSE_CHOICES_HPP
+#define ARGPARSE_CHOICES_HPP
+#include <cstddef>
+#include <string>
+
+namespace argparse {
+
+    /*
+     * ChoiceProvider defines the valid choices of an argument's value in place of a list
+     * of strings (see Argument::choice_provider()), for sets too large to pass to
+     * Argument::choices(), such as names read from a library file, or which are already
+     * stored elsewhere, such as the names of an EnumConverter.
+     *
+     * Providers are expected to load their choices when first asked to check a value,
+     * so programs which never check one never pay for loading them.
+     *
+     * A converter's default_choices() may also return a range of strings with a provider()
+     * member returning a (static) const ChoiceProvider*, as EnumChoices does, which
+     * arguments then use instead of copying the strings.
+     */
+    class ChoiceProvider {
+        public:
+            virtual ~ChoiceProvider() {}
+
+            //Returns true if str is a valid choice.
+            //Throws ArgParseError if the choices can not be loaded
+            virtual bool contains(const std::string& str) const = 0;
+
+            //Describes the choices in error messages (e.g. "the names in cells.txt")
+            virtual std::string description() const = 0;
+
+            //Returns the heap memory used by the provider
+            virtual size_t memory_usage() const = 0;
+
+            //Returns the number of choices listed in the usage, help and error messages.
+            //By default none are (as for sets too large to list)
+            virtual size_t num_listed() const { return 0; }
+
+            //Returns listed choice i (for i < num_listed())
+            virtual const char* listed(size_t /*i*/) const { return ""; }
+    };
+
+    /*
+     * The choices listed in a file, one per line, sorted in increasing (byte-wise) order.
+     *
+     * The file is memory-mapped (read into memory on platforms without mmap()) when first
+     * needed, and each value checked with a binary search of its lines, so no per-choice
+     * memory is allocated however many choices there are.
+     */
+    class SortedFileChoices : public ChoiceProvider {
+        public:
+            explicit SortedFileChoices(std::string filename);
+            ~SortedFileChoices();
+
+            SortedFileChoices(const SortedFileChoices&) = delete;
+            SortedFileChoices& operator=(const SortedFileChoices&) = delete;
+
+            bool contains(const std::string& str) const override;
+            std::string description() const override;
+            size_t memory_usage() const override;
+
+            //Returns true if the file has been loaded
+            bool loaded() const;
+        private:
+            //Maps (or reads) the file, if not already done.
+            //Throws ArgParseError if it can not be
+            void load() const;
+        private:
+            std::string filename_;
+
+            //The file's contents (set by load())
+            mutable const char* data_ = nullptr;
+            mutable size_t size_ = 0;
+            mutable bool loaded_ = false;
+            mutable bool mapped_ = false; //Set if data_ is a mapping (rather than allocated)
+    };
+
+} //namespace
+#endif
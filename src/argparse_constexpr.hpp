@@ -0,0 +1,48 @@
+#ifndef ARGPARSE_CONSTEXPR_HPP
+#define ARGPARSE_CONSTEXPR_HPP
+#include <cstddef>
+#include <cstdint>
+
+namespace argparse {
+
+    /*
+     * String functions usable in constant expressions, shared by the compile-time
+     * parsers (argparse_static.hpp) and converters (argparse_enum_converter.hpp)
+     */
+    namespace detail {
+        constexpr size_t static_strlen(const char* str) {
+            size_t len = 0;
+            while (str[len] != '\0') ++len;
+            return len;
+        }
+
+        constexpr bool static_streq(const char* lhs, size_t lhs_len, const char* rhs, size_t rhs_len) {
+            if (lhs_len != rhs_len) return false;
+            for (size_t i = 0; i < lhs_len; ++i) {
+                if (lhs[i] != rhs[i]) return false;
+            }
+            return true;
+        }
+
+        constexpr bool static_streq(const char* lhs, const char* rhs) {
+            return static_streq(lhs, static_strlen(lhs), rhs, static_strlen(rhs));
+        }
+
+        //Seeded FNV-1a hash
+        constexpr uint32_t static_hash(const char* str, size_t len, uint32_t seed) {
+            uint32_t hash = 2166136261u ^ seed;
+            for (size_t i = 0; i < len; ++i) {
+                hash ^= static_cast<unsigned char>(str[i]);
+                hash *= 16777619u;
+            }
+
+            //Mix the high bits into the low bits (which select the slot)
+            hash ^= hash >> 16;
+            hash *= 0x85ebca6bu;
+            hash ^= hash >> 13;
+            return hash;
+        }
+    }
+
+} //namespace
+#endif
@@ -0,0 +1,266 @@
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <locale.h>
+#include <stdlib.h>
+#ifdef __APPLE__
+#   include <xlocale.h>
+#endif
+#include <istream>
+#include <limits>
+#include <new>
+#include <sstream>
+#include <streambuf>
+#include "argparse.hpp"
+#include "argparse_util.hpp"
+
+namespace argparse {
+
+namespace detail {
+    namespace {
+        //A read-only stream buffer over the characters of a StringView (so they need not be copied)
+        class ViewStreamBuf : public std::streambuf {
+            public:
+                void set_view(StringView str) {
+                    char* begin = const_cast<char*>(str.data());
+                    setg(begin, begin, begin + str.size());
+                }
+        };
+
+        bool extract_all(std::istream& is, void (*extract)(std::istream&, void*), void* value) {
+            extract(is, value);
+
+            bool eof = is.eof();
+            bool fail = is.fail();
+            return eof && !fail;
+        }
+    }
+
+    bool stream_from_str(StringView str, void (*extract)(std::istream&, void*), void* value) {
+        //Constructing a stream allocates, so each thread re-uses one (re-pointing its buffer
+        //at str). A user-defined operator>> may itself convert, so nested conversions fall
+        //back to a new stream
+        thread_local ViewStreamBuf reused_buf;
+        thread_local std::istream reused_is(&reused_buf);
+        thread_local bool reused_is_busy = false;
+
+        //A user-defined operator>> may also change the stream's format (e.g. with std::hex),
+        //so it is restored from a stream which is never extracted from before each use
+        thread_local const std::istream pristine_is(nullptr);
+
+        if (reused_is_busy) {
+            ViewStreamBuf buf;
+            buf.set_view(str);
+            std::istream is(&buf);
+            return extract_all(is, extract, value);
+        }
+
+        reused_is_busy = true;
+        reused_buf.set_view(str);
+        reused_is.copyfmt(pristine_is);
+        reused_is.clear();
+        bool ok = false;
+        try {
+            ok = extract_all(reused_is, extract, value);
+        } catch (...) {
+            reused_is_busy = false;
+            throw;
+        }
+        reused_is_busy = false;
+        return ok;
+    }
+
+    bool stream_to_str(std::string& str, void (*insert)(std::ostream&, const void*), const void* value) {
+        std::stringstream ss;
+        insert(ss, value);
+
+        bool converted_ok = ss.eof() && !ss.fail();
+        str = ss.str();
+        return converted_ok;
+    }
+
+    namespace {
+        //Converts str with strto (e.g. std::strtod), returning true if it consumed all of str
+        template<typename T>
+        bool floating_from_str(StringView str, T (*strto)(const char*, char**), T& value) {
+            //operator>> only accepts decimal digits, signs, points and exponents (after leading
+            //whitespace), whereas strtod() also accepts e.g. 'inf', 'nan' and hexadecimal
+            if (str.find_first_not_of(" \t\n\v\f\r0123456789+-.eE") != StringView::npos) {
+                return false;
+            }
+
+            //strto needs a null-terminated string, so the view is copied (to the stack unless long)
+            char short_buf[64];
+            std::string long_buf;
+            const char* begin = short_buf;
+            if (str.size() < sizeof(short_buf)) {
+                std::memcpy(short_buf, str.data(), str.size());
+                short_buf[str.size()] = '\0';
+            } else {
+                long_buf = str.str();
+                begin = long_buf.c_str();
+            }
+
+            char* end = nullptr;
+            errno = 0;
+            T converted = strto(begin, &end);
+            if (end == begin || static_cast<size_t>(end - begin) != str.size()) {
+                return false;
+            }
+            if (errno == ERANGE && (converted == std::numeric_limits<T>::infinity() || converted == -std::numeric_limits<T>::infinity())) {
+                return false; //Overflow
+            }
+            value = converted;
+            return true;
+        }
+
+        //strtod() and friends follow the C locale set by setlocale() (which may use ',' as the
+        //decimal point), whereas operator>> does not, so they are called with a cached "C" locale
+#ifdef _WIN32
+        _locale_t c_numeric_locale() {
+            static _locale_t locale = _create_locale(LC_NUMERIC, "C");
+            return locale;
+        }
+
+        float strtof_fn(const char* str, char** end) { return _strtof_l(str, end, c_numeric_locale()); }
+        double strtod_fn(const char* str, char** end) { return _strtod_l(str, end, c_numeric_locale()); }
+        long double strtold_fn(const char* str, char** end) { return _strtold_l(str, end, c_numeric_locale()); }
+#else
+        locale_t c_numeric_locale() {
+            static locale_t locale = newlocale(LC_NUMERIC_MASK, "C", static_cast<locale_t>(0));
+            return locale;
+        }
+
+        float strtof_fn(const char* str, char** end) { return strtof_l(str, end, c_numeric_locale()); }
+        double strtod_fn(const char* str, char** end) { return strtod_l(str, end, c_numeric_locale()); }
+        long double strtold_fn(const char* str, char** end) { return strtold_l(str, end, c_numeric_locale()); }
+#endif
+    }
+
+    bool value_from_str(StringView str, float& value) { return floating_from_str(str, &strtof_fn, value); }
+    bool value_from_str(StringView str, double& value) { return floating_from_str(str, &strtod_fn, value); }
+    bool value_from_str(StringView str, long double& value) { return floating_from_str(str, &strtold_fn, value); }
+
+    std::string invalid_conversion_message(StringView str, StringView type_description) {
+        std::string msg = "Invalid conversion from '";
+        msg.append(str.data(), str.size());
+        msg += "'";
+        if (!type_description.empty()) {
+            msg += " to ";
+            msg.append(type_description.data(), type_description.size());
+        }
+        return msg;
+    }
+
+    namespace {
+        //Returns true if str equals lower_str, ignoring the case of str
+        bool equals_lower(StringView str, const char* lower_str) {
+            size_t i = 0;
+            for (; i < str.size() && lower_str[i] != '\0'; ++i) {
+                if (::tolower(static_cast<unsigned char>(str[i])) != lower_str[i]) return false;
+            }
+            return i == str.size() && lower_str[i] == '\0';
+        }
+
+        //Copies str to a new (null-terminated) string, which the caller frees with free()
+        //(as for strdup())
+        char* strdup_view(StringView str) {
+            char* res = static_cast<char*>(std::malloc(str.size() + 1));
+            if (!res) throw std::bad_alloc();
+            std::memcpy(res, str.data(), str.size());
+            res[str.size()] = '\0';
+            return res;
+        }
+    }
+
+    ARGPARSE_STREAM_VALUE_TYPES(ARGPARSE_STREAM_VALUE_INSTANTIATIONS, )
+}
+
+/*
+ * ConversionStatus
+ */
+std::string ConversionStatus::message(StringView str) const {
+    if (kind_ == Kind::INVALID) {
+        return detail::invalid_conversion_message(str, text_);
+    } else if (kind_ == Kind::UNEXPECTED) {
+        std::string msg = "Unexpected value '";
+        msg.append(str.data(), str.size());
+        msg += "' (expected ";
+        msg += text_;
+        msg += ")";
+        return msg;
+    }
+    return std::string();
+}
+
+/*
+ * DefaultConverter<bool>
+ */
+ConversionStatus DefaultConverter<bool>::from_str(StringView str, bool& value) {
+    if (detail::equals_lower(str, "0") || detail::equals_lower(str, "false")) {
+        value = false;
+    } else if (detail::equals_lower(str, "1") || detail::equals_lower(str, "true")) {
+        value = true;
+    } else {
+        return ConversionStatus::unexpected("one of: true, false");
+    }
+    return ConversionStatus();
+}
+
+ConvertedValue<std::string> DefaultConverter<bool>::to_str(bool val) {
+    ConvertedValue<std::string> converted_value;
+    if (val) converted_value.set_value("true");
+    else     converted_value.set_value("false");
+    return converted_value;
+}
+
+/*
+ * DefaultConverter<std::string>
+ */
+ConversionStatus DefaultConverter<std::string>::from_str(StringView str, std::string& value) {
+    value.assign(str.data(), str.size());
+    return ConversionStatus();
+}
+
+ConvertedValue<std::string> DefaultConverter<std::string>::from_str(std::string str) {
+    ConvertedValue<std::string> converted_value;
+    converted_value.set_value(std::move(str));
+    return converted_value;
+}
+
+ConvertedValue<std::string> DefaultConverter<std::string>::to_str(std::string val) {
+    ConvertedValue<std::string> converted_value;
+    converted_value.set_value(std::move(val));
+    return converted_value;
+}
+
+/*
+ * DefaultConverter<const char*>
+ */
+ConversionStatus DefaultConverter<const char*>::from_str(StringView str, const char*& value) {
+    value = detail::strdup_view(str);
+    return ConversionStatus();
+}
+
+ConvertedValue<std::string> DefaultConverter<const char*>::to_str(const char* val) {
+    ConvertedValue<std::string> converted_value;
+    converted_value.set_value(val);
+    return converted_value;
+}
+
+/*
+ * DefaultConverter<char*>
+ */
+ConversionStatus DefaultConverter<char*>::from_str(StringView str, char*& value) {
+    value = detail::strdup_view(str);
+    return ConversionStatus();
+}
+
+ConvertedValue<std::string> DefaultConverter<char*>::to_str(const char* val) {
+    ConvertedValue<std::string> converted_value;
+    converted_value.set_value(val);
+    return converted_value;
+}
+
+} //namespace
@@ -1,86 +1,198 @@
 #ifndef ARGPARSE_DEFAULT_CONVERTER_HPP
 #define ARGPARSE_DEFAULT_CONVERTER_HPP
-#include <sstream>
+#include <iosfwd>
+#include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
-#include <typeinfo>
 #include "argparse_error.hpp"
-#include "argparse_util.hpp"
+#include "argparse_string_view.hpp"
 #include "argparse_value.hpp"
 
 namespace argparse {
 
+namespace detail {
+    /*
+     * Get a useful description of the argument type
+     */
+    //Signed Integer
+    template<typename T>
+    constexpr typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value, const char*>::type
+    arg_type_name() { return "integer"; }
+
+    //Unsigned Integer
+    template<typename T>
+    constexpr typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value, const char*>::type
+    arg_type_name() { return "non-negative integer"; }
+
+    //Float
+    template<typename T>
+    constexpr typename std::enable_if<std::is_floating_point<T>::value, const char*>::type
+    arg_type_name() { return "float"; }
+
+    //Unkown
+    template<typename T>
+    constexpr typename std::enable_if<!std::is_floating_point<T>::value && !std::is_integral<T>::value, const char*>::type
+    arg_type_name() { return ""; } //Empty
+}
+
+template<typename T>
+std::string arg_type() { return detail::arg_type_name<T>(); }
+
 /*
- * Get a useful description of the argument type
+ * ConversionStatus is the result of a converter's from_str() in the StringView
+ * interface, which converts a non-owning view of the argument string into a
+ * value provided by the caller:
+ *
+ *     ConversionStatus from_str(argparse::StringView str, T& value);
+ *
+ * Such a converter is constructed once per argument and re-used for each of its
+ * conversions, so it may keep state between them. Failures are described by static
+ * text, and the error message is only formatted (by message()) when it is reported,
+ * so a conversion need not allocate.
+ *
+ * Converters with the original interface, ConvertedValue<T> from_str(std::string),
+ * are still supported (and constructed for each conversion).
  */
-//Signed Integer
-template<typename T>
-typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value, std::string>::type
-arg_type() { return "integer"; }
+class ConversionStatus {
+    public:
+        //A successful conversion
+        constexpr ConversionStatus() {}
 
-//Unsigned Integer
-template<typename T>
-typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value, std::string>::type
-arg_type() { return "non-negative integer"; }
+        //A failed conversion of a string which is not a valid type_description (e.g. "integer"),
+        //reported as "Invalid conversion from 'str' to integer"
+        static constexpr ConversionStatus invalid(const char* type_description="") {
+            return ConversionStatus(Kind::INVALID, type_description);
+        }
 
-//Float
-template<typename T>
-typename std::enable_if<std::is_floating_point<T>::value, std::string>::type
-arg_type() { return "float"; }
+        //A failed conversion of a string which is not one of the expected values (e.g. "one of: on, off"),
+        //reported as "Unexpected value 'str' (expected one of: on, off)"
+        static constexpr ConversionStatus unexpected(const char* expected) {
+            return ConversionStatus(Kind::UNEXPECTED, expected);
+        }
 
-//Unkown
-template<typename T>
-typename std::enable_if<!std::is_floating_point<T>::value && !std::is_integral<T>::value, std::string>::type
-arg_type() { return ""; } //Empty
+        constexpr bool valid() const { return kind_ == Kind::VALID; }
+        constexpr explicit operator bool() const { return valid(); }
+
+        //Returns the error message for a failed conversion of str
+        std::string message(StringView str) const;
+
+    private:
+        enum class Kind {
+            VALID,
+            INVALID,
+            UNEXPECTED
+        };
+
+        constexpr ConversionStatus(Kind kind, const char* text) : kind_(kind), text_(text) {}
+    private:
+        Kind kind_ = Kind::VALID;
+        const char* text_ = "";
+};
+
+namespace detail {
+    //Converts str with the StringView interface of converter, returning the result
+    //as the original interface does
+    template<typename T, typename Converter>
+    ConvertedValue<T> converted_value_from_str(Converter& converter, StringView str) {
+        T value = T();
+        ConversionStatus status = converter.from_str(str, value);
+
+        ConvertedValue<T> converted_value;
+        if (status) {
+            converted_value.set_value(std::move(value));
+        } else {
+            converted_value.set_error(status.message(str));
+        }
+        return converted_value;
+    }
+
+    //Reads a value of type T from is with operator>>
+    template<typename T>
+    void extract_value(std::istream& is, void* value) { is >> *static_cast<T*>(value); }
+
+    //Writes a value of type T to os with operator<<
+    template<typename T>
+    void insert_value(std::ostream& os, const void* value) { os << *static_cast<const T*>(value); }
+
+    //Reads value from str with extract, returning true if it succeeded and consumed all of str
+    bool stream_from_str(StringView str, void (*extract)(std::istream&, void*), void* value);
+
+    //Writes value to str with insert, returning true if it succeeded
+    bool stream_to_str(std::string& str, void (*insert)(std::ostream&, const void*), const void* value);
+
+    //Converts str to value, returning true if it succeeded and consumed all of str
+    template<typename T>
+    typename std::enable_if<!std::is_floating_point<T>::value, bool>::type
+    value_from_str(StringView str, T& value) { return stream_from_str(str, &extract_value<T>, &value); }
+
+    //Extracting floating-point values from a stream allocates, so they are converted with strtod()
+    //and friends instead (accepting the same strings as operator>>)
+    bool value_from_str(StringView str, float& value);
+    bool value_from_str(StringView str, double& value);
+    bool value_from_str(StringView str, long double& value);
+
+    //Returns the error message for a failed conversion of str to type_description (if non-empty)
+    std::string invalid_conversion_message(StringView str, StringView type_description);
+
+    //The stream operators of the arithmetic types are members of the (complete) stream
+    //classes, so they are instantiated in the library (argparse_default_converter.cpp).
+    //This lets this header get by with <iosfwd>
+    #define ARGPARSE_STREAM_VALUE_TYPES(M, EXTERN) \
+        M(EXTERN, char) \
+        M(EXTERN, signed char) \
+        M(EXTERN, unsigned char) \
+        M(EXTERN, short) \
+        M(EXTERN, unsigned short) \
+        M(EXTERN, int) \
+        M(EXTERN, unsigned int) \
+        M(EXTERN, long) \
+        M(EXTERN, unsigned long) \
+        M(EXTERN, long long) \
+        M(EXTERN, unsigned long long) \
+        M(EXTERN, float) \
+        M(EXTERN, double) \
+        M(EXTERN, long double)
+
+    #define ARGPARSE_STREAM_VALUE_INSTANTIATIONS(EXTERN, T) \
+        EXTERN template void extract_value<T>(std::istream&, void*); \
+        EXTERN template void insert_value<T>(std::ostream&, const void*);
+
+    ARGPARSE_STREAM_VALUE_TYPES(ARGPARSE_STREAM_VALUE_INSTANTIATIONS, extern)
+}
 
 /*
  * Default Conversions to/from strings
+ *
+ * Types other than those specialized below are converted with their stream operators
+ * (for user-defined types, the caller provides operator>>/operator<<)
  */
 template<typename T>
 class DefaultConverter {
     public:
-        ConvertedValue<T> from_str(std::string str) {
-            std::stringstream ss(str);
-
-            T val = T();
-            ss >> val;
-
-            bool eof = ss.eof();
-            bool fail = ss.fail();
-            bool converted_ok = eof && !fail;
-
-            ConvertedValue<T> converted_value;
-            if (!converted_ok) {
-                std::stringstream msg;
-                msg << "Invalid conversion from '" << str << "'";
-                std::string arg_type_str = arg_type<T>();
-                if (!arg_type_str.empty()) {
-                    msg << " to " << arg_type_str;
-                }
-                converted_value.set_error(msg.str());
-            } else {
-                converted_value.set_value(val);
-
+        ConversionStatus from_str(StringView str, T& value) {
+            if (detail::value_from_str(str, value)) {
+                return ConversionStatus();
             }
+            return ConversionStatus::invalid(detail::arg_type_name<T>());
+        }
 
-            return converted_value;
+        ConvertedValue<T> from_str(const std::string& str) {
+            return detail::converted_value_from_str<T>(*this, str);
         }
 
         ConvertedValue<std::string> to_str(T val) {
-            std::stringstream ss;
-            ss << val;
-
-            bool converted_ok = ss.eof() && !ss.fail();
+            std::string str;
 
             ConvertedValue<std::string> converted_value;
-            if (!converted_ok) {
-                std::stringstream msg;
-                msg << "Invalid conversion from '" << val << "' to string";
-                converted_value.set_error(msg.str());
+            if (detail::stream_to_str(str, &detail::insert_value<T>, &val)) {
+                converted_value.set_value(std::move(str));
             } else {
-                converted_value.set_value(ss.str());
+                converted_value.set_error("Invalid conversion from '" + str + "' to string");
             }
             return converted_value;
         }
+
         std::vector<std::string> default_choices() { return {}; }
 };
 
@@ -90,26 +202,10 @@ class DefaultConverter {
 template<>
 class DefaultConverter<bool> {
     public:
-        ConvertedValue<bool> from_str(std::string str) {
-            ConvertedValue<bool> converted_value;
-
-            str = tolower(str);
-            if (str == "0" || str == "false") {
-                converted_value.set_value(false); 
-            } else if (str == "1" || str == "true") {
-                converted_value.set_value(true); 
-            } else {
-                converted_value.set_error("Unexpected value '" + str + "' (expected one of: " + join(default_choices(), ", ") + ")");
-            }
-            return converted_value;
-        }
+        ConversionStatus from_str(StringView str, bool& value);
+        ConvertedValue<bool> from_str(const std::string& str) { return detail::converted_value_from_str<bool>(*this, str); }
 
-        ConvertedValue<std::string> to_str(bool val) {
-            ConvertedValue<std::string> converted_value;
-            if (val) converted_value.set_value("true");
-            else     converted_value.set_value("false");
-            return converted_value;
-        }
+        ConvertedValue<std::string> to_str(bool val);
 
         std::vector<std::string> default_choices() {
             return {"true", "false"};
@@ -122,16 +218,9 @@ class DefaultConverter<bool> {
 template<>
 class DefaultConverter<std::string> {
     public:
-        ConvertedValue<std::string> from_str(std::string str) { 
-            ConvertedValue<std::string> converted_value;
-            converted_value.set_value(str);
-            return converted_value;
-        }
-        ConvertedValue<std::string> to_str(std::string val) {
-            ConvertedValue<std::string> converted_value;
-            converted_value.set_value(val);
-            return converted_value;
-        }
+        ConversionStatus from_str(StringView str, std::string& value);
+        ConvertedValue<std::string> from_str(std::string str);
+        ConvertedValue<std::string> to_str(std::string val);
         std::vector<std::string> default_choices() { return {}; }
 };
 
@@ -140,16 +229,9 @@ class DefaultConverter<std::string> {
 template<>
 class DefaultConverter<const char*> {
     public:
-        ConvertedValue<const char*> from_str(std::string str) { 
-            ConvertedValue<const char*> val;
-            val.set_value(strdup(str.c_str()));
-            return val;
-        }
-        ConvertedValue<std::string> to_str(const char* val) {
-            ConvertedValue<std::string> converted_value;
-            converted_value.set_value(val);
-            return converted_value;
-        }
+        ConversionStatus from_str(StringView str, const char*& value);
+        ConvertedValue<const char*> from_str(const std::string& str) { return detail::converted_value_from_str<const char*>(*this, str); }
+        ConvertedValue<std::string> to_str(const char* val);
         std::vector<std::string> default_choices() { return {}; }
 };
 
@@ -158,16 +240,9 @@ class DefaultConverter<const char*> {
 template<>
 class DefaultConverter<char*> {
     public:
-        ConvertedValue<char*> from_str(std::string str) { 
-            ConvertedValue<char*> val;
-            val.set_value(strdup(str.c_str()));
-            return val;
-        }
-        ConvertedValue<std::string> to_str(const char* val) {
-            ConvertedValue<std::string> converted_value;
-            converted_value.set_value(val);
-            return converted_value;
-        }
+        ConversionStatus from_str(StringView str, char*& value);
+        ConvertedValue<char*> from_str(const std::string& str) { return detail::converted_value_from_str<char*>(*this, str); }
+        ConvertedValue<std::string> to_str(const char* val);
         std::vector<std::string> default_choices() { return {}; }
 };
 } //namespace
@@ -0,0 +1,284 @@
+#ifndef ARGPARSE_ENUM_CONVERTER_HPP
+#define ARGPARSE_ENUM_CONVERTER_HPP
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include "argparse_choices.hpp"
+#include "argparse_constexpr.hpp"
+#include "argparse_default_converter.hpp"
+#include "argparse_error.hpp"
+#include "argparse_string_view.hpp"
+#include "argparse_value.hpp"
+
+namespace argparse {
+
+    /*
+     * Enumeration converters
+     *
+     * EnumConverter converts the values of an enumeration to and from the names
+     * declared for them in a constexpr table, by specializing EnumTraits:
+     *
+     *      enum class Effort { LOW, MEDIUM, HIGH };
+     *
+     *      namespace argparse {
+     *          template<>
+     *          struct EnumTraits<Effort> {
+     *              static constexpr auto names() {
+     *                  return enum_names<Effort>({{"low", Effort::LOW}, {"medium", Effort::MEDIUM}, {"high", Effort::HIGH}});
+     *              }
+     *          };
+     *      }
+     *
+     *      parser.add_argument<Effort,argparse::EnumConverter<Effort>>(args.effort, "--effort");
+     *
+     * The names are looked up in a perfect hash table built at compile time (duplicate
+     * names are compile errors), and the default choices are checked and listed from the
+     * table, so converting and registering the argument allocate nothing beyond the
+     * argument itself.
+     */
+
+    //The name of an enumeration value
+    template<typename E>
+    struct EnumName {
+        const char* name = "";
+        E value = E();
+    };
+
+    //The names of an enumeration's values, see enum_names()
+    template<typename E, size_t N>
+    class EnumNames {
+        public:
+            static_assert(N > 0, "At least one name must be specified");
+
+            constexpr EnumNames() {}
+
+            static constexpr size_t size() { return N; }
+            constexpr const EnumName<E>& operator[](size_t i) const { return names_[i]; }
+            constexpr EnumName<E>& operator[](size_t i) { return names_[i]; }
+
+            constexpr const EnumName<E>* begin() const { return names_; }
+            constexpr const EnumName<E>* end() const { return names_ + N; }
+        private:
+            EnumName<E> names_[N] = {};
+    };
+
+    //Collects the names of an enumeration's values into a table
+    template<typename E, size_t N>
+    constexpr EnumNames<E,N> enum_names(const EnumName<E> (&names)[N]) {
+        EnumNames<E,N> table;
+        for (size_t i = 0; i < N; ++i) {
+            table[i] = names[i];
+        }
+        return table;
+    }
+
+    //Declares the names of enumeration E's values (specialize with a static constexpr names()
+    //returning an enum_names() table, see above)
+    template<typename E>
+    struct EnumTraits;
+
+    //The names of the values of an enumeration, as the default choices of an EnumConverter.
+    //Iterates over the names without copying them, and arguments check and list them with
+    //provider() rather than copying them to choices()
+    template<typename E>
+    class EnumChoices {
+        public:
+            class iterator {
+                public:
+                    constexpr explicit iterator(const EnumName<E>* name) : name_(name) {}
+
+                    constexpr const char* operator*() const { return name_->name; }
+                    iterator& operator++() { ++name_; return *this; }
+                    constexpr bool operator==(const iterator& other) const { return name_ == other.name_; }
+                    constexpr bool operator!=(const iterator& other) const { return name_ != other.name_; }
+                private:
+                    const EnumName<E>* name_;
+            };
+
+            constexpr EnumChoices(const EnumName<E>* begin_name, const EnumName<E>* end_name, const ChoiceProvider* choice_provider=nullptr)
+                : begin_(begin_name)
+                , end_(end_name)
+                , provider_(choice_provider)
+                {}
+
+            constexpr iterator begin() const { return iterator(begin_); }
+            constexpr iterator end() const { return iterator(end_); }
+            constexpr size_t size() const { return static_cast<size_t>(end_ - begin_); }
+            constexpr bool empty() const { return begin_ == end_; }
+
+            //Returns a (static) provider checking and listing the names (null if none)
+            constexpr const ChoiceProvider* provider() const { return provider_; }
+        private:
+            const EnumName<E>* begin_;
+            const EnumName<E>* end_;
+            const ChoiceProvider* provider_;
+    };
+
+    namespace detail {
+        //Perfect hash table mapping names to their indices in an EnumNames table
+        template<size_t TableSize>
+        struct EnumHashTable {
+            static_assert((TableSize & (TableSize - 1)) == 0, "Enum table size must be a power of two");
+
+            size_t slots[TableSize] = {}; //Index + 1 (zero if empty)
+            uint32_t seed = 0;
+
+            //Returns the index of the name which might be str (or names.size() if none can be)
+            template<typename Names>
+            constexpr size_t find(const Names& names, const char* str, size_t size) const {
+                size_t slot = slots[static_hash(str, size, seed) & (TableSize - 1)];
+                if (slot != 0) {
+                    const char* name = names[slot - 1].name;
+                    if (static_streq(name, static_strlen(name), str, size)) {
+                        return slot - 1;
+                    }
+                }
+                return names.size();
+            }
+        };
+
+        //Returns the size of the hash table (a power of two at least twice the number of names)
+        constexpr size_t enum_table_size(size_t num_names) {
+            size_t table_size = 1;
+            while (table_size < 2 * num_names) table_size *= 2;
+            return table_size;
+        }
+
+        //A null-terminated string built at compile time
+        template<size_t Size>
+        struct EnumText {
+            char str[Size] = {};
+        };
+
+        constexpr const char* ENUM_EXPECTED_PREFIX = "one of: ";
+
+        //Returns the size of the description of the expected names (including the terminator)
+        template<typename Names>
+        constexpr size_t enum_expected_size(const Names& names) {
+            size_t size = static_strlen(ENUM_EXPECTED_PREFIX) + 1;
+            for (size_t i = 0; i < names.size(); ++i) {
+                if (i != 0) size += 2;
+                size += static_strlen(names[i].name);
+            }
+            return size;
+        }
+
+        //Appends str to text at len, returning the new length
+        template<size_t Size>
+        constexpr size_t enum_text_append(EnumText<Size>& text, size_t len, const char* str) {
+            for (size_t i = 0; str[i] != '\0'; ++i) {
+                text.str[len++] = str[i];
+            }
+            return len;
+        }
+
+        //Describes the expected names in error messages (e.g. "one of: low, high")
+        template<size_t Size, typename Names>
+        constexpr EnumText<Size> build_enum_expected(const Names& names) {
+            EnumText<Size> text;
+            size_t len = enum_text_append(text, 0, ENUM_EXPECTED_PREFIX);
+            for (size_t i = 0; i < names.size(); ++i) {
+                if (i != 0) len = enum_text_append(text, len, ", ");
+                len = enum_text_append(text, len, names[i].name);
+            }
+            return text;
+        }
+
+        //Builds the hash table, searching for a seed which maps every name to a unique slot
+        template<size_t TableSize, typename Names>
+        constexpr EnumHashTable<TableSize> build_enum_table(const Names& names) {
+            constexpr uint32_t MAX_SEEDS = 4096;
+
+            for (size_t i = 0; i < names.size(); ++i) {
+                for (size_t j = i + 1; j < names.size(); ++j) {
+                    if (static_streq(names[i].name, names[j].name)) {
+                        throw ArgParseError("Enumeration name maps to multiple values");
+                    }
+                }
+            }
+
+            for (uint32_t seed = 0; seed < MAX_SEEDS; ++seed) {
+                EnumHashTable<TableSize> table;
+                table.seed = seed;
+
+                bool ok = true;
+                for (size_t i = 0; ok && i < names.size(); ++i) {
+                    size_t& slot = table.slots[static_hash(names[i].name, static_strlen(names[i].name), seed) & (TableSize - 1)];
+                    ok = (slot == 0); //Otherwise a collision
+                    slot = i + 1;
+                }
+
+                if (ok) return table;
+            }
+            throw ArgParseError("Failed to find a perfect hash for the enumeration names");
+        }
+    }
+
+    //Converts enumeration E to and from the names declared by Traits (see above)
+    template<typename E, typename Traits=EnumTraits<E>>
+    class EnumConverter {
+        public:
+            static_assert(std::is_enum<E>::value, "EnumConverter requires an enumeration");
+
+            ConversionStatus from_str(StringView str, E& value) {
+                size_t i = table_.find(names_, str.data(), str.size());
+                if (i == names_.size()) {
+                    return ConversionStatus::unexpected(expected_.str);
+                }
+                value = names_[i].value;
+                return ConversionStatus();
+            }
+
+            ConvertedValue<E> from_str(const std::string& str) {
+                return detail::converted_value_from_str<E>(*this, str);
+            }
+
+            ConvertedValue<std::string> to_str(E value) {
+                ConvertedValue<std::string> converted_value;
+                for (const auto& name : names_) {
+                    if (name.value == value) {
+                        converted_value.set_value(name.name);
+                        return converted_value;
+                    }
+                }
+                converted_value.set_error("Enumeration value " + std::to_string(static_cast<long long>(value)) + " has no name");
+                return converted_value;
+            }
+
+            EnumChoices<E> default_choices() {
+                static const NameChoices provider;
+                return EnumChoices<E>(names_.begin(), names_.end(), &provider);
+            }
+        private:
+            //Checks and lists the names as an argument's choices
+            class NameChoices : public ChoiceProvider {
+                public:
+                    bool contains(const std::string& str) const override {
+                        return table_.find(names_, str.data(), str.size()) < names_.size();
+                    }
+                    std::string description() const override { return expected_.str; }
+                    size_t memory_usage() const override { return 0; }
+                    size_t num_listed() const override { return names_.size(); }
+                    const char* listed(size_t i) const override { return names_[i].name; }
+            };
+
+            typedef decltype(Traits::names()) Names;
+            static constexpr size_t TABLE_SIZE = detail::enum_table_size(Names::size());
+            typedef detail::EnumHashTable<TABLE_SIZE> Table;
+
+            static constexpr Names names_ = Traits::names();
+            static constexpr Table table_ = detail::build_enum_table<TABLE_SIZE>(names_);
+
+            static constexpr size_t EXPECTED_SIZE = detail::enum_expected_size(names_);
+            static constexpr detail::EnumText<EXPECTED_SIZE> expected_ = detail::build_enum_expected<EXPECTED_SIZE>(names_);
+    };
+
+    template<typename E, typename Traits> constexpr size_t EnumConverter<E,Traits>::TABLE_SIZE;
+    template<typename E, typename Traits> constexpr typename EnumConverter<E,Traits>::Names EnumConverter<E,Traits>::names_;
+    template<typename E, typename Traits> constexpr typename EnumConverter<E,Traits>::Table EnumConverter<E,Traits>::table_;
+    template<typename E, typename Traits> constexpr size_t EnumConverter<E,Traits>::EXPECTED_SIZE;
+    template<typename E, typename Traits> constexpr detail::EnumText<EnumConverter<E,Traits>::EXPECTED_SIZE> EnumConverter<E,Traits>::expected_;
+
+} //namespace
+#endif
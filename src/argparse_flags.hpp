@@ -0,0 +1,93 @@
+#ifndef ARGPARSE_FLAGS_HPP
+#define ARGPARSE_FLAGS_HPP
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "argparse_value.hpp"
+
+namespace argparse {
+
+    /*
+     * FlagSet is the destination of many boolean options (see ArgumentParser::add_flag()),
+     * each identified by its index (e.g. an enumerator) in [0, size()).
+     *
+     * Rather than an ArgValue<bool> per option, with its provenance and the names of the
+     * argument and group which set it, the values are packed into bitsets, with two bits of
+     * provenance per flag stored alongside. Testing a flag reads one word, and word() allows
+     * up to 64 flags to be tested at once (e.g. with a mask).
+     */
+    class FlagSet {
+        public:
+            static constexpr size_t FLAGS_PER_WORD = 64;
+
+            explicit FlagSet(size_t num_flags=0) { resize(num_flags); }
+
+        public: //Accessors
+            //Returns the number of flags
+            size_t size() const { return size_; }
+
+            //Returns the value of flag
+            bool test(size_t flag) const { return (block(flag)[VALUE] >> bit(flag)) & 1; }
+            bool operator[](size_t flag) const { return test(flag); }
+
+            //Returns how flag was set
+            Provenance provenance(size_t flag) const {
+                const uint64_t* words = block(flag);
+                unsigned prov = ((words[PROVENANCE_LOW] >> bit(flag)) & 1) | (((words[PROVENANCE_HIGH] >> bit(flag)) & 1) << 1);
+                return static_cast<Provenance>(prov);
+            }
+
+            //Returns true if flag was explicitly specified
+            bool specified(size_t flag) const { return provenance(flag) == Provenance::SPECIFIED; }
+
+            //Returns the number of words holding the flags' values
+            size_t num_words() const { return words_.size() / WORDS_PER_BLOCK; }
+
+            //Returns the values of flags [FLAGS_PER_WORD * iword, FLAGS_PER_WORD * (iword + 1)):
+            //bit i is the value of flag FLAGS_PER_WORD * iword + i
+            uint64_t word(size_t iword) const { return words_[WORDS_PER_BLOCK * iword + VALUE]; }
+
+        public: //Mutators
+            //Sets the value (and provenance) of flag
+            void set(size_t flag, bool value, Provenance prov) {
+                uint64_t* words = block(flag);
+                uint64_t mask = uint64_t(1) << bit(flag);
+                unsigned prov_bits = static_cast<unsigned>(prov);
+
+                words[VALUE] = value ? (words[VALUE] | mask) : (words[VALUE] & ~mask);
+                words[PROVENANCE_LOW] = (prov_bits & 1) ? (words[PROVENANCE_LOW] | mask) : (words[PROVENANCE_LOW] & ~mask);
+                words[PROVENANCE_HIGH] = (prov_bits & 2) ? (words[PROVENANCE_HIGH] | mask) : (words[PROVENANCE_HIGH] & ~mask);
+            }
+
+            //Sets the number of flags (new flags are false and unspecified)
+            void resize(size_t num_flags) {
+                size_ = num_flags;
+                words_.resize(WORDS_PER_BLOCK * ((num_flags + FLAGS_PER_WORD - 1) / FLAGS_PER_WORD), 0);
+            }
+
+            //Resets all the flags to false and unspecified
+            void reset() {
+                for (auto& word_bits : words_) {
+                    word_bits = 0;
+                }
+            }
+
+            //Returns the heap memory used by the flags
+            size_t heap_bytes() const { return words_.capacity() * sizeof(uint64_t); }
+
+        private:
+            //Each block of words holds the values of FLAGS_PER_WORD flags, followed by
+            //the low and high bits of their provenance
+            enum : size_t { VALUE, PROVENANCE_LOW, PROVENANCE_HIGH, WORDS_PER_BLOCK };
+            static_assert(static_cast<unsigned>(Provenance::INFERRED) < 4, "Provenance must fit in two bits");
+
+            const uint64_t* block(size_t flag) const { return &words_[WORDS_PER_BLOCK * (flag / FLAGS_PER_WORD)]; }
+            uint64_t* block(size_t flag) { return &words_[WORDS_PER_BLOCK * (flag / FLAGS_PER_WORD)]; }
+            static size_t bit(size_t flag) { return flag % FLAGS_PER_WORD; }
+        private:
+            std::vector<uint64_t> words_;
+            size_t size_ = 0;
+    };
+
+} //namespace
+#endif
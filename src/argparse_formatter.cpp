@@ -64,11 +64,21 @@ namespace argparse {
             ss << " [OTHER_OPTIONS ...]";
         }
 
+        auto subcommands = parser_->subcommands();
+        if (!subcommands.empty()) {
+            ss << " {";
+            for (size_t i = 0; i < subcommands.size(); ++i) {
+                if (i != 0) ss << ",";
+                ss << subcommands[i].first;
+            }
+            ss << "} ...";
+        }
+
         size_t prefix_len = USAGE_PREFIX.size();
 
         std::stringstream wrapped_ss;
         bool first = true;
-        for(const auto& line : wrap_width(ss.str(), total_width_ - prefix_len, {" [", " -"})) {
+        for(const auto& line : wrap_width(ss.str(), total_width_ - prefix_len, {" [", " -", " {"})) {
             if(!first) {
                 //pass
                 wrapped_ss << std::string(prefix_len, ' ');
@@ -166,6 +176,29 @@ namespace argparse {
             }
         }
 
+        //Subcommands are listed by name, so their parsers need not be built
+        auto subcommands = parser_->subcommands();
+        if (!subcommands.empty()) {
+            ss << "\n";
+            ss << "subcommands:" << "\n";
+            for (const auto& subcommand : subcommands) {
+                ss << INDENT << subcommand.first;
+
+                size_t pos = INDENT.size() + subcommand.first.size();
+                if (pos + OPTION_HELP_SLACK > option_name_width_) {
+                    ss << "\n";
+                    pos = 0;
+                }
+
+                for (auto& line : wrap_width(subcommand.second, total_width_ - option_name_width_)) {
+                    ss << std::string(option_name_width_ - pos, ' ');
+                    ss << line;
+                    pos = 0;
+                }
+                ss << "\n";
+            }
+        }
+
         return ss.str();
     }
 
@@ -186,6 +219,11 @@ namespace argparse {
         return parser_->version() + "\n";
     }
 
+    size_t DefaultFormatter::memory_usage() const {
+        //No caches
+        return sizeof(*this);
+    }
+
     /*
      * Utilities
      */
@@ -226,6 +264,19 @@ namespace argparse {
             }
             choices_ss << "}";
             base_metavar = choices_ss.str();
+        } else if (arg.choice_provider() && arg.choice_provider()->num_listed() > 0) {
+            //As may the choices a provider lists
+            const auto& provider = *arg.choice_provider();
+            std::stringstream choices_ss;
+            choices_ss << "{";
+            for (size_t i = 0; i < provider.num_listed(); ++i) {
+                if (i != 0) {
+                    choices_ss << ", ";
+                }
+                choices_ss << provider.listed(i);
+            }
+            choices_ss << "}";
+            base_metavar = choices_ss.str();
         }
 
         std::string metavar;
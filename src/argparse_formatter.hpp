@@ -15,6 +15,9 @@ namespace argparse {
             virtual std::string format_arguments() const = 0;
             virtual std::string format_epilog() const = 0;
             virtual std::string format_version() const = 0;
+
+            //Returns the memory used by the formatter (including anything it caches)
+            virtual size_t memory_usage() const { return sizeof(*this); }
     };
 
     class DefaultFormatter : public Formatter {
@@ -26,6 +29,7 @@ namespace argparse {
             std::string format_arguments() const override;
             std::string format_epilog() const override;
             std::string format_version() const override;
+            size_t memory_usage() const override;
         private:
             size_t option_name_width_;
             size_t total_width_;
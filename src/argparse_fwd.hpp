@@ -0,0 +1,50 @@
+#ifndef ARGPARSE_FWD_HPP
+#define ARGPARSE_FWD_HPP
+
+/*
+ * Forward declarations of the public argparse types.
+ *
+ * Include this (rather than argparse.hpp) in headers which only refer to parsers,
+ * arguments or values by reference or pointer. Code which reads ArgValues needs
+ * only argparse_value.hpp.
+ */
+namespace argparse {
+
+    class ArgumentParser;
+    class ArgumentGroup;
+    class Argument;
+    class InferredValue;
+    class Formatter;
+    class ParseTrace;
+    class OutputSink;
+    class ChoiceProvider;
+    class FlagSet;
+
+    struct ArgumentConstraint;
+    struct ParseStats;
+    struct MemoryUsage;
+
+    template<typename T>
+    class ConvertedValue;
+
+    class ArgValueBase;
+
+    template<typename T>
+    class ArgValue;
+
+    template<typename T>
+    class DefaultConverter;
+
+    enum class Provenance;
+    enum class Action;
+    enum class ShowIn;
+    enum class ResetMode;
+    enum class Phase;
+
+    class ArgParseError;
+    class ArgParseConversionError;
+    class ArgParseHelp;
+    class ArgParseVersion;
+
+} //namespace
+#endif
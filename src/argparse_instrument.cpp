@@ -0,0 +1,214 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include "argparse_instrument.hpp"
+#include "argparse_trace.hpp"
+
+namespace argparse {
+
+    namespace {
+        constexpr size_t NUM_PHASES = static_cast<size_t>(Phase::NUM_PHASES);
+
+        //Trivially constructed, so safe to use from operator new
+        thread_local Phase current_phase_ = Phase::OTHER;
+
+        std::atomic<size_t> phase_allocations_[NUM_PHASES];
+        std::atomic<size_t> phase_bytes_[NUM_PHASES];
+
+#ifdef ARGPARSE_ENABLE_STATS
+        typedef std::chrono::steady_clock Clock;
+
+        thread_local ParseStats* active_stats_ = nullptr;
+        thread_local Clock::time_point phase_start_;
+
+        //Charges the time since the last phase transition to the current phase
+        void charge_current_phase() {
+            auto now = Clock::now();
+            if (active_stats_) {
+                std::chrono::duration<double> elapsed = now - phase_start_;
+                active_stats_->phase_seconds[static_cast<size_t>(current_phase_)] += elapsed.count();
+            }
+            phase_start_ = now;
+        }
+#endif
+    }
+
+    const char* phase_name(Phase phase) {
+        switch (phase) {
+            case Phase::OTHER: return "other";
+            case Phase::REGISTRATION: return "registration";
+            case Phase::FREEZE: return "freeze";
+            case Phase::DEFAULTS: return "defaults";
+            case Phase::PARSE: return "parse";
+            case Phase::FORMAT: return "format";
+            default: return "unknown";
+        }
+    }
+
+    Phase current_phase() {
+        return current_phase_;
+    }
+
+    PhaseScope::PhaseScope(Phase phase)
+        : prev_phase_(current_phase_)
+        , trace_(detail::active_trace()) {
+        ARGPARSE_STATS(charge_current_phase());
+        current_phase_ = phase;
+
+        if (trace_) {
+            trace_event_ = trace_->begin(ParseTrace::EventType::PHASE);
+            trace_->set_phase(trace_event_, phase);
+        }
+    }
+
+    PhaseScope::~PhaseScope() {
+        if (trace_) {
+            trace_->end(trace_event_);
+        }
+
+        ARGPARSE_STATS(charge_current_phase());
+        current_phase_ = prev_phase_;
+    }
+
+    bool stats_enabled() {
+#ifdef ARGPARSE_ENABLE_STATS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+#ifdef ARGPARSE_ENABLE_STATS
+    StatsScope::StatsScope(ParseStats& stats)
+        : prev_stats_(active_stats_) {
+        charge_current_phase();
+        active_stats_ = &stats;
+    }
+
+    StatsScope::~StatsScope() {
+        charge_current_phase();
+        active_stats_ = prev_stats_;
+    }
+
+    namespace detail {
+        void record_token() {
+            if (active_stats_) ++active_stats_->tokens_classified;
+        }
+
+        void record_option_lookup() {
+            if (active_stats_) ++active_stats_->option_lookups;
+        }
+
+        void record_choice_check() {
+            if (active_stats_) ++active_stats_->choice_checks;
+        }
+
+        void record_conversion(const std::type_info& converter_type) {
+            if (active_stats_) {
+                ++active_stats_->conversions;
+                auto& counts = active_stats_->converter_conversions;
+                auto iter = std::find_if(counts.begin(), counts.end(),
+                                         [&](const std::pair<std::type_index,size_t>& kv) { return kv.first == converter_type; });
+                if (iter == counts.end()) {
+                    counts.emplace_back(converter_type, 1);
+                } else {
+                    ++iter->second;
+                }
+            }
+        }
+    }
+#else
+    StatsScope::StatsScope(ParseStats&)
+        : prev_stats_(nullptr) {}
+
+    StatsScope::~StatsScope() {}
+
+    namespace detail {
+        void record_token() {}
+        void record_option_lookup() {}
+        void record_choice_check() {}
+        void record_conversion(const std::type_info&) {}
+    }
+#endif
+
+    bool alloc_counting_enabled() {
+#ifdef ARGPARSE_COUNT_ALLOCATIONS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    AllocCounts alloc_counts(Phase phase) {
+        size_t iphase = static_cast<size_t>(phase);
+
+        AllocCounts counts;
+        counts.allocations = phase_allocations_[iphase].load(std::memory_order_relaxed);
+        counts.bytes = phase_bytes_[iphase].load(std::memory_order_relaxed);
+        return counts;
+    }
+
+    void reset_alloc_counts() {
+        for (size_t iphase = 0; iphase < NUM_PHASES; ++iphase) {
+            phase_allocations_[iphase].store(0, std::memory_order_relaxed);
+            phase_bytes_[iphase].store(0, std::memory_order_relaxed);
+        }
+    }
+
+#ifdef ARGPARSE_COUNT_ALLOCATIONS
+    namespace {
+        void* counted_alloc(size_t size) noexcept {
+            size_t iphase = static_cast<size_t>(current_phase_);
+            phase_allocations_[iphase].fetch_add(1, std::memory_order_relaxed);
+            phase_bytes_[iphase].fetch_add(size, std::memory_order_relaxed);
+
+            return std::malloc(size ? size : 1);
+        }
+    }
+#endif
+
+    size_t heap_bytes(const std::string& str) {
+        auto data = reinterpret_cast<uintptr_t>(str.data());
+        auto object = reinterpret_cast<uintptr_t>(&str);
+        if (data >= object && data < object + sizeof(str)) {
+            //Short string stored within the object
+            return 0;
+        }
+        return str.capacity() + 1; //+1 for terminator
+    }
+} //namespace
+
+#ifdef ARGPARSE_COUNT_ALLOCATIONS
+/*
+ * Replacement global allocation functions
+ */
+void* operator new(size_t size) {
+    void* ptr = argparse::counted_alloc(size);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new[](size_t size) {
+    void* ptr = argparse::counted_alloc(size);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return argparse::counted_alloc(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return argparse::counted_alloc(size);
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+#endif
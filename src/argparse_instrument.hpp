@@ -0,0 +1,190 @@
+#ifndef ARGPARSE_INSTRUMENT_HPP
+#define ARGPARSE_INSTRUMENT_HPP
+#include <cstddef>
+#include <string>
+#include <typeindex>
+#include <utility>
+#include <vector>
+
+//Statistics collection is only compiled in if ARGPARSE_ENABLE_STATS is defined
+#ifdef ARGPARSE_ENABLE_STATS
+#   define ARGPARSE_STATS(stmt) stmt
+#else
+#   define ARGPARSE_STATS(stmt)
+#endif
+
+namespace argparse {
+
+    class ParseTrace;
+
+    //The phases of building and using an ArgumentParser
+    enum class Phase {
+        OTHER,        //Outside of any other phase
+        REGISTRATION, //Adding arguments (marked by the caller, since it spans add_argument() and the chained mutators)
+        FREEZE,       //Building the option look-up tables
+        DEFAULTS,     //Applying default values
+        PARSE,        //Processing the command-line
+        FORMAT,       //Formatting usage/help/version
+        NUM_PHASES
+    };
+
+    //Returns a printable name for phase
+    const char* phase_name(Phase phase);
+
+    //Returns the phase currently being executed (on the calling thread)
+    Phase current_phase();
+
+    /*
+     * PhaseScope marks the calling thread as executing the specified phase
+     * for its lifetime, restoring the previous phase when destroyed.
+     * Scopes may be nested.
+     */
+    class PhaseScope {
+        public:
+            PhaseScope(Phase phase);
+            ~PhaseScope();
+
+            PhaseScope(const PhaseScope&) = delete;
+            PhaseScope& operator=(const PhaseScope&) = delete;
+        private:
+            Phase prev_phase_;
+            ParseTrace* trace_; //Trace recording this phase (if any)
+            size_t trace_event_ = 0;
+    };
+
+    /*
+     * Parse statistics
+     *
+     * When built with ARGPARSE_ENABLE_STATS (CMake option of the same name) an
+     * ArgumentParser counts the work done while parsing, and times each phase.
+     * Otherwise the counting code is compiled out and the statistics remain zero.
+     */
+    struct ParseStats {
+        size_t tokens_classified = 0; //Command-line tokens classified as options, values or positionals
+        size_t option_lookups = 0;    //Look-ups of tokens in the option table
+        size_t choice_checks = 0;     //Values checked against an argument's choices
+        size_t conversions = 0;       //Conversions from strings to values (by any converter)
+        std::vector<std::pair<std::type_index,size_t>> converter_conversions; //Conversions by converter type (in order of first use)
+
+        //Time spent (exclusively) in each phase
+        double phase_seconds[static_cast<size_t>(Phase::NUM_PHASES)] = {};
+
+        //Returns the time spent in phase
+        double seconds(Phase phase) const { return phase_seconds[static_cast<size_t>(phase)]; }
+
+        //Returns the number of conversions performed by Converter
+        template<typename Converter>
+        size_t conversions_by() const {
+            for (const auto& kv : converter_conversions) {
+                if (kv.first == typeid(Converter)) return kv.second;
+            }
+            return 0;
+        }
+    };
+
+    //Returns true if statistics collection was compiled in
+    bool stats_enabled();
+
+    /*
+     * StatsScope directs the statistics recorded on the calling thread to stats
+     * for its lifetime, restoring the previous target when destroyed.
+     */
+    class StatsScope {
+        public:
+            StatsScope(ParseStats& stats);
+            ~StatsScope();
+
+            StatsScope(const StatsScope&) = delete;
+            StatsScope& operator=(const StatsScope&) = delete;
+        private:
+            ParseStats* prev_stats_;
+    };
+
+    namespace detail {
+        //Record events in the active ParseStats (if any)
+        void record_token();
+        void record_option_lookup();
+        void record_choice_check();
+        void record_conversion(const std::type_info& converter_type);
+    }
+
+    /*
+     * MemoryUsage is a breakdown of the (estimated) bytes used by an ArgumentParser
+     */
+    struct MemoryUsage {
+        size_t argument_objects = 0; //Argument and ArgumentGroup objects, and the containers holding them
+        size_t strings = 0;          //Heap memory of option names, help text, metavars, descriptions etc.
+        size_t choices = 0;          //Valid choices of arguments
+        size_t defaults = 0;         //Default values of arguments
+        size_t lookup_tables = 0;    //Option look-up tables (built by ArgumentParser::freeze())
+        size_t formatter_caches = 0; //The formatter, and anything it caches
+        size_t destinations = 0;     //Heap memory of destination values and their metadata
+                                     //(the ArgValue objects themselves are owned by the caller)
+        size_t other = 0;            //The parser object itself, statistics and trace
+
+        size_t total() const {
+            return argument_objects + strings + choices + defaults + lookup_tables
+                   + formatter_caches + destinations + other;
+        }
+
+        MemoryUsage& operator+=(const MemoryUsage& rhs) {
+            argument_objects += rhs.argument_objects;
+            strings += rhs.strings;
+            choices += rhs.choices;
+            defaults += rhs.defaults;
+            lookup_tables += rhs.lookup_tables;
+            formatter_caches += rhs.formatter_caches;
+            destinations += rhs.destinations;
+            other += rhs.other;
+            return *this;
+        }
+    };
+
+    //Returns the heap memory used by a value (beyond its sizeof())
+    size_t heap_bytes(const std::string& str);
+
+    template<typename T>
+    size_t heap_bytes(const T& /*val*/) {
+        return 0;
+    }
+
+    template<typename T>
+    size_t heap_bytes(const std::vector<T>& vec) {
+        size_t bytes = vec.capacity() * sizeof(T);
+        for (const auto& val : vec) {
+            bytes += heap_bytes(val);
+        }
+        return bytes;
+    }
+
+    //Returns the (estimated) size of an ordered map/set node holding value_type
+    template<typename value_type>
+    constexpr size_t tree_node_bytes() { return sizeof(value_type) + 4 * sizeof(void*); } //Colour, parent and children
+
+    //Returns the (estimated) size of a shared_ptr control block allocated by make_shared()
+    constexpr size_t shared_ptr_control_bytes() { return 2 * sizeof(void*); } //Vtable and reference counts
+
+    /*
+     * Heap allocation accounting
+     *
+     * When the library is built with ARGPARSE_COUNT_ALLOCATIONS (CMake option of the
+     * same name) the global operator new/delete are replaced with counting versions,
+     * which attribute every allocation to the current phase. Otherwise the counts are
+     * always zero.
+     */
+    struct AllocCounts {
+        size_t allocations = 0;
+        size_t bytes = 0;
+    };
+
+    //Returns true if allocation counting was compiled in
+    bool alloc_counting_enabled();
+
+    //Returns the allocations made (on all threads) during phase since the last reset_alloc_counts()
+    AllocCounts alloc_counts(Phase phase);
+
+    //Resets the allocation counts of all phases to zero
+    void reset_alloc_counts();
+
+} //namespace
+#endif
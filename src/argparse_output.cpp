@@ -0,0 +1,97 @@
+#include <cerrno>
+
+#ifdef _WIN32
+#   include <io.h>
+#else
+#   include <unistd.h>
+#endif
+
+#ifndef ARGPARSE_NO_IOSTREAM
+#   include <ostream>
+#endif
+
+#include "argparse_output.hpp"
+
+namespace argparse {
+
+    /*
+     * StdioOutputSink
+     */
+    StdioOutputSink::StdioOutputSink(std::FILE* file)
+        : file_(file) {}
+
+    void StdioOutputSink::do_write(const char* data, size_t size) {
+        std::fwrite(data, 1, size, file_);
+    }
+
+    void StdioOutputSink::do_flush() {
+        std::fflush(file_);
+    }
+
+    /*
+     * FdOutputSink
+     */
+    FdOutputSink::FdOutputSink(int fd)
+        : fd_(fd) {}
+
+    void FdOutputSink::do_write(const char* data, size_t size) {
+        //Write may be partial (e.g. to a pipe), or interrupted by a signal
+        while (size > 0) {
+#ifdef _WIN32
+            int written = ::_write(fd_, data, static_cast<unsigned>(size));
+#else
+            ssize_t written = ::write(fd_, data, size);
+#endif
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                return; //Nowhere to report the failure
+            }
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+    }
+
+    /*
+     * CallbackOutputSink
+     */
+    CallbackOutputSink::CallbackOutputSink(Callback callback, void* context)
+        : callback_(callback)
+        , context_(context) {}
+
+    void CallbackOutputSink::do_write(const char* data, size_t size) {
+        callback_(context_, data, size);
+    }
+
+    /*
+     * StringOutputSink
+     */
+    const std::string& StringOutputSink::str() const { return str_; }
+
+    void StringOutputSink::clear() { str_.clear(); }
+
+    void StringOutputSink::do_write(const char* data, size_t size) {
+        str_.append(data, size);
+    }
+
+#ifndef ARGPARSE_NO_IOSTREAM
+    /*
+     * OstreamOutputSink
+     */
+    OstreamOutputSink::OstreamOutputSink(std::ostream& os)
+        : os_(os) {}
+
+    void OstreamOutputSink::do_write(const char* data, size_t size) {
+        os_.write(data, static_cast<std::streamsize>(size));
+    }
+
+    void OstreamOutputSink::do_flush() {
+        os_.flush();
+    }
+#endif
+
+    OutputSink& stdout_sink() {
+        static StdioOutputSink sink(stdout);
+        return sink;
+    }
+
+} //namespace
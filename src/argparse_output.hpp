@@ -0,0 +1,102 @@
+#ifndef ARGPARSE_OUTPUT_HPP
+#define ARGPARSE_OUTPUT_HPP
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <iosfwd>
+#include <string>
+
+namespace argparse {
+
+    /*
+     * OutputSink is where parsers write their usage, help, version and error messages.
+     *
+     * Sinks are provided for stdio streams, file descriptors, callbacks and in-memory
+     * buffers, so embedding programs need not use <iostream> (and pay for its static
+     * initialization). Unless built with ARGPARSE_NO_IOSTREAM, OstreamOutputSink adapts
+     * a std::ostream.
+     */
+    class OutputSink {
+        public:
+            virtual ~OutputSink() {}
+
+            //Writes size bytes of data
+            void write(const char* data, size_t size) { do_write(data, size); }
+            void write(const char* str) { do_write(str, std::strlen(str)); }
+            void write(const std::string& str) { do_write(str.data(), str.size()); }
+
+            //Flushes any buffered output
+            void flush() { do_flush(); }
+
+        private:
+            virtual void do_write(const char* data, size_t size) = 0;
+            virtual void do_flush() {}
+    };
+
+    //Writes to a stdio stream
+    class StdioOutputSink : public OutputSink {
+        public:
+            explicit StdioOutputSink(std::FILE* file);
+        private:
+            void do_write(const char* data, size_t size) override;
+            void do_flush() override;
+        private:
+            std::FILE* file_;
+    };
+
+    //Writes (unbuffered) to a file descriptor
+    class FdOutputSink : public OutputSink {
+        public:
+            explicit FdOutputSink(int fd);
+        private:
+            void do_write(const char* data, size_t size) override;
+        private:
+            int fd_;
+    };
+
+    //Passes the output to a callback, along with an arbitrary context pointer
+    class CallbackOutputSink : public OutputSink {
+        public:
+            typedef void (*Callback)(void* context, const char* data, size_t size);
+
+            CallbackOutputSink(Callback callback, void* context=nullptr);
+        private:
+            void do_write(const char* data, size_t size) override;
+        private:
+            Callback callback_;
+            void* context_;
+    };
+
+    //Accumulates the output in memory
+    class StringOutputSink : public OutputSink {
+        public:
+            //Returns the output written since construction (or the last clear())
+            const std::string& str() const;
+
+            //Discards the accumulated output
+            void clear();
+        private:
+            void do_write(const char* data, size_t size) override;
+        private:
+            std::string str_;
+    };
+
+#ifndef ARGPARSE_NO_IOSTREAM
+    //Writes to a std::ostream
+    class OstreamOutputSink : public OutputSink {
+        public:
+            explicit OstreamOutputSink(std::ostream& os);
+        private:
+            void do_write(const char* data, size_t size) override;
+            void do_flush() override;
+        private:
+            std::ostream& os_;
+    };
+#endif
+
+    //Returns a sink writing to stdout (the default for parsers).
+    //This goes through stdio, so output stays ordered with printf() and std::cout
+    OutputSink& stdout_sink();
+
+} //namespace
+#endif
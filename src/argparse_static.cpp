@@ -0,0 +1,224 @@
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+#include "argparse_static.hpp"
+
+namespace argparse {
+    namespace detail {
+
+        namespace {
+            //Returns the argument index of an option string (or a short option with its value)
+            size_t lookup_option(const StaticParseTables& tables, const char* token, bool* no_space_short_arg) {
+                *no_space_short_arg = false;
+
+                ARGPARSE_STATS(record_option_lookup());
+                size_t size = std::strlen(token);
+                size_t iarg = tables.find_option(token, size);
+
+                if (iarg == STATIC_NOT_FOUND && size > 2 && token[0] == '-') {
+                    //Check iff this is a short option with no spaces (i.e. the
+                    //first two characters match a short option which takes a value)
+                    iarg = tables.find_option(token, 2);
+                    if (iarg < tables.num_arguments && tables.arguments[iarg].nargs() == '1') {
+                        *no_space_short_arg = true;
+                    } else {
+                        iarg = STATIC_NOT_FOUND;
+                    }
+                }
+                return iarg;
+            }
+
+            void check_choice(const StaticArgument& arg, const char* value, const char* name) {
+                if (arg.num_choices() == 0) return;
+
+                ARGPARSE_STATS(record_choice_check());
+                for (size_t ichoice = 0; ichoice < arg.num_choices(); ++ichoice) {
+                    if (std::strcmp(arg.choice(ichoice), value) == 0) return;
+                }
+
+                std::stringstream msg;
+                msg << "Unexpected option value '" << value << "' (expected one of: ";
+                for (size_t ichoice = 0; ichoice < arg.num_choices(); ++ichoice) {
+                    if (ichoice != 0) msg << ", ";
+                    msg << arg.choice(ichoice);
+                }
+                msg << ") for " << name;
+                throw ArgParseError(msg.str());
+            }
+        }
+
+        void set_static_flag(void* value, bool flag, const StaticArgument& arg, const char* name) {
+            auto& dest = *static_cast<ArgValue<bool>*>(value);
+
+            dest.set(flag, Provenance::SPECIFIED);
+            dest.set_argument_name(name);
+            dest.set_argument_group(arg.group_name());
+        }
+
+        size_t find_sorted_option(const StaticOptionEntry* options, size_t num_options, const char* str, size_t size) {
+            //Binary search, comparing as std::strcmp() would
+            size_t first = 0;
+            size_t last = num_options;
+            while (first < last) {
+                size_t mid = first + (last - first) / 2;
+                const char* option = options[mid].option;
+
+                int cmp = std::strncmp(option, str, size);
+                if (cmp == 0 && option[size] != '\0') {
+                    cmp = 1; //str is a prefix of option
+                }
+
+                if (cmp == 0) {
+                    return options[mid].iarg;
+                } else if (cmp < 0) {
+                    first = mid + 1;
+                } else {
+                    last = mid;
+                }
+            }
+            return STATIC_NOT_FOUND;
+        }
+
+        void parse_static_args(const StaticParseTables& tables, const StaticDestination* dests, const char* const* tokens, size_t num_tokens) {
+            {
+                PhaseScope phase(Phase::DEFAULTS);
+
+                for (size_t iarg = 0; iarg < tables.num_arguments; ++iarg) {
+                    const StaticArgument& arg = tables.arguments[iarg];
+                    if (arg.default_set()) {
+                        dests[iarg].set_value(dests[iarg].value, arg.default_value(), Provenance::DEFAULT, arg, tables.names[iarg]);
+                    }
+                }
+            }
+
+            PhaseScope phase(Phase::PARSE);
+
+            std::vector<bool> specified_arguments(tables.num_arguments, false);
+
+            size_t next_positional = 0;
+
+            for (size_t i = 0; i < num_tokens; ++i) {
+                ARGPARSE_STATS(record_token());
+
+                const char* token = tokens[i];
+                bool no_space_short_arg = false;
+                size_t iarg = lookup_option(tables, token, &no_space_short_arg);
+
+                if (iarg == tables.num_arguments) {
+                    throw ArgParseHelp();
+                } else if (iarg != STATIC_NOT_FOUND) {
+                    //Start of an option
+                    const StaticArgument& arg = tables.arguments[iarg];
+                    const char* name = tables.names[iarg];
+                    const auto& dest = dests[iarg];
+                    specified_arguments[iarg] = true;
+
+                    if (arg.action() == Action::STORE_TRUE) {
+                        dest.set_flag(dest.value, true, arg, name);
+                    } else if (arg.action() == Action::STORE_FALSE) {
+                        dest.set_flag(dest.value, false, arg, name);
+                    } else {
+                        const char* value = nullptr;
+                        if (no_space_short_arg) {
+                            value = token + 2;
+                        } else if (i + 1 < num_tokens) {
+                            ARGPARSE_STATS(record_token());
+                            bool next_no_space_short_arg = false;
+                            if (lookup_option(tables, tokens[i + 1], &next_no_space_short_arg) == STATIC_NOT_FOUND) {
+                                value = tokens[i + 1];
+                                ++i; //Skip over the value
+                            }
+                        }
+
+                        if (!value) {
+                            std::stringstream msg;
+                            msg << "Missing expected argument for " << token << "";
+                            throw ArgParseError(msg.str());
+                        }
+
+                        check_choice(arg, value, name);
+
+                        try {
+                            dest.set_value(dest.value, value, Provenance::SPECIFIED, arg, name);
+                        } catch (const ArgParseConversionError& e) {
+                            std::stringstream msg;
+                            msg << e.what() << " for " << name;
+                            throw ArgParseConversionError(msg.str());
+                        }
+                    }
+                } else if (next_positional < tables.num_positionals) {
+                    //Positional argument
+                    size_t ipos = tables.positionals[next_positional];
+                    ++next_positional;
+                    specified_arguments[ipos] = true;
+
+                    const StaticArgument& arg = tables.arguments[ipos];
+                    check_choice(arg, token, tables.names[ipos]);
+
+                    try {
+                        dests[ipos].set_value(dests[ipos].value, token, Provenance::SPECIFIED, arg, tables.names[ipos]);
+                    } catch (const ArgParseConversionError& e) {
+                        std::stringstream msg;
+                        msg << e.what() << " for positional argument " << arg.long_option();
+                        throw ArgParseConversionError(msg.str());
+                    }
+                } else {
+                    std::stringstream ss;
+                    ss << "Unexpected command-line argument '" << token << "'";
+                    throw ArgParseError(ss.str());
+                }
+            }
+
+            //Missing positionals?
+            if (next_positional < tables.num_positionals) {
+                std::stringstream ss;
+                ss << "Missing required positional argument: " << tables.arguments[tables.positionals[next_positional]].long_option();
+                throw ArgParseError(ss.str());
+            }
+
+            //Missing required?
+            for (size_t iarg = 0; iarg < tables.num_arguments; ++iarg) {
+                if (tables.arguments[iarg].required() && !specified_arguments[iarg]) {
+                    std::stringstream msg;
+                    msg << "Missing required argument: " << tables.names[iarg];
+                    throw ArgParseError(msg.str());
+                }
+            }
+        }
+
+        void parse_static_args(const StaticParseTables& tables, const StaticDestination* dests, const std::vector<std::string>& args) {
+            std::vector<const char*> tokens;
+            tokens.reserve(args.size());
+            for (const auto& arg : args) {
+                tokens.push_back(arg.c_str());
+            }
+            parse_static_args(tables, dests, tokens.data(), tokens.size());
+        }
+
+        void parse_static_args_or_exit(const StaticParseTables& tables, const StaticDestination* dests,
+                                       int argc, const char* const* argv, int error_exit_code, int help_exit_code) {
+            try {
+                parse_static_args(tables, dests, argv + 1, argc > 0 ? argc - 1 : 0);
+            } catch (const argparse::ArgParseHelp&) {
+                //Help requested
+                stdout_sink().write(tables.help);
+                stdout_sink().flush();
+                std::exit(help_exit_code);
+            } catch (const argparse::ArgParseError& e) {
+                //Failed to parse
+                stdout_sink().write(e.what());
+                stdout_sink().write("\n\n", 2);
+                stdout_sink().write(tables.usage);
+                stdout_sink().flush();
+                std::exit(error_exit_code);
+            }
+        }
+
+        void reset_static_destinations(const StaticDestination* dests, size_t num_dests) {
+            for (size_t i = 0; i < num_dests; ++i) {
+                dests[i].reset(dests[i].value);
+            }
+        }
+    }
+} //namespace
@@ -0,0 +1,963 @@
+#ifndef ARGPARSE_STATIC_HPP
+#define ARGPARSE_STATIC_HPP
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "argparse.hpp"
+#include "argparse_constexpr.hpp"
+
+#ifndef ARGPARSE_NO_IOSTREAM
+#   include <ostream>
+#endif
+
+namespace argparse {
+
+    /*
+     * Compile-time argument parsers
+     *
+     * When the set of arguments is fixed at compile time, StaticArgumentParser avoids
+     * the run-time cost of registering arguments with an ArgumentParser. The arguments
+     * are declared as a constexpr table by a specification type:
+     *
+     *      struct MySpec {
+     *          static constexpr const char* prog() { return "my_prog"; }
+     *          static constexpr const char* description() { return "Does things"; } //Optional
+     *          static constexpr const char* epilog() { return "See also ..."; }      //Optional
+     *
+     *          static constexpr auto arguments() {
+     *              return argparse::static_arguments(
+     *                  argparse::StaticArgument("filename").help("Input file"),
+     *                  argparse::StaticArgument("--verbosity", "-v").default_value("1"),
+     *                  argparse::StaticArgument("--fast").action(argparse::Action::STORE_TRUE).default_value("false"));
+     *          }
+     *      };
+     *
+     *      argparse::StaticArgumentParser<MySpec> parser(args.filename, args.verbosity, args.fast);
+     *      parser.parse_args(argc, argv);
+     *
+     * The option look-up table (a perfect hash of the option strings), the metavars and
+     * the usage and help text are all computed at compile time, and invalid specifications
+     * (e.g. duplicate option strings) are compile errors. Parsing is driven from this
+     * read-only data, setting the ArgValue destinations (one per argument, in the order
+     * they are declared) just like ArgumentParser.
+     *
+     * A help option (-h/--help) is added automatically. Arguments take a single value
+     * (Action::STORE) or none (Action::STORE_TRUE/STORE_FALSE).
+     */
+
+    /*
+     * StaticString is a fixed-capacity null-terminated string which can be built in constant expressions
+     */
+    template<size_t Capacity>
+    class StaticString {
+        public:
+            constexpr StaticString() {}
+
+            constexpr void append(char c) {
+                if (size_ >= Capacity) throw ArgParseError("StaticString capacity exceeded");
+                chars_[size_++] = c;
+            }
+
+            constexpr void append(const char* str, size_t len) {
+                for (size_t i = 0; i < len; ++i) append(str[i]);
+            }
+
+            constexpr void append(const char* str) {
+                for (; *str != '\0'; ++str) append(*str);
+            }
+
+            constexpr const char* c_str() const { return chars_; }
+            constexpr size_t size() const { return size_; }
+            constexpr char operator[](size_t i) const { return chars_[i]; }
+
+            std::string str() const { return std::string(chars_, size_); }
+        private:
+            char chars_[Capacity + 1] = {}; //+1 for terminator
+            size_t size_ = 0;
+    };
+
+    //Describes an argument of a StaticArgumentParser (see above)
+    class StaticArgument {
+        public:
+            constexpr StaticArgument(const char* long_opt, const char* short_opt="")
+                : long_opt_(long_opt)
+                , short_opt_(short_opt)
+                {}
+
+        public: //Configuration (returns a modified copy, so calls can be chained in constant expressions)
+            //Sets the help text
+            constexpr StaticArgument help(const char* help_str) const {
+                auto arg = *this;
+                arg.help_ = help_str;
+                return arg;
+            }
+
+            //Sets the default value
+            constexpr StaticArgument default_value(const char* default_val) const {
+                auto arg = *this;
+                arg.default_value_ = default_val;
+                arg.default_set_ = true;
+                return arg;
+            }
+
+            //Sets the action (STORE, STORE_TRUE or STORE_FALSE)
+            constexpr StaticArgument action(Action action_type) const {
+                if (action_type != Action::STORE && action_type != Action::STORE_TRUE && action_type != Action::STORE_FALSE) {
+                    throw ArgParseError("Static arguments only support STORE, STORE_TRUE and STORE_FALSE actions");
+                }
+                auto arg = *this;
+                arg.action_ = action_type;
+                return arg;
+            }
+
+            //Sets whether this argument is required
+            constexpr StaticArgument required(bool is_required) const {
+                auto arg = *this;
+                arg.required_ = is_required;
+                return arg;
+            }
+
+            //Sets the associated metavar (if not specified, inferred from argument name, or choices)
+            constexpr StaticArgument metavar(const char* metavar_str) const {
+                auto arg = *this;
+                arg.metavar_ = metavar_str;
+                return arg;
+            }
+
+            //Sets the group this argument is associated with (shown in the help)
+            constexpr StaticArgument group_name(const char* grp) const {
+                auto arg = *this;
+                arg.group_name_ = grp;
+                return arg;
+            }
+
+            //Sets the valid choices for this option's value (choice_values must have static storage duration)
+            template<size_t NumChoices>
+            constexpr StaticArgument choices(const char* const (&choice_values)[NumChoices]) const {
+                auto arg = *this;
+                arg.choices_ = choice_values;
+                arg.num_choices_ = NumChoices;
+                return arg;
+            }
+
+        public: //Accessors
+            constexpr const char* long_option() const { return long_opt_; }
+            constexpr const char* short_option() const { return short_opt_; }
+            constexpr const char* help() const { return help_; }
+            constexpr const char* default_value() const { return default_value_; }
+            constexpr bool default_set() const { return default_set_; }
+            constexpr Action action() const { return action_; }
+            constexpr bool required() const { return positional() || required_; } //Positional arguments are always required
+            constexpr const char* metavar() const { return metavar_; }
+            constexpr size_t num_choices() const { return num_choices_; }
+            constexpr const char* choice(size_t i) const { return choices_[i]; }
+            constexpr const char* group_name() const { return group_name_; }
+            constexpr char nargs() const { return action_ == Action::STORE ? '1' : '0'; }
+            constexpr bool positional() const { return long_opt_[0] != '-'; }
+
+        private:
+            const char* long_opt_;
+            const char* short_opt_;
+            const char* help_ = "";
+            const char* default_value_ = "";
+            const char* metavar_ = nullptr;
+            const char* group_name_ = "arguments";
+            const char* const* choices_ = nullptr;
+            size_t num_choices_ = 0;
+            Action action_ = Action::STORE;
+            bool required_ = false;
+            bool default_set_ = false;
+    };
+
+    //The arguments of a StaticArgumentParser, see static_arguments()
+    template<size_t N>
+    class StaticArguments {
+        public:
+            static_assert(N > 0, "At least one argument must be specified");
+
+            template<typename... Args>
+            constexpr StaticArguments(Args... args)
+                : args_{args...}
+                {}
+
+            static constexpr size_t size() { return N; }
+            constexpr const StaticArgument& operator[](size_t i) const { return args_[i]; }
+        private:
+            StaticArgument args_[N];
+    };
+
+    //Collects the specified StaticArguments into a table
+    template<typename... Args>
+    constexpr StaticArguments<sizeof...(Args)> static_arguments(Args... args) {
+        return StaticArguments<sizeof...(Args)>(args...);
+    }
+
+    //Wraps an ArgValue destination of a StaticArgumentParser to use a non-default Converter, see with_converter()
+    template<typename T, typename Converter>
+    struct ConvertedDestination {
+        ArgValue<T>& value;
+    };
+
+    //Specifies a destination of a StaticArgumentParser which is converted by Converter
+    template<typename Converter, typename T>
+    ConvertedDestination<T,Converter> with_converter(ArgValue<T>& value) {
+        return ConvertedDestination<T,Converter>{value};
+    }
+
+    namespace detail {
+        //Index returned when an option is not found
+        constexpr size_t STATIC_NOT_FOUND = size_t(-1);
+
+        //Matches the DefaultFormatter's layout
+        constexpr size_t STATIC_OPTION_NAME_WIDTH = 20;
+        constexpr size_t STATIC_TOTAL_WIDTH = 80;
+        constexpr const char* STATIC_USAGE_PREFIX = "usage: ";
+        constexpr const char* STATIC_GROUP_NAME = "arguments";
+        constexpr const char* STATIC_HELP_LONG_OPT = "--help";
+        constexpr const char* STATIC_HELP_SHORT_OPT = "-h";
+        constexpr const char* STATIC_HELP_HELP = "Shows this help message";
+
+        constexpr char static_toupper(char c) {
+            return (c >= 'a' && c <= 'z') ? char(c - 'a' + 'A') : c;
+        }
+
+        //Sink which counts the characters appended to it (used to size StaticStrings)
+        class StaticLength {
+            public:
+                constexpr void append(char) { ++size_; }
+                constexpr void append(const char*, size_t len) { size_ += len; }
+                constexpr void append(const char* str) { size_ += static_strlen(str); }
+                constexpr size_t size() const { return size_; }
+            private:
+                size_t size_ = 0;
+        };
+
+        template<typename Sink>
+        constexpr void append_spaces(Sink& sink, size_t num_spaces) {
+            for (size_t i = 0; i < num_spaces; ++i) sink.append(' ');
+        }
+
+        /*
+         * Perfect hash table mapping option strings to argument indices
+         */
+        struct StaticOptionSlot {
+            const char* option = nullptr;
+            size_t size = 0;
+            size_t iarg = 0;
+        };
+
+        template<size_t TableSize>
+        struct StaticOptionTable {
+            static_assert((TableSize & (TableSize - 1)) == 0, "Option table size must be a power of two");
+
+            StaticOptionSlot slots[TableSize] = {};
+            uint32_t seed = 0;
+
+            //Returns the index of the argument with option string str (or STATIC_NOT_FOUND)
+            constexpr size_t find(const char* str, size_t size) const {
+                const StaticOptionSlot& slot = slots[static_hash(str, size, seed) & (TableSize - 1)];
+                if (slot.option && static_streq(slot.option, slot.size, str, size)) {
+                    return slot.iarg;
+                }
+                return STATIC_NOT_FOUND;
+            }
+
+            constexpr bool insert(const char* option, size_t iarg) {
+                size_t size = static_strlen(option);
+                StaticOptionSlot& slot = slots[static_hash(option, size, seed) & (TableSize - 1)];
+                if (slot.option) return false; //Collision
+                slot.option = option;
+                slot.size = size;
+                slot.iarg = iarg;
+                return true;
+            }
+        };
+
+        //Checks the specification is valid, throwing (i.e. failing to compile) if not
+        template<size_t N>
+        constexpr bool check_static_arguments(const StaticArguments<N>& args) {
+            for (size_t i = 0; i < N; ++i) {
+                const auto& arg = args[i];
+                size_t num_dashes = 0;
+                while (arg.long_option()[num_dashes] == '-') ++num_dashes;
+
+                if (static_strlen(arg.long_option()) < 1) {
+                    throw ArgParseError("Argument must be at least one character long");
+                } else if (num_dashes == 1 && arg.short_option()[0] != '\0') {
+                    throw ArgParseError("Long option must be specified before short option");
+                } else if (num_dashes > 2) {
+                    throw ArgParseError("More than two dashes in argument name");
+                } else if (arg.positional() && arg.nargs() == '0') {
+                    throw ArgParseError("Positional arguments must have the STORE action");
+                }
+            }
+
+            //Each option string must map to a single argument (including the help option)
+            for (size_t i = 0; i <= N; ++i) {
+                const char* i_opts[2] = {
+                    (i < N) ? args[i].long_option() : STATIC_HELP_LONG_OPT,
+                    (i < N) ? args[i].short_option() : STATIC_HELP_SHORT_OPT
+                };
+                for (size_t j = i + 1; j <= N; ++j) {
+                    const char* j_opts[2] = {
+                        (j < N) ? args[j].long_option() : STATIC_HELP_LONG_OPT,
+                        (j < N) ? args[j].short_option() : STATIC_HELP_SHORT_OPT
+                    };
+                    for (const char* i_opt : i_opts) {
+                        for (const char* j_opt : j_opts) {
+                            if (i_opt[0] != '\0' && static_streq(i_opt, j_opt)) {
+                                throw ArgParseError("Option string maps to multiple options");
+                            }
+                        }
+                    }
+                }
+            }
+            return true;
+        }
+
+        //Returns the size of the option table (a power of two at least twice the number of option strings)
+        template<size_t N>
+        constexpr size_t static_option_table_size(const StaticArguments<N>& args) {
+            size_t num_option_strs = 2; //Help
+            for (size_t i = 0; i < N; ++i) {
+                if (args[i].positional()) continue;
+                ++num_option_strs;
+                if (args[i].short_option()[0] != '\0') ++num_option_strs;
+            }
+
+            size_t table_size = 1;
+            while (table_size < 2 * num_option_strs) table_size *= 2;
+            return table_size;
+        }
+
+        //Builds the option table, searching for a hash seed which maps every option string to a unique slot
+        template<size_t TableSize, size_t N>
+        constexpr StaticOptionTable<TableSize> build_static_option_table(const StaticArguments<N>& args) {
+            constexpr uint32_t MAX_SEEDS = 4096;
+
+            for (uint32_t seed = 0; seed < MAX_SEEDS; ++seed) {
+                StaticOptionTable<TableSize> table;
+                table.seed = seed;
+
+                bool ok = table.insert(STATIC_HELP_LONG_OPT, N) && table.insert(STATIC_HELP_SHORT_OPT, N);
+                for (size_t i = 0; ok && i < N; ++i) {
+                    if (args[i].positional()) continue;
+                    ok = table.insert(args[i].long_option(), i);
+                    if (ok && args[i].short_option()[0] != '\0') {
+                        ok = table.insert(args[i].short_option(), i);
+                    }
+                }
+
+                if (ok) return table;
+            }
+            throw ArgParseError("Failed to find a perfect hash for the option strings");
+        }
+
+        /*
+         * The order arguments are shown and positionals are consumed in: grouped as an
+         * ArgumentParser would group them (default group first, ending with the help
+         * option, then the other groups in the order they first appear)
+         */
+        template<size_t N>
+        struct StaticOrder {
+            size_t indices[N + 1] = {}; //Index N is the help option
+        };
+
+        template<size_t N>
+        constexpr StaticOrder<N> build_static_order(const StaticArguments<N>& args) {
+            StaticOrder<N> order;
+            size_t size = 0;
+            for (size_t i = 0; i < N; ++i) {
+                if (static_streq(args[i].group_name(), STATIC_GROUP_NAME)) {
+                    order.indices[size++] = i;
+                }
+            }
+            order.indices[size++] = N;
+
+            for (size_t i = 0; i < N; ++i) {
+                const char* group = args[i].group_name();
+                bool first_in_group = !static_streq(group, STATIC_GROUP_NAME);
+                for (size_t j = 0; first_in_group && j < i; ++j) {
+                    first_in_group = !static_streq(args[j].group_name(), group);
+                }
+                if (!first_in_group) continue;
+
+                for (size_t j = i; j < N; ++j) {
+                    if (static_streq(args[j].group_name(), group)) {
+                        order.indices[size++] = j;
+                    }
+                }
+            }
+            return order;
+        }
+
+        //The positional arguments (in the order they are consumed)
+        template<size_t N>
+        struct StaticPositionals {
+            size_t indices[N] = {};
+            size_t size = 0;
+        };
+
+        template<size_t N>
+        constexpr StaticPositionals<N> build_static_positionals(const StaticArguments<N>& args, const StaticOrder<N>& order) {
+            StaticPositionals<N> positionals;
+            for (size_t i : order.indices) {
+                if (i < N && args[i].positional()) {
+                    positionals.indices[positionals.size++] = i;
+                }
+            }
+            return positionals;
+        }
+
+        /*
+         * A table of N null-terminated strings stored in a single buffer
+         */
+        template<size_t N, size_t Capacity>
+        struct StaticStringTable {
+            StaticString<Capacity> text;
+            size_t offsets[N] = {};
+
+            constexpr const char* operator[](size_t i) const { return text.c_str() + offsets[i]; }
+        };
+
+        //Pointers to the strings of a StaticStringTable
+        template<size_t N>
+        struct StaticStringPointers {
+            const char* strs[N] = {};
+        };
+
+        template<size_t N, size_t Capacity>
+        constexpr StaticStringPointers<N> build_static_string_pointers(const StaticStringTable<N,Capacity>& table) {
+            StaticStringPointers<N> pointers;
+            for (size_t i = 0; i < N; ++i) {
+                pointers.strs[i] = table[i];
+            }
+            return pointers;
+        }
+
+        //Writes the metavar of arg (excluding any nargs decoration)
+        template<typename Sink>
+        constexpr void format_static_metavar(Sink& sink, const StaticArgument& arg) {
+            if (arg.num_choices() > 0) {
+                //We allow choices to override the default metavar
+                sink.append('{');
+                for (size_t i = 0; i < arg.num_choices(); ++i) {
+                    if (i != 0) sink.append(", ");
+                    sink.append(arg.choice(i));
+                }
+                sink.append('}');
+            } else if (arg.metavar()) {
+                sink.append(arg.metavar());
+            } else {
+                const char* name = arg.long_option();
+                while (*name == '-') ++name;
+                for (; *name != '\0'; ++name) sink.append(static_toupper(*name));
+            }
+        }
+
+        //Writes the descriptive name of arg (e.g. '--verbosity/-v')
+        template<typename Sink>
+        constexpr void format_static_name(Sink& sink, const StaticArgument& arg) {
+            sink.append(arg.long_option());
+            if (arg.short_option()[0] != '\0') {
+                sink.append('/');
+                sink.append(arg.short_option());
+            }
+        }
+
+        //Formats a StaticStringTable with an entry (written by Format) for each argument
+        template<typename Format, size_t N>
+        constexpr size_t static_string_table_size(const StaticArguments<N>& args) {
+            StaticLength len;
+            for (size_t i = 0; i < N; ++i) {
+                Format::format(len, args[i]);
+                len.append('\0');
+            }
+            return len.size();
+        }
+
+        template<typename Format, size_t Capacity, size_t N>
+        constexpr StaticStringTable<N,Capacity> build_static_string_table(const StaticArguments<N>& args) {
+            StaticStringTable<N,Capacity> table;
+            for (size_t i = 0; i < N; ++i) {
+                table.offsets[i] = table.text.size();
+                Format::format(table.text, args[i]);
+                table.text.append('\0');
+            }
+            return table;
+        }
+
+        struct StaticMetavarFormat {
+            template<typename Sink>
+            static constexpr void format(Sink& sink, const StaticArgument& arg) { format_static_metavar(sink, arg); }
+        };
+
+        struct StaticNameFormat {
+            template<typename Sink>
+            static constexpr void format(Sink& sink, const StaticArgument& arg) { format_static_name(sink, arg); }
+        };
+
+        /*
+         * Wraps str to lines of (roughly) width characters, breaking after any of break_strs
+         * (as wrap_width() does), and passing each line to visitor.line()
+         */
+        template<typename Visitor>
+        constexpr void static_wrap_width(const char* str, size_t width, const char* const* break_strs, size_t num_break_strs, Visitor& visitor) {
+            size_t size = static_strlen(str);
+            size_t start = 0;
+            size_t end = 0;
+            size_t last_break = 0;
+            for (end = 0; end < size; ++end) {
+                size_t len = end - start;
+
+                if (len > width) {
+                    size_t line_len = last_break - start;
+                    if (line_len > size - start) line_len = size - start;
+                    visitor.line(str + start, line_len, true);
+                    start = last_break;
+                }
+
+                //Find the next break
+                for (size_t ibrk = 0; ibrk < num_break_strs; ++ibrk) {
+                    size_t brk_len = static_strlen(break_strs[ibrk]);
+                    if (end + brk_len <= size && static_streq(str + end, brk_len, break_strs[ibrk], brk_len)) {
+                        last_break = end + 1;
+                    }
+                }
+
+                //If there are embedded new-lines then take them as forced breaks
+                if (str[end] == '\n') {
+                    last_break = end + 1;
+                    visitor.line(str + start, last_break - start, false);
+                    start = last_break;
+                }
+            }
+
+            visitor.line(str + start, end - start, false);
+        }
+
+        //Writes each wrapped line, indenting all but the first
+        template<typename Sink>
+        struct StaticIndentedLines {
+            Sink& sink;
+            size_t indent;
+            bool first;
+
+            constexpr void line(const char* str, size_t len, bool newline) {
+                if (!first) append_spaces(sink, indent);
+                sink.append(str, len);
+                if (newline) sink.append('\n');
+                first = false;
+            }
+        };
+
+        //Writes each wrapped line, padding it to start at column pad_to
+        template<typename Sink>
+        struct StaticPaddedLines {
+            Sink& sink;
+            size_t pad_to;
+            size_t pos;
+
+            constexpr void line(const char* str, size_t len, bool newline) {
+                append_spaces(sink, pad_to - pos);
+                sink.append(str, len);
+                if (newline) sink.append('\n');
+                pos = 0;
+            }
+        };
+
+        //The compile-time inputs to the usage and help formatting
+        template<size_t N, size_t MetavarCapacity>
+        struct StaticFormatContext {
+            const char* prog;
+            const char* description;
+            const char* epilog;
+            const StaticArguments<N>* args;
+            const StaticOrder<N>* order;
+            const StaticStringTable<N,MetavarCapacity>* metavars;
+            const char* usage_line; //Unwrapped usage (see format_static_usage_line())
+        };
+
+        //Writes the option string of arg with its metavar (e.g. '--verbosity VERBOSITY')
+        template<typename Sink>
+        constexpr void format_static_option(Sink& sink, const char* opt, const StaticArgument& arg, const char* metavar) {
+            sink.append(opt);
+            if (arg.nargs() != '0' && !arg.positional()) {
+                sink.append(' ');
+                sink.append(metavar);
+            }
+        }
+
+        //Writes the usage as a single line
+        template<typename Sink, typename Context>
+        constexpr void format_static_usage_line(Sink& sink, const Context& ctx) {
+            sink.append(STATIC_USAGE_PREFIX);
+            sink.append(ctx.prog);
+            for (size_t i : ctx.order->indices) {
+                if (i == ctx.args->size()) {
+                    sink.append(" [");
+                    sink.append(STATIC_HELP_SHORT_OPT);
+                    sink.append(']');
+                    continue;
+                }
+                const auto& arg = (*ctx.args)[i];
+
+                sink.append(' ');
+                if (!arg.required()) sink.append('[');
+
+                if (arg.short_option()[0] != '\0') {
+                    format_static_option(sink, arg.short_option(), arg, (*ctx.metavars)[i]);
+                } else {
+                    format_static_option(sink, arg.long_option(), arg, (*ctx.metavars)[i]);
+                }
+
+                if (!arg.required()) sink.append(']');
+            }
+        }
+
+        //Writes the usage, wrapped as the DefaultFormatter does
+        template<typename Sink, typename Context>
+        constexpr void format_static_usage(Sink& sink, const Context& ctx) {
+            constexpr const char* break_strs[] = {" [", " -"};
+            size_t prefix_len = static_strlen(STATIC_USAGE_PREFIX);
+
+            StaticIndentedLines<Sink> lines{sink, prefix_len, true};
+            static_wrap_width(ctx.usage_line, STATIC_TOTAL_WIDTH - prefix_len, break_strs, 2, lines);
+            sink.append('\n');
+        }
+
+        //Writes a paragraph of text (e.g. the description or epilog)
+        template<typename Sink>
+        constexpr void format_static_paragraph(Sink& sink, const char* text) {
+            constexpr const char* break_strs[] = {" ", "/"};
+
+            sink.append('\n');
+            StaticIndentedLines<Sink> lines{sink, 0, true};
+            static_wrap_width(text, STATIC_TOTAL_WIDTH, break_strs, 2, lines);
+            sink.append('\n');
+        }
+
+        //Writes the help entry of an argument
+        template<typename Sink>
+        constexpr void format_static_argument_help(Sink& sink, const StaticArgument& arg, const char* metavar) {
+            constexpr const char* break_strs[] = {" ", "/"};
+            const char* indent = "  ";
+
+            //name/option
+            size_t pos = sink.size();
+            sink.append(indent);
+            if (arg.short_option()[0] != '\0') {
+                format_static_option(sink, arg.short_option(), arg, metavar);
+                sink.append(", ");
+            }
+            format_static_option(sink, arg.long_option(), arg, metavar);
+            pos = sink.size() - pos;
+
+            if (pos + 2 > STATIC_OPTION_NAME_WIDTH) {
+                //If the option name is too long, wrap the help
+                //around to a new line
+                sink.append('\n');
+                pos = 0;
+            }
+
+            //Argument help
+            StaticPaddedLines<Sink> lines{sink, STATIC_OPTION_NAME_WIDTH, pos};
+            static_wrap_width(arg.help(), STATIC_TOTAL_WIDTH - STATIC_OPTION_NAME_WIDTH, break_strs, 2, lines);
+
+            //Default
+            if (arg.default_value()[0] != '\0') {
+                if (arg.help()[0] != '\0') {
+                    sink.append(' ');
+                }
+                sink.append("(Default: ");
+                sink.append(arg.default_value());
+                sink.append(')');
+            }
+            sink.append('\n');
+        }
+
+        //Writes the full help (usage, description, arguments and epilog)
+        template<typename Sink, typename Context>
+        constexpr void format_static_help(Sink& sink, const Context& ctx) {
+            format_static_usage(sink, ctx);
+            format_static_paragraph(sink, ctx.description);
+
+            const char* group = nullptr;
+            for (size_t i : ctx.order->indices) {
+                bool help_option = (i == ctx.args->size());
+                const char* arg_group = help_option ? STATIC_GROUP_NAME : (*ctx.args)[i].group_name();
+                if (!group || !static_streq(group, arg_group)) {
+                    group = arg_group;
+                    sink.append('\n');
+                    sink.append(group);
+                    sink.append(":\n");
+                }
+
+                if (help_option) {
+                    format_static_argument_help(sink, StaticArgument(STATIC_HELP_LONG_OPT, STATIC_HELP_SHORT_OPT)
+                                                        .action(Action::STORE_TRUE)
+                                                        .help(STATIC_HELP_HELP),
+                                                "");
+                } else {
+                    format_static_argument_help(sink, (*ctx.args)[i], (*ctx.metavars)[i]);
+                }
+            }
+
+            format_static_paragraph(sink, ctx.epilog);
+        }
+
+        struct StaticUsageLineFormat {
+            template<typename Sink, typename Context>
+            static constexpr void format(Sink& sink, const Context& ctx) { format_static_usage_line(sink, ctx); }
+        };
+
+        struct StaticUsageFormat {
+            template<typename Sink, typename Context>
+            static constexpr void format(Sink& sink, const Context& ctx) { format_static_usage(sink, ctx); }
+        };
+
+        struct StaticHelpFormat {
+            template<typename Sink, typename Context>
+            static constexpr void format(Sink& sink, const Context& ctx) { format_static_help(sink, ctx); }
+        };
+
+        //Returns the size of the text written by Format
+        template<typename Format, typename Context>
+        constexpr size_t static_format_size(const Context& ctx) {
+            StaticLength len;
+            Format::format(len, ctx);
+            return len.size();
+        }
+
+        //Returns the text written by Format
+        template<typename Format, size_t Capacity, typename Context>
+        constexpr StaticString<Capacity> static_format(const Context& ctx) {
+            StaticString<Capacity> str;
+            Format::format(str, ctx);
+            return str;
+        }
+
+        //The optional parts of a specification
+        template<typename Spec>
+        constexpr auto static_spec_description(int) -> decltype(Spec::description()) { return Spec::description(); }
+        template<typename Spec>
+        constexpr const char* static_spec_description(long) { return ""; }
+
+        template<typename Spec>
+        constexpr auto static_spec_epilog(int) -> decltype(Spec::epilog()) { return Spec::epilog(); }
+        template<typename Spec>
+        constexpr const char* static_spec_epilog(long) { return ""; }
+
+        /*
+         * Type-erased destination of a StaticArgumentParser
+         */
+        struct StaticDestination {
+            void* value = nullptr;
+            void (*set_value)(void* value, const std::string& str, Provenance prov, const StaticArgument& arg, const char* name) = nullptr;
+            void (*set_flag)(void* value, bool flag, const StaticArgument& arg, const char* name) = nullptr; //Null for non-boolean destinations
+            void (*reset)(void* value) = nullptr;
+        };
+
+        template<typename T, typename Converter>
+        void set_static_value(void* value, const std::string& str, Provenance prov, const StaticArgument& arg, const char* name) {
+            auto& dest = *static_cast<ArgValue<T>*>(value);
+            if (prov == Provenance::SPECIFIED
+                && dest.provenance() == Provenance::SPECIFIED
+                && dest.argument_name() == name) {
+                throw ArgParseError("Argument " + std::string(name) + " specified multiple times");
+            }
+
+            ConverterInstance<T,Converter> converter;
+            T converted = T();
+            convert_or_throw<T,Converter>(&converter, str, converted);
+            dest.set(std::move(converted), prov);
+            dest.set_argument_name(name);
+            dest.set_argument_group(arg.group_name());
+        }
+
+        void set_static_flag(void* value, bool flag, const StaticArgument& arg, const char* name);
+
+        template<typename T>
+        void reset_static_value(void* value) {
+            *static_cast<ArgValue<T>*>(value) = ArgValue<T>();
+        }
+
+        template<typename T, typename Converter>
+        StaticDestination make_static_destination(ArgValue<T>& value) {
+            StaticDestination dest;
+            dest.value = &value;
+            dest.set_value = &set_static_value<T,Converter>;
+            dest.set_flag = std::is_same<T,bool>::value ? &set_static_flag : nullptr;
+            dest.reset = &reset_static_value<T>;
+            return dest;
+        }
+
+        template<typename T> struct is_vector : std::false_type {};
+        template<typename T> struct is_vector<std::vector<T>> : std::true_type {};
+
+        /*
+         * The read-only tables which drive parsing (shared by StaticArgumentParser and
+         * the parsers generated by argparse_gen)
+         */
+        struct StaticParseTables {
+            const StaticArgument* arguments;
+            const char* const* names; //Descriptive name of each argument (e.g. '--verbosity/-v')
+            size_t num_arguments;
+            const size_t* positionals; //Indices of the positional arguments (in the order they are consumed)
+            size_t num_positionals;
+
+            //Returns the index of the argument with option string str (num_arguments
+            //for the help option, or STATIC_NOT_FOUND)
+            size_t (*find_option)(const char* str, size_t size);
+
+            const char* usage;
+            const char* help;
+        };
+
+        //An option string and the index of its argument, see find_sorted_option()
+        struct StaticOptionEntry {
+            const char* option;
+            size_t iarg;
+        };
+
+        //Returns the index of the argument with option string str in options (sorted by
+        //std::strcmp() of the option strings), or STATIC_NOT_FOUND
+        size_t find_sorted_option(const StaticOptionEntry* options, size_t num_options, const char* str, size_t size);
+
+        //Parses tokens, setting dests (one per argument)
+        void parse_static_args(const StaticParseTables& tables, const StaticDestination* dests, const char* const* tokens, size_t num_tokens);
+        void parse_static_args(const StaticParseTables& tables, const StaticDestination* dests, const std::vector<std::string>& args);
+
+        //Like parse_static_args(), but on failure (or help) prints to stdout_sink() and exits the program
+        void parse_static_args_or_exit(const StaticParseTables& tables, const StaticDestination* dests,
+                                       int argc, const char* const* argv, int error_exit_code, int help_exit_code);
+
+        void reset_static_destinations(const StaticDestination* dests, size_t num_dests);
+    }
+
+    template<typename Spec>
+    class StaticArgumentParser {
+        public:
+            typedef decltype(Spec::arguments()) Arguments;
+
+            static constexpr size_t NUM_ARGUMENTS = Arguments::size();
+
+        public:
+            //Initializes the parser with the destination of each argument (in the order
+            //they are specified). A destination is either an ArgValue (converted with its
+            //DefaultConverter), or with_converter<Converter>(value)
+            template<typename... Dests>
+            explicit StaticArgumentParser(Dests&&... dests);
+
+            //Like parse_args_throw(), but catches exceptions and exits the program
+            void parse_args(int argc, const char* const* argv, int error_exit_code=1, int help_exit_code=0);
+
+            //Parses the specified command-line arguments and sets the appropriate argument values
+            //If an error occurs throws ArgParseError
+            //If an help is requested occurs throws ArgParseHelp
+            void parse_args_throw(int argc, const char* const* argv);
+            void parse_args_throw(const std::vector<std::string>& args);
+
+            //Reset the target values to their initial state
+            void reset_destinations();
+
+            //Prints the basic usage
+            void print_usage(OutputSink& sink=stdout_sink()) const;
+
+            //Prints the usage and full help description for each option
+            void print_help(OutputSink& sink=stdout_sink()) const;
+
+#ifndef ARGPARSE_NO_IOSTREAM
+            void print_usage(std::ostream& os) const;
+            void print_help(std::ostream& os) const;
+#endif
+
+        public: //Compile-time accessors
+            //Returns the program name
+            static constexpr const char* prog() { return Spec::prog(); }
+
+            //Returns the usage (as printed by print_usage())
+            static constexpr const char* usage() { return usage_.c_str(); }
+
+            //Returns the full help (as printed by print_help())
+            static constexpr const char* help() { return help_.c_str(); }
+
+            //Returns the metavar of the specified argument
+            static constexpr const char* metavar(size_t iarg) { return metavars_[iarg]; }
+
+            //Returns the index of the argument with the specified option string, or NUM_ARGUMENTS
+            //for the help option (-1 if there is none)
+            static constexpr size_t find_option(const char* option) { return option_table_.find(option, detail::static_strlen(option)); }
+
+        private:
+            template<size_t... Is, typename... Dests>
+            void bind(std::index_sequence<Is...>, Dests&&... dests);
+
+            template<size_t I, typename T>
+            detail::StaticDestination make_destination(ArgValue<T>& value);
+
+            template<size_t I, typename T, typename Converter>
+            detail::StaticDestination make_destination(ConvertedDestination<T,Converter> value);
+
+            static size_t lookup_option(const char* str, size_t size) { return option_table_.find(str, size); }
+
+            //Returns the tables which drive parsing
+            static const detail::StaticParseTables& tables();
+
+        private: //Compile-time data
+            static constexpr Arguments arguments_ = Spec::arguments();
+            static_assert(detail::check_static_arguments(arguments_), "Invalid static argument specification");
+
+            static constexpr size_t OPTION_TABLE_SIZE = detail::static_option_table_size(arguments_);
+            typedef detail::StaticOptionTable<OPTION_TABLE_SIZE> OptionTable;
+            static constexpr OptionTable option_table_ = detail::build_static_option_table<OPTION_TABLE_SIZE>(arguments_);
+
+            typedef detail::StaticOrder<NUM_ARGUMENTS> Order;
+            static constexpr Order order_ = detail::build_static_order(arguments_);
+
+            typedef detail::StaticPositionals<NUM_ARGUMENTS> Positionals;
+            static constexpr Positionals positionals_ = detail::build_static_positionals(arguments_, order_);
+
+            static constexpr size_t METAVARS_SIZE = detail::static_string_table_size<detail::StaticMetavarFormat>(arguments_);
+            typedef detail::StaticStringTable<NUM_ARGUMENTS,METAVARS_SIZE> Metavars;
+            static constexpr Metavars metavars_ = detail::build_static_string_table<detail::StaticMetavarFormat,METAVARS_SIZE>(arguments_);
+
+            static constexpr size_t NAMES_SIZE = detail::static_string_table_size<detail::StaticNameFormat>(arguments_);
+            typedef detail::StaticStringTable<NUM_ARGUMENTS,NAMES_SIZE> Names;
+            static constexpr Names names_ = detail::build_static_string_table<detail::StaticNameFormat,NAMES_SIZE>(arguments_);
+
+            typedef detail::StaticStringPointers<NUM_ARGUMENTS> NamePointers;
+            static constexpr NamePointers name_pointers_ = detail::build_static_string_pointers(names_);
+
+            typedef detail::StaticFormatContext<NUM_ARGUMENTS,METAVARS_SIZE> FormatContext;
+            static constexpr FormatContext line_context_ = {Spec::prog(), "", "", &arguments_, &order_, &metavars_, ""};
+
+            static constexpr size_t USAGE_LINE_SIZE = detail::static_format_size<detail::StaticUsageLineFormat>(line_context_);
+            typedef StaticString<USAGE_LINE_SIZE> UsageLine;
+            static constexpr UsageLine usage_line_ = detail::static_format<detail::StaticUsageLineFormat,USAGE_LINE_SIZE>(line_context_);
+
+            static constexpr FormatContext context_ = {Spec::prog(),
+                                                       detail::static_spec_description<Spec>(0),
+                                                       detail::static_spec_epilog<Spec>(0),
+                                                       &arguments_, &order_, &metavars_, usage_line_.c_str()};
+
+            static constexpr size_t USAGE_SIZE = detail::static_format_size<detail::StaticUsageFormat>(context_);
+            typedef StaticString<USAGE_SIZE> Usage;
+            static constexpr Usage usage_ = detail::static_format<detail::StaticUsageFormat,USAGE_SIZE>(context_);
+
+            static constexpr size_t HELP_SIZE = detail::static_format_size<detail::StaticHelpFormat>(context_);
+            typedef StaticString<HELP_SIZE> Help;
+            static constexpr Help help_ = detail::static_format<detail::StaticHelpFormat,HELP_SIZE>(context_);
+
+        private: //Data
+            detail::StaticDestination dests_[NUM_ARGUMENTS];
+    };
+
+} //namespace
+
+#include "argparse_static.tpp"
+
+#endif
@@ -0,0 +1,110 @@
+namespace argparse {
+
+    /*
+     * StaticArgumentParser
+     */
+
+    //Definitions of the compile-time data (required since they are odr-used)
+    template<typename Spec> constexpr size_t StaticArgumentParser<Spec>::NUM_ARGUMENTS;
+    template<typename Spec> constexpr typename StaticArgumentParser<Spec>::Arguments StaticArgumentParser<Spec>::arguments_;
+    template<typename Spec> constexpr typename StaticArgumentParser<Spec>::OptionTable StaticArgumentParser<Spec>::option_table_;
+    template<typename Spec> constexpr typename StaticArgumentParser<Spec>::Order StaticArgumentParser<Spec>::order_;
+    template<typename Spec> constexpr typename StaticArgumentParser<Spec>::Positionals StaticArgumentParser<Spec>::positionals_;
+    template<typename Spec> constexpr typename StaticArgumentParser<Spec>::Metavars StaticArgumentParser<Spec>::metavars_;
+    template<typename Spec> constexpr typename StaticArgumentParser<Spec>::Names StaticArgumentParser<Spec>::names_;
+    template<typename Spec> constexpr typename StaticArgumentParser<Spec>::NamePointers StaticArgumentParser<Spec>::name_pointers_;
+    template<typename Spec> constexpr typename StaticArgumentParser<Spec>::FormatContext StaticArgumentParser<Spec>::line_context_;
+    template<typename Spec> constexpr typename StaticArgumentParser<Spec>::UsageLine StaticArgumentParser<Spec>::usage_line_;
+    template<typename Spec> constexpr typename StaticArgumentParser<Spec>::FormatContext StaticArgumentParser<Spec>::context_;
+    template<typename Spec> constexpr typename StaticArgumentParser<Spec>::Usage StaticArgumentParser<Spec>::usage_;
+    template<typename Spec> constexpr typename StaticArgumentParser<Spec>::Help StaticArgumentParser<Spec>::help_;
+
+    template<typename Spec>
+    template<typename... Dests>
+    StaticArgumentParser<Spec>::StaticArgumentParser(Dests&&... dests) {
+        static_assert(sizeof...(Dests) == NUM_ARGUMENTS, "A destination must be specified for each argument");
+        bind(std::index_sequence_for<Dests...>(), std::forward<Dests>(dests)...);
+    }
+
+    template<typename Spec>
+    template<size_t... Is, typename... Dests>
+    void StaticArgumentParser<Spec>::bind(std::index_sequence<Is...>, Dests&&... dests) {
+        int expand[] = {0, (dests_[Is] = make_destination<Is>(std::forward<Dests>(dests)), 0)...};
+        (void) expand;
+    }
+
+    template<typename Spec>
+    template<size_t I, typename T>
+    detail::StaticDestination StaticArgumentParser<Spec>::make_destination(ArgValue<T>& value) {
+        return make_destination<I>(with_converter<DefaultConverter<T>>(value));
+    }
+
+    template<typename Spec>
+    template<size_t I, typename T, typename Converter>
+    detail::StaticDestination StaticArgumentParser<Spec>::make_destination(ConvertedDestination<T,Converter> value) {
+        static_assert(arguments_[I].nargs() == '1' || std::is_same<T,bool>::value,
+                      "STORE_TRUE/STORE_FALSE arguments require an ArgValue<bool> destination");
+        static_assert(!detail::is_vector<T>::value,
+                      "Static arguments take a single value (multi-value destinations are not supported)");
+
+        return detail::make_static_destination<T,Converter>(value.value);
+    }
+
+    template<typename Spec>
+    void StaticArgumentParser<Spec>::parse_args(int argc, const char* const* argv, int error_exit_code, int help_exit_code) {
+        detail::parse_static_args_or_exit(tables(), dests_, argc, argv, error_exit_code, help_exit_code);
+    }
+
+    template<typename Spec>
+    void StaticArgumentParser<Spec>::parse_args_throw(int argc, const char* const* argv) {
+        detail::parse_static_args(tables(), dests_, argv + 1, argc > 0 ? argc - 1 : 0);
+    }
+
+    template<typename Spec>
+    void StaticArgumentParser<Spec>::parse_args_throw(const std::vector<std::string>& args) {
+        detail::parse_static_args(tables(), dests_, args);
+    }
+
+    template<typename Spec>
+    void StaticArgumentParser<Spec>::reset_destinations() {
+        detail::reset_static_destinations(dests_, NUM_ARGUMENTS);
+    }
+
+    template<typename Spec>
+    void StaticArgumentParser<Spec>::print_usage(OutputSink& sink) const {
+        sink.write(usage_.c_str(), usage_.size());
+    }
+
+    template<typename Spec>
+    void StaticArgumentParser<Spec>::print_help(OutputSink& sink) const {
+        sink.write(help_.c_str(), help_.size());
+    }
+
+#ifndef ARGPARSE_NO_IOSTREAM
+    template<typename Spec>
+    void StaticArgumentParser<Spec>::print_usage(std::ostream& os) const {
+        os.write(usage_.c_str(), usage_.size());
+    }
+
+    template<typename Spec>
+    void StaticArgumentParser<Spec>::print_help(std::ostream& os) const {
+        os.write(help_.c_str(), help_.size());
+    }
+#endif
+
+    template<typename Spec>
+    const detail::StaticParseTables& StaticArgumentParser<Spec>::tables() {
+        static constexpr detail::StaticParseTables tables = {
+            &arguments_[0],
+            name_pointers_.strs,
+            NUM_ARGUMENTS,
+            positionals_.indices,
+            positionals_.size,
+            &lookup_option,
+            usage_.c_str(),
+            help_.c_str()
+        };
+        return tables;
+    }
+
+} //namespace
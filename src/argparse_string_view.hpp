@@ -0,0 +1,66 @@
+#ifndef ARGPARSE_STRING_VIEW_HPP
+#define ARGPARSE_STRING_VIEW_HPP
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+namespace argparse {
+
+    /*
+     * StringView refers to (but does not own) a sequence of characters, as std::string_view
+     * does in C++17. It is what converters are passed (see ConversionStatus), so they can
+     * read the argument strings without copying them.
+     *
+     * The characters need not be null-terminated.
+     */
+    class StringView {
+        public:
+            typedef const char* const_iterator;
+            static constexpr size_t npos = size_t(-1);
+        public: //Constructors
+            constexpr StringView() {}
+            constexpr StringView(const char* str, size_t len) : data_(str), size_(len) {}
+            StringView(const char* str) : data_(str), size_(std::strlen(str)) {}
+            StringView(const std::string& str) : data_(str.data()), size_(str.size()) {}
+
+        public: //Accessors
+            constexpr const char* data() const { return data_; }
+            constexpr size_t size() const { return size_; }
+            constexpr bool empty() const { return size_ == 0; }
+
+            constexpr const char& operator[](size_t i) const { return data_[i]; }
+
+            constexpr const_iterator begin() const { return data_; }
+            constexpr const_iterator end() const { return data_ + size_; }
+
+            //Returns the characters from pos (up to len of them)
+            StringView substr(size_t pos, size_t len=npos) const {
+                if (pos > size_) pos = size_;
+                if (len > size_ - pos) len = size_ - pos;
+                return StringView(data_ + pos, len);
+            }
+
+            //Returns the position of the first character not in chars (or npos if there is none)
+            size_t find_first_not_of(const char* chars) const {
+                for (size_t i = 0; i < size_; ++i) {
+                    if (data_[i] == '\0' || !std::strchr(chars, data_[i])) return i;
+                }
+                return npos;
+            }
+
+            //Returns a copy of the characters
+            std::string str() const { return std::string(data_, size_); }
+
+        private:
+            const char* data_ = "";
+            size_t size_ = 0;
+    };
+
+    inline bool operator==(StringView lhs, StringView rhs) {
+        return lhs.size() == rhs.size() && (lhs.size() == 0 || std::memcmp(lhs.data(), rhs.data(), lhs.size()) == 0);
+    }
+
+    inline bool operator!=(StringView lhs, StringView rhs) { return !(lhs == rhs); }
+
+} //namespace
+#endif
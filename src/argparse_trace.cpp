@@ -0,0 +1,262 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#ifndef ARGPARSE_NO_IOSTREAM
+#   include <ostream>
+#endif
+
+#ifdef __GNUG__
+#include <cxxabi.h>
+#endif
+
+#include "argparse_trace.hpp"
+#include "argparse.hpp"
+
+namespace argparse {
+
+    namespace {
+        thread_local ParseTrace* active_trace_ = nullptr;
+
+        int64_t steady_clock_ns() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        const char* event_category(ParseTrace::EventType type) {
+            switch (type) {
+                case ParseTrace::EventType::PHASE: return "phase";
+                case ParseTrace::EventType::TOKEN: return "token";
+                case ParseTrace::EventType::CONVERSION: return "conversion";
+                case ParseTrace::EventType::DEFAULT: return "default";
+                default: return "unknown";
+            }
+        }
+
+        const char* token_kind_name(TokenKind kind) {
+            switch (kind) {
+                case TokenKind::OPTION: return "option";
+                case TokenKind::OPTION_WITH_VALUE: return "option_with_value";
+                case TokenKind::VALUE: return "value";
+                case TokenKind::POSITIONAL: return "positional";
+                case TokenKind::SUBCOMMAND: return "subcommand";
+                case TokenKind::UNRECOGNIZED: return "unrecognized";
+                default: return "unknown";
+            }
+        }
+
+        std::string type_name(const std::type_info& type) {
+#ifdef __GNUG__
+            int status = 0;
+            char* demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+            if (status == 0 && demangled) {
+                std::string name = demangled;
+                std::free(demangled);
+                return name;
+            }
+#endif
+            return type.name();
+        }
+
+        //Appends str as a quoted JSON string
+        void append_json_string(std::string& out, const std::string& str) {
+            out += '"';
+            for (char c : str) {
+                if (c == '"' || c == '\\') {
+                    out += '\\';
+                    out += c;
+                } else if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                } else {
+                    out += c;
+                }
+            }
+            out += '"';
+        }
+
+        //Appends ns as microseconds (with nanosecond precision)
+        void append_microseconds(std::string& out, int64_t ns) {
+            char buf[32];
+            std::snprintf(buf, sizeof(buf), "%lld.%03lld", static_cast<long long>(ns / 1000), static_cast<long long>(ns % 1000));
+            out += buf;
+        }
+    }
+
+    /*
+     * ParseTrace
+     */
+    ParseTrace::ParseTrace()
+        : start_ns_(steady_clock_ns())
+        {}
+
+    void ParseTrace::clear() {
+        //Keep the capacity, so repeated traced parses don't re-allocate
+        events_.clear();
+        text_.clear();
+        start_ns_ = steady_clock_ns();
+    }
+
+    size_t ParseTrace::num_events() const {
+        return events_.size();
+    }
+
+    size_t ParseTrace::memory_usage() const {
+        return events_.capacity() * sizeof(Event) + text_.capacity();
+    }
+
+    size_t ParseTrace::begin(EventType type, size_t index) {
+        events_.emplace_back();
+        auto& event = events_.back();
+        event.type = type;
+        event.index = index;
+        event.start_ns = now_ns();
+        return events_.size() - 1;
+    }
+
+    void ParseTrace::end(size_t ievent) {
+        auto& event = events_[ievent];
+        event.duration_ns = now_ns() - event.start_ns;
+    }
+
+    void ParseTrace::set_text(size_t ievent, const std::string& text) {
+        auto& event = events_[ievent];
+        event.text_offset = text_.size();
+        event.text_size = text.size();
+        text_ += text;
+    }
+
+    void ParseTrace::set_argument(size_t ievent, const Argument* arg) {
+        events_[ievent].arg = arg;
+    }
+
+    void ParseTrace::set_token_kind(size_t ievent, TokenKind kind) {
+        events_[ievent].detail = static_cast<uint8_t>(kind);
+    }
+
+    void ParseTrace::set_phase(size_t ievent, Phase phase) {
+        events_[ievent].detail = static_cast<uint8_t>(phase);
+    }
+
+    void ParseTrace::set_converter(size_t ievent, const std::type_info& converter_type) {
+        events_[ievent].converter_type = &converter_type;
+    }
+
+    void ParseTrace::set_failed(size_t ievent) {
+        events_[ievent].failed = true;
+    }
+
+    std::string ParseTrace::json() const {
+        std::string out = "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+
+        bool first = true;
+        for (const auto& event : events_) {
+            if (!first) {
+                out += ",";
+            }
+            first = false;
+            out += "\n  {";
+
+            //Name
+            std::string name;
+            if (event.type == EventType::PHASE) {
+                name = phase_name(static_cast<Phase>(event.detail));
+            } else if (event.type == EventType::DEFAULT && event.arg) {
+                name = "default " + event.arg->name();
+            } else if (event.type == EventType::CONVERSION) {
+                name = "convert '" + text(event) + "'";
+            } else {
+                name = text(event);
+            }
+            out += "\"name\": ";
+            append_json_string(out, name);
+            out += ", \"cat\": \"" + std::string(event_category(event.type)) + "\"";
+
+            //Timing (in microseconds)
+            out += ", \"ph\": \"X\", \"pid\": 1, \"tid\": 1";
+            out += ", \"ts\": ";
+            append_microseconds(out, event.start_ns);
+            out += ", \"dur\": ";
+            append_microseconds(out, event.duration_ns);
+
+            //Details
+            out += ", \"args\": {";
+            if (event.type == EventType::TOKEN) {
+                out += "\"index\": " + std::to_string(event.index);
+                out += ", \"kind\": \"" + std::string(token_kind_name(static_cast<TokenKind>(event.detail))) + "\"";
+            } else if (event.type == EventType::PHASE) {
+                out += "\"phase\": \"" + std::string(phase_name(static_cast<Phase>(event.detail))) + "\"";
+            } else {
+                out += "\"value\": ";
+                append_json_string(out, text(event));
+            }
+            if (event.arg) {
+                out += ", \"argument\": ";
+                append_json_string(out, event.arg->name());
+            }
+            if (event.converter_type) {
+                out += ", \"converter\": ";
+                append_json_string(out, type_name(*event.converter_type));
+            }
+            if (event.type == EventType::CONVERSION) {
+                out += event.failed ? ", \"ok\": false" : ", \"ok\": true";
+            }
+            out += "}}";
+        }
+        out += "\n]}\n";
+        return out;
+    }
+
+    void ParseTrace::write_json(OutputSink& sink) const {
+        sink.write(json());
+    }
+
+#ifndef ARGPARSE_NO_IOSTREAM
+    void ParseTrace::write_json(std::ostream& os) const {
+        os << json();
+    }
+#endif
+
+    int64_t ParseTrace::now_ns() const {
+        return steady_clock_ns() - start_ns_;
+    }
+
+    std::string ParseTrace::text(const Event& event) const {
+        return std::string(text_, event.text_offset, event.text_size);
+    }
+
+    /*
+     * TraceScope
+     */
+    TraceScope::TraceScope(ParseTrace* trace)
+        : prev_trace_(active_trace_) {
+        active_trace_ = trace;
+    }
+
+    TraceScope::~TraceScope() {
+        active_trace_ = prev_trace_;
+    }
+
+    /*
+     * TraceSpan
+     */
+    TraceSpan::TraceSpan(ParseTrace::EventType type, size_t index)
+        : trace_(active_trace_) {
+        if (trace_) {
+            ievent_ = trace_->begin(type, index);
+        }
+    }
+
+    TraceSpan::~TraceSpan() {
+        if (trace_) {
+            trace_->end(ievent_);
+        }
+    }
+
+    namespace detail {
+        ParseTrace* active_trace() {
+            return active_trace_;
+        }
+    }
+
+} //namespace
@@ -0,0 +1,150 @@
+#ifndef ARGPARSE_TRACE_HPP
+#define ARGPARSE_TRACE_HPP
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#include "argparse_instrument.hpp"
+#include "argparse_output.hpp"
+
+namespace argparse {
+
+    class Argument;
+
+    //How a command-line token was interpreted by the parser
+    enum class TokenKind {
+        OPTION,            //An option (e.g. '--foo' or '-f')
+        OPTION_WITH_VALUE, //A short option with its value (e.g. '-j3')
+        VALUE,             //A value of the preceding option
+        POSITIONAL,        //A positional argument
+        SUBCOMMAND,        //The name of a subcommand (which parses the remaining tokens)
+        UNRECOGNIZED       //Not an option, and no positional arguments remain
+    };
+
+    /*
+     * ParseTrace records what the parser did: how each token was classified and
+     * the argument it resolved to, the conversions performed (and how long they
+     * took), the defaults applied and the time spent in each phase.
+     *
+     * Events are stored compactly (strings are appended to a shared buffer) and
+     * only formatted when the trace is written, so recording is cheap enough to
+     * leave enabled.
+     */
+    class ParseTrace {
+        public:
+            enum class EventType {
+                PHASE,
+                TOKEN,
+                CONVERSION,
+                DEFAULT
+            };
+
+        public:
+            ParseTrace();
+
+            //Removes all recorded events
+            void clear();
+
+            //Returns the number of recorded events
+            size_t num_events() const;
+
+            //Returns the memory used by the recorded events
+            size_t memory_usage() const;
+
+            //Returns the trace in the Chrome trace event (JSON) format, which can be
+            //loaded into chrome://tracing or Perfetto
+            std::string json() const;
+
+            //Writes json() to sink (or os)
+            void write_json(OutputSink& sink) const;
+#ifndef ARGPARSE_NO_IOSTREAM
+            void write_json(std::ostream& os) const;
+#endif
+
+        public: //Recording
+            //Starts a new event, returning its index
+            size_t begin(EventType type, size_t index=0);
+
+            //Ends the specified event
+            void end(size_t ievent);
+
+            void set_text(size_t ievent, const std::string& text);
+            void set_argument(size_t ievent, const Argument* arg);
+            void set_token_kind(size_t ievent, TokenKind kind);
+            void set_phase(size_t ievent, Phase phase);
+            void set_converter(size_t ievent, const std::type_info& converter_type);
+            void set_failed(size_t ievent);
+
+        private:
+            struct Event {
+                EventType type;
+                bool failed = false;
+                uint8_t detail = 0; //TokenKind or Phase
+                size_t index = 0; //Token index
+                int64_t start_ns = 0;
+                int64_t duration_ns = 0;
+                size_t text_offset = 0;
+                size_t text_size = 0;
+                const Argument* arg = nullptr;
+                const std::type_info* converter_type = nullptr;
+            };
+
+            int64_t now_ns() const;
+            std::string text(const Event& event) const;
+        private:
+            std::vector<Event> events_;
+            std::string text_; //Text of all events, concatenated
+            int64_t start_ns_; //Start time of the trace (steady clock)
+    };
+
+    /*
+     * TraceScope directs the trace events recorded on the calling thread to trace
+     * (which may be null to disable tracing) for its lifetime, restoring the previous
+     * trace when destroyed.
+     */
+    class TraceScope {
+        public:
+            TraceScope(ParseTrace* trace);
+            ~TraceScope();
+
+            TraceScope(const TraceScope&) = delete;
+            TraceScope& operator=(const TraceScope&) = delete;
+        private:
+            ParseTrace* prev_trace_;
+    };
+
+    /*
+     * TraceSpan records an event spanning its lifetime in the active trace.
+     * If there is no active trace it does nothing.
+     */
+    class TraceSpan {
+        public:
+            TraceSpan(ParseTrace::EventType type, size_t index=0);
+            ~TraceSpan();
+
+            TraceSpan(const TraceSpan&) = delete;
+            TraceSpan& operator=(const TraceSpan&) = delete;
+
+            //Returns true if the span is being recorded
+            explicit operator bool() const { return trace_ != nullptr; }
+
+            void set_text(const std::string& text) { if (trace_) trace_->set_text(ievent_, text); }
+            void set_argument(const Argument* arg) { if (trace_) trace_->set_argument(ievent_, arg); }
+            void set_token_kind(TokenKind kind) { if (trace_) trace_->set_token_kind(ievent_, kind); }
+            void set_phase(Phase phase) { if (trace_) trace_->set_phase(ievent_, phase); }
+            void set_converter(const std::type_info& converter_type) { if (trace_) trace_->set_converter(ievent_, converter_type); }
+            void set_failed() { if (trace_) trace_->set_failed(ievent_); }
+        private:
+            ParseTrace* trace_;
+            size_t ievent_ = 0;
+    };
+
+    namespace detail {
+        //Returns the trace active on the calling thread (or null if none)
+        ParseTrace* active_trace();
+    }
+
+} //namespace
+#endif
@@ -1,6 +1,8 @@
 #include "argparse_util.hpp"
+#include "argparse_instrument.hpp"
 #include <cstring>
 #include <algorithm>
+#include <cstdint>
 
 namespace argparse {
 
@@ -17,31 +19,11 @@ namespace argparse {
         return array;
     }
 
-    bool is_argument(std::string str, const std::map<std::string,std::shared_ptr<Argument>>& arg_map) {
-
-        for (const auto& kv : arg_map) {
-            auto iter = arg_map.find(str);
-
-            if (iter != arg_map.end()) {
-                //Exact match to short/long option
-                return true;
-            }
-
-            if (kv.first.size() == 2 && kv.first[0] == '-') {
-                //Check iff this is a short option with no spaces
-                if (str[0] == kv.first[0] && str[1] == kv.first[1]) {
-                    //Matches first two characters
-                    return true;
-                }
-            }
-
-        }
-        return false;
-    }
-
-    bool is_valid_choice(std::string str, const std::vector<std::string>& choices) {
+    bool is_valid_choice(const std::string& str, const std::vector<std::string>& choices) {
         if (choices.empty()) return true;
 
+        ARGPARSE_STATS(detail::record_choice_check());
+
         auto find_iter = std::find(choices.begin(), choices.end(), str);
         if (find_iter == choices.end()) {
             return false;
@@ -92,8 +74,7 @@ namespace argparse {
 
             //Find the next break
             for (const auto& brk_str : break_strs) {
-                auto pos = str.find(brk_str, end); //FIXME: this is inefficient
-                if (pos == end) {
+                if (str.compare(end, brk_str.size(), brk_str) == 0) {
                     last_break = end + 1;
                 }
             }
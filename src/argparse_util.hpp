@@ -2,8 +2,6 @@
 #define ARGPARSE_UTIL_HPP
 #include <array>
 #include <vector>
-#include <map>
-#include <memory>
 #include <string>
 
 namespace argparse {
@@ -19,12 +17,8 @@ namespace argparse {
     //Converts a string to lower case
     std::string tolower(std::string str);
 
-    //Returns true if str represents a named argument starting with
-    //'-' or '--' followed by one or more letters
-    bool is_argument(std::string str, const std::map<std::string,std::shared_ptr<Argument>>& arg_map);
-
     //Returns true if str is in choices, or choices is empty
-    bool is_valid_choice(std::string str, const std::vector<std::string>& choices);
+    bool is_valid_choice(const std::string& str, const std::vector<std::string>& choices);
 
     //Returns 'str' interpreted as type T
     // Throws an exception if conversion fails
@@ -1,6 +1,8 @@
 #ifndef ARGPARSE_VALUE_HPP
 #define ARGPARSE_VALUE_HPP
-#include <iostream>
+#include <iosfwd>
+#include <string>
+#include <utility>
 #include "argparse_error.hpp"
 
 namespace argparse {
@@ -10,13 +12,17 @@ namespace argparse {
         public:
             typedef T value_type;
         public:
-            void set_value(T val) { errored_ = false; value_ = val; }
-            void set_error(std::string msg) { errored_ = true; error_msg_ = msg; }
+            void set_value(const T& val) { errored_ = false; value_ = val; }
+            void set_value(T&& val) { errored_ = false; value_ = std::move(val); }
+            void set_error(std::string msg) { errored_ = true; error_msg_ = std::move(msg); }
 
-            T value() const { return value_; }
-            std::string error() const { return error_msg_; }
+            //Returns the converted value (moved out of an expiring ConvertedValue)
+            const T& value() const & { return value_; }
+            T value() && { return std::move(value_); }
 
-            operator bool() { return valid(); }
+            const std::string& error() const { return error_msg_; }
+
+            operator bool() const { return valid(); }
             bool valid() const { return !errored_; }
         private:
             T value_ = T();
@@ -32,26 +38,89 @@ namespace argparse {
         INFERRED,   //The value was inferred, or conditionally set based on other values
     };
 
+    class ArgValueBase;
+
+    namespace detail {
+        //Converts str and stores it in dest (throwing ArgParseConversionError if it does not convert).
+        //context is the pointer passed to ArgValueBase::set_pending()
+        typedef void (*PendingConversion)(ArgValueBase& dest, const std::string& str, void* context);
+
+        //The deferred update of an ArgValue (see ArgValueBase::set_pending())
+        struct PendingUpdate {
+            std::string str;
+            PendingConversion conversion = nullptr;
+            void* context = nullptr;
+        };
+
+        //Owns an ArgValue's PendingUpdate, which is only allocated once an update is first deferred,
+        //so values which never are (i.e. unless they are lazy or inferred) only pay for a pointer.
+        //Copies only carry over a pending update without a context (i.e. a lazy conversion)
+        class PendingUpdatePtr {
+            public:
+                PendingUpdatePtr() = default;
+                PendingUpdatePtr(const PendingUpdatePtr& other)
+                    : update_((other.update_ && other.update_->conversion && !other.update_->context)
+                              ? new PendingUpdate(*other.update_) : nullptr) {}
+                PendingUpdatePtr(PendingUpdatePtr&& other) noexcept : update_(other.update_) { other.update_ = nullptr; }
+                PendingUpdatePtr& operator=(PendingUpdatePtr other) noexcept { std::swap(update_, other.update_); return *this; }
+                ~PendingUpdatePtr() { delete update_; }
+
+                PendingUpdate* get() const { return update_; }
+
+                //Returns the update, allocating it if there is none yet
+                PendingUpdate& get_or_create() {
+                    if (!update_) update_ = new PendingUpdate();
+                    return *update_;
+                }
+            private:
+                PendingUpdate* update_ = nullptr;
+        };
+    }
+
     /*
-     * ArgValue represents the 'value' of a command-line option/argument
-     *
-     * It supports implicit conversion to the underlying value_type, which means it can
-     * be seamlessly used as the value_type in most situations.
+     * ArgValueBase holds the state of an ArgValue which does not depend on its value type:
+     * its provenance, the argument (and group) which set it, and any pending (lazy) update.
      *
-     * It additionally tracks the provenance off the option, along with it's associated argument group.
+     * This allows arguments to manage their destinations without knowing their type.
      */
-    template<typename T>
-    class ArgValue {
+    class ArgValueBase {
         public:
-            typedef T value_type;
+            typedef detail::PendingConversion PendingConversion;
 
-        public: //Accessors
-            //Automatic conversion to underlying value type
-            operator T() const { return value_; }
+        public: //Constructors
+            ArgValueBase() = default;
+
+            //Copies and moves first bring an inferred value which is pending on other up-to-date,
+            //as its update refers to other (see InferredValue). Pending lazy conversions are carried over
+            ArgValueBase(const ArgValueBase& other)
+                : provenance_(resolve_inferred(other).provenance_)
+                , argument_group_(other.argument_group_)
+                , argument_name_(other.argument_name_)
+                , pending_(other.pending_) {}
 
-            //Returns the value assoicated with this argument
-            const T& value() const { return value_; }
+            ArgValueBase(ArgValueBase&& other)
+                : provenance_(resolve_inferred(other).provenance_)
+                , argument_group_(std::move(other.argument_group_))
+                , argument_name_(std::move(other.argument_name_))
+                , pending_(std::move(other.pending_)) {}
 
+            ArgValueBase& operator=(const ArgValueBase& other) {
+                provenance_ = resolve_inferred(other).provenance_;
+                argument_group_ = other.argument_group_;
+                argument_name_ = other.argument_name_;
+                pending_ = other.pending_;
+                return *this;
+            }
+
+            ArgValueBase& operator=(ArgValueBase&& other) {
+                provenance_ = resolve_inferred(other).provenance_;
+                argument_group_ = std::move(other.argument_group_);
+                argument_name_ = std::move(other.argument_name_);
+                pending_ = std::move(other.pending_);
+                return *this;
+            }
+
+        public: //Accessors
             //Returns the provenance of this argument (i.e. how it was initialized)
             Provenance provenance() const { return provenance_; }
 
@@ -60,45 +129,171 @@ namespace argparse {
 
             const std::string& argument_name() const { return argument_name_; }
 
+            //Returns true if the value was set by a lazy argument (see Argument::lazy()) and has
+            //not yet been converted, or is an inferred value which may need re-computing
+            bool conversion_pending() const { return pending_.get() && pending_.get()->conversion; }
+
+            //Returns the unconverted string of a pending conversion
+            const std::string& pending_str() const {
+                static const std::string empty;
+                return pending_.get() ? pending_.get()->str : empty;
+            }
+
+            //Returns the context passed to set_pending() if a conversion is pending (or nullptr)
+            const void* pending_context() const {
+                return conversion_pending() ? pending_.get()->context : nullptr;
+            }
+
+            //Performs any pending conversion, caching the result.
+            //Throws ArgParseConversionError if it fails (the conversion then remains pending).
+            //This modifies the value despite being const, so it is not thread-safe while a
+            //conversion is pending (see ArgValue::value())
+            void resolve_pending() const {
+                PendingUpdate* update = pending_.get();
+                if (update && update->conversion) {
+                    //Only the (non-const) destinations of arguments have pending conversions
+                    auto& self = const_cast<ArgValueBase&>(*this);
+                    update->conversion(self, update->str, update->context);
+                    update->conversion = nullptr;
+                }
+            }
+
         public: //Mutators
-            void set(ConvertedValue<T> val, Provenance prov) {
-                if (!val.valid()) {
-                    //If the value didn't convert properly, it should
-                    //have an error message so raise it
-                    throw ArgParseConversionError(val.error());
+            //The argument group and name are copy-assigned, so re-setting them re-uses their capacity
+            void set_argument_group(const std::string& grp) {
+                argument_group_ = grp;
+            }
+
+            void set_argument_name(const std::string& name_str) {
+                argument_name_ = name_str;
+            }
+
+            //Defers setting the value to str until it is first read, when convert is called
+            void set_pending(const std::string& str, Provenance prov, PendingConversion convert, void* context=nullptr) {
+                PendingUpdate& update = pending_.get_or_create();
+                update.str = str;
+                update.conversion = convert;
+                update.context = context;
+                provenance_ = prov;
+            }
+
+            //Resets the provenance, argument group and name, and drops any pending
+            //conversion (keeping the strings' capacity)
+            void clear_metadata() {
+                provenance_ = Provenance::UNSPECIFIED;
+                argument_group_.clear();
+                argument_name_.clear();
+                if (PendingUpdate* update = pending_.get()) {
+                    update->str.clear();
+                }
+                drop_pending();
+            }
+
+            //Drops any pending conversion, leaving the value as is (e.g. as it has been set directly).
+            //The pending string is left as is, since it may be the string being stored
+            void drop_pending() {
+                if (PendingUpdate* update = pending_.get()) {
+                    update->conversion = nullptr;
+                }
+            }
+        private:
+            typedef detail::PendingUpdate PendingUpdate;
+
+            //Resolves an update of value which has a context (i.e. of an inferred value)
+            static const ArgValueBase& resolve_inferred(const ArgValueBase& value) {
+                if (value.pending_context()) {
+                    value.resolve_pending();
                 }
+                return value;
+            }
+        protected:
+            Provenance provenance_ = Provenance::UNSPECIFIED;
+        private:
+            std::string argument_group_ = "";
+            std::string argument_name_ = "";
+            detail::PendingUpdatePtr pending_;
+    };
+
+    /*
+     * ArgValue represents the 'value' of a command-line option/argument
+     *
+     * It supports implicit conversion to the underlying value_type, which means it can
+     * be seamlessly used as the value_type in most situations.
+     *
+     * It additionally tracks the provenance off the option, along with it's associated argument group.
+     */
+    template<typename T>
+    class ArgValue : public ArgValueBase {
+        public:
+            typedef T value_type;
+
+        public: //Accessors
+            //Automatic conversion to underlying value type (by reference, so reading
+            //a container or string destination does not copy it).
+            //Not thread-safe while a conversion is pending (see value())
+            operator const T&() const { return value(); }
+
+            //Returns the value assoicated with this argument.
+            //If its conversion was deferred it is converted (once) now, which
+            //may throw ArgParseConversionError.
+            //Reads are thread-safe only once no conversion is pending: that is always the
+            //case unless the value is set by a lazy argument (see Argument::lazy()) or is
+            //inferred (see ArgumentParser::add_inferred()). Call ArgumentParser::validate()
+            //after parsing to resolve those before sharing the value between threads
+            const T& value() const {
+                resolve_pending();
+                return value_;
+            }
+
+        public: //Mutators
+            void set(const ConvertedValue<T>& val, Provenance prov) {
+                check_converted(val);
+                drop_pending();
                 value_ = val.value();
                 provenance_ = prov;
             }
 
-            void set(T val, Provenance prov) {
-                value_ = val;
+            void set(ConvertedValue<T>&& val, Provenance prov) {
+                check_converted(val);
+                drop_pending();
+                value_ = std::move(val).value();
                 provenance_ = prov;
             }
 
-            T& mutable_value(Provenance prov) {
+            void set(const T& val, Provenance prov) {
+                drop_pending();
+                value_ = val;
                 provenance_ = prov;
-                return value_;
             }
 
-            void set_argument_group(std::string grp) {
-                argument_group_ = grp;
+            void set(T&& val, Provenance prov) {
+                drop_pending();
+                value_ = std::move(val);
+                provenance_ = prov;
             }
 
-            void set_argument_name(std::string name_str) {
-                argument_name_ = name_str;
+            T& mutable_value(Provenance prov) {
+                drop_pending();
+                provenance_ = prov;
+                return value_;
+            }
+        private:
+            static void check_converted(const ConvertedValue<T>& val) {
+                if (!val.valid()) {
+                    //If the value didn't convert properly, it should
+                    //have an error message so raise it
+                    throw ArgParseConversionError(val.error());
+                }
             }
         private:
             T value_ = T();
-            Provenance provenance_ = Provenance::UNSPECIFIED;
-            std::string argument_group_ = "";
-            std::string argument_name_ = "";
     };
 
     //Automatically convert to the underlying type for ostream output
+    //(the caller provides the complete std::ostream, e.g. by including <ostream>)
     template<typename T>
-    std::ostream& operator<<(std::ostream& os, const ArgValue<T> t) {
-        return os << T(t);
+    std::ostream& operator<<(std::ostream& os, const ArgValue<T>& t) {
+        return os << t.value();
     }
 
 }